@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Minimal benchmark registry, every BENCHMARK(name) in the linked files is run by
+// bench/main.cpp. The default sizes are the ones the numbers in the commit history were
+// measured at, --quick shrinks them for a fast smoke run.
+namespace Bench
+{
+  using Clock = std::chrono::steady_clock;
+
+  struct Benchmark
+  {
+    const char* name;
+    void (*function)();
+  };
+
+  inline std::vector<Benchmark>& GetBenchmarks()
+  {
+    static std::vector<Benchmark> benchmarks;
+    return benchmarks;
+  }
+
+  struct Register
+  {
+    Register(const char* name, void (*function)())
+    {
+      GetBenchmarks().push_back({name, function});
+    }
+  };
+
+  inline bool& IsQuick()
+  {
+    static bool quick = false;
+    return quick;
+  }
+
+  template <typename T>
+  T Size(T full, T quick)
+  {
+    return IsQuick() ? quick : full;
+  }
+
+  inline double Seconds(Clock::time_point start)
+  {
+    return std::chrono::duration<double>(Clock::now() - start).count();
+  }
+
+  // Average seconds per call over reps calls, with one untimed call first to warm up the caches
+  // when there is more than one
+  template <typename Function>
+  double Time(int reps, Function&& function)
+  {
+    if(reps > 1)
+      function();
+    Clock::time_point start = Clock::now();
+    for(int i = 0; i < reps; i++)
+      function();
+    return Seconds(start) / reps;
+  }
+
+  inline volatile double sink;
+
+  // Keeps the compiler from dropping work whose result is otherwise unused
+  inline void Consume(double value)
+  {
+    sink = value;
+  }
+
+  // Scratch files go to the system's temporary directory
+  inline std::string TempPath(const std::string& name)
+  {
+    return (std::filesystem::temp_directory_path() / ("greet-bench-" + name)).string();
+  }
+
+  inline void Report(const std::string& label, double value, const std::string& unit)
+  {
+    std::cout << "INFO:   " << std::left << std::setw(48) << label << std::right << std::setw(10) <<
+      std::fixed << std::setprecision(value < 10 ? 3 : 1) << value << (unit.empty() ? "" : " ") << unit << std::endl;
+  }
+}
+
+#define BENCHMARK(name) \
+  static void Benchmark##name(); \
+  static Bench::Register Benchmark##name##Register{#name, Benchmark##name}; \
+  static void Benchmark##name()
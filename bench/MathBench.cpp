@@ -0,0 +1,323 @@
+#include "Bench.h"
+#include "Reference.h"
+
+#include <ThreadPool.h>
+#include <math/BatchQuaternion.h>
+#include <math/BatchTransform.h>
+#include <math/FastMath.h>
+#include <math/Maths.h>
+#include <math/VecArray.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Greet;
+
+// Mat4 multiply, inverse and vector transform against the original scalar Mat4
+BENCHMARK(Mat4Operations)
+{
+  const int count = 1024;
+  const int reps = Bench::Size(20000, 500);
+  std::vector<Mat4> matrices(count);
+  std::vector<Vec4> vectors(count, Vec4(1, 2, 3, 1));
+  for(int i = 0; i < count; i++)
+  {
+    for(int k = 0; k < 16; k++)
+      matrices[i].elements[k] = (k % 5 == 0 ? 2.0f : 0.1f) + i * 0.001f;
+  }
+
+  float sum = 0;
+  auto perOp = [&](double seconds) { return seconds * 1e9 / count; };
+  Bench::Report("multiply, reference", perOp(Bench::Time(reps, [&]
+  {
+    for(int i = 0; i < count - 1; i++)
+      sum += Reference::Multiply(matrices[i], matrices[i + 1]).elements[i & 15];
+  })), "ns");
+  Bench::Report("multiply", perOp(Bench::Time(reps, [&]
+  {
+    for(int i = 0; i < count - 1; i++)
+      sum += (matrices[i] * matrices[i + 1]).elements[i & 15];
+  })), "ns");
+  Bench::Report("inverse, reference", perOp(Bench::Time(reps, [&]
+  {
+    for(int i = 0; i < count; i++)
+      sum += Reference::Inverse(matrices[i]).elements[i & 15];
+  })), "ns");
+  Bench::Report("inverse", perOp(Bench::Time(reps, [&]
+  {
+    for(int i = 0; i < count; i++)
+      sum += Mat4::Inverse(matrices[i]).elements[i & 15];
+  })), "ns");
+  Bench::Report("vector transform, reference", perOp(Bench::Time(reps, [&]
+  {
+    for(int i = 0; i < count; i++)
+      sum += Reference::Multiply(matrices[i], vectors[i]).vals[i & 3];
+  })), "ns");
+  Bench::Report("vector transform", perOp(Bench::Time(reps, [&]
+  {
+    for(int i = 0; i < count; i++)
+      sum += (matrices[i] * vectors[i]).vals[i & 3];
+  })), "ns");
+  Bench::Consume(sum);
+}
+
+// BatchTransform::TransformPoints against transforming one Vec3 at a time
+BENCHMARK(BatchTransform)
+{
+  Mat4 matrix = Mat4::TransformationMatrix(Vec3(1, 2, 3), Vec3(10, 20, 30), Vec3(1, 2, 0.5f));
+  ThreadPool pool;
+  for(size_t count : {(size_t)1000, (size_t)100000, Bench::Size<size_t>(10000000, 1000000)})
+  {
+    std::vector<Vec3> in(count, Vec3(1, 2, 3));
+    std::vector<Vec3> out(count);
+    int reps = std::max<size_t>(1, Bench::Size(100000000, 10000000) / count);
+    auto rate = [&](double seconds) { return count / seconds / 1e6; };
+    std::string size = std::to_string(count) + " points";
+
+    Bench::Report(size + ", per vector", rate(Bench::Time(reps, [&]
+    {
+      for(size_t i = 0; i < count; i++)
+      {
+        Vec4 v = matrix * in[i];
+        out[i] = Vec3(v.x, v.y, v.z);
+      }
+    })), "Mpts/s");
+    Bench::Report(size + ", batched", rate(Bench::Time(reps, [&]
+    {
+      BatchTransform::TransformPoints(matrix, in.data(), out.data(), count);
+    })), "Mpts/s");
+    Bench::Report(size + ", batched on " + std::to_string(pool.GetThreadCount()) + " threads", rate(Bench::Time(reps, [&]
+    {
+      BatchTransform::TransformPoints(matrix, in.data(), out.data(), count, &pool);
+    })), "Mpts/s");
+    Bench::Consume(out[count / 2].x);
+  }
+}
+
+// Cross product followed by normalize on packed Vec3 against Vec3Array
+BENCHMARK(VecArray)
+{
+  const size_t count = Bench::Size(1 << 20, 1 << 16);
+  const int reps = 50;
+  std::vector<Vec3> a(count, Vec3(1, 2, 3));
+  std::vector<Vec3> b(count, Vec3(3, 2, 1));
+  std::vector<Vec3> c(count);
+  Vec3Array sa(count), sb(count), sc(count);
+  for(size_t i = 0; i < count; i++)
+  {
+    sa.X()[i] = 1; sa.Y()[i] = 2; sa.Z()[i] = 3;
+    sb.X()[i] = 3; sb.Y()[i] = 2; sb.Z()[i] = 1;
+  }
+
+  auto perElement = [&](double seconds) { return seconds * 1e9 / count; };
+  Bench::Report("cross and normalize, AoS", perElement(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      c[i] = a[i].Cross(b[i]);
+      c[i].Normalize();
+    }
+  })), "ns");
+  Bench::Report("cross and normalize, SoA", perElement(Bench::Time(reps, [&]
+  {
+    Cross(sa, sb, sc);
+    sc.Normalize();
+  })), "ns");
+  Bench::Consume(c[7].x + sc.X()[7]);
+}
+
+// AffineTransform against the Mat4 paths it replaces
+BENCHMARK(AffineTransform)
+{
+  const int count = 1024;
+  const int iterations = Bench::Size(1 << 20, 1 << 16);
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> random(-1, 1);
+  std::vector<Vec3> positions(count), rotations(count), scales(count, Vec3(1, 1, 1));
+  for(int i = 0; i < count; i++)
+  {
+    positions[i] = Vec3(random(rng), random(rng), random(rng));
+    rotations[i] = Vec3(random(rng) * 90, random(rng) * 90, random(rng) * 90);
+  }
+  std::vector<Mat4> matrices(count);
+  std::vector<AffineTransform> transforms(count);
+  for(int i = 0; i < count; i++)
+  {
+    matrices[i] = Mat4::TransformationMatrix(positions[i], rotations[i], scales[i]);
+    transforms[i] = AffineTransform(matrices[i]);
+  }
+
+  float sum = 0;
+  auto perOp = [&](double seconds) { return seconds * 1e9 / iterations; };
+  Bench::Report("TRS as five Mat4 products", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+    {
+      int j = i & (count - 1);
+      Mat4 m = Mat4::Translate(positions[j]) * Mat4::RotateX(rotations[j].x) * Mat4::RotateY(rotations[j].y) *
+        Mat4::RotateZ(rotations[j].z) * Mat4::Scale(scales[j]);
+      sum += m.elements[i & 15];
+    }
+  })), "ns");
+  Bench::Report("TRS, Mat4::TransformationMatrix", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+    {
+      int j = i & (count - 1);
+      sum += Mat4::TransformationMatrix(positions[j], rotations[j], scales[j]).elements[i & 15];
+    }
+  })), "ns");
+  Bench::Report("TRS, AffineTransform", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+    {
+      int j = i & (count - 1);
+      sum += AffineTransform::TransformationMatrix(positions[j], rotations[j], scales[j]).elements[i % 12];
+    }
+  })), "ns");
+  Bench::Report("inverse, Mat4", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+      sum += Mat4::Inverse(matrices[i & (count - 1)]).elements[i & 15];
+  })), "ns");
+  Bench::Report("inverse, AffineTransform", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+      sum += AffineTransform::Inverse(transforms[i & (count - 1)]).elements[i % 12];
+  })), "ns");
+  Bench::Report("rigid inverse, AffineTransform", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+      sum += AffineTransform::RigidInverse(transforms[i & (count - 1)]).elements[i % 12];
+  })), "ns");
+  Bench::Report("multiply, Mat4", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+      sum += (matrices[i & (count - 1)] * matrices[(i + 1) & (count - 1)]).elements[i & 15];
+  })), "ns");
+  Bench::Report("multiply, AffineTransform", perOp(Bench::Time(1, [&]
+  {
+    for(int i = 0; i < iterations; i++)
+      sum += (transforms[i & (count - 1)] * transforms[(i + 1) & (count - 1)]).elements[i % 12];
+  })), "ns");
+  Bench::Consume(sum);
+}
+
+// Quaternion interpolation one at a time and batched
+BENCHMARK(Quaternion)
+{
+  const size_t count = 1 << 16;
+  const int reps = Bench::Size(200, 20);
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> random(-1, 1);
+  std::vector<Quaternion> from(count), to(count), out(count);
+  std::vector<float> t(count);
+  for(size_t i = 0; i < count; i++)
+  {
+    Vec3 a(random(rng), random(rng), random(rng));
+    Vec3 b(random(rng), random(rng), random(rng));
+    from[i] = Quaternion::RotationR(random(rng) * 6, a.Normalize());
+    to[i] = Quaternion::RotationR(random(rng) * 6, b.Normalize());
+    t[i] = (random(rng) + 1) / 2;
+  }
+
+  ThreadPool pool;
+  std::string threads = " on " + std::to_string(pool.GetThreadCount()) + " threads";
+  auto perElement = [&](double seconds) { return seconds * 1e9 / count; };
+  Bench::Report("nlerp, scalar", perElement(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+      out[i] = Quaternion::Nlerp(from[i], to[i], t[i]);
+  })), "ns");
+  Bench::Report("nlerp, batched", perElement(Bench::Time(reps, [&]
+  {
+    BatchQuaternion::Nlerp(from.data(), to.data(), t.data(), out.data(), count);
+  })), "ns");
+  Bench::Report("slerp, batched", perElement(Bench::Time(reps, [&]
+  {
+    BatchQuaternion::Slerp(from.data(), to.data(), t.data(), out.data(), count);
+  })), "ns");
+  Bench::Report("nlerp, batched" + threads, perElement(Bench::Time(reps, [&]
+  {
+    BatchQuaternion::Nlerp(from.data(), to.data(), t.data(), out.data(), count, &pool);
+  })), "ns");
+  Bench::Report("slerp, batched" + threads, perElement(Bench::Time(reps, [&]
+  {
+    BatchQuaternion::Slerp(from.data(), to.data(), t.data(), out.data(), count, &pool);
+  })), "ns");
+  Bench::Consume(out[5].x);
+}
+
+// Math::Fast kernels against libm
+BENCHMARK(FastMath)
+{
+  const size_t count = 1 << 16;
+  const int reps = Bench::Size(200, 20);
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> random(-1, 1);
+  std::vector<float> in(count), out1(count), out2(count);
+  for(size_t i = 0; i < count; i++)
+    in[i] = random(rng) * 100;
+
+  auto rate = [&](double seconds) { return count / seconds / 1e6; };
+  Bench::Report("sin, libm", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+      out1[i] = std::sin(in[i]);
+  })), "M/s");
+  Bench::Report("sin, float", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+      out1[i] = Math::Fast::Sin(in[i]);
+  })), "M/s");
+  Bench::Report("sin, Float4", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i += 4)
+      Simd::Store(&out1[i], Math::Fast::Sin(Simd::Load(&in[i])));
+  })), "M/s");
+  Bench::Report("sincos, libm", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      out1[i] = std::sin(in[i]);
+      out2[i] = std::cos(in[i]);
+    }
+  })), "M/s");
+  Bench::Report("sincos, Float4", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i += 4)
+    {
+      Simd::Float4 s, c;
+      Math::Fast::SinCos(Simd::Load(&in[i]), s, c);
+      Simd::Store(&out1[i], s);
+      Simd::Store(&out2[i], c);
+    }
+  })), "M/s");
+  Bench::Report("rsqrt, libm", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+      out1[i] = 1.0f / std::sqrt(std::fabs(in[i]) + 1);
+  })), "M/s");
+  Bench::Report("rsqrt, Float4", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i += 4)
+      Simd::Store(&out1[i], Math::Fast::Rsqrt(Simd::Add(Simd::Abs(Simd::Load(&in[i])), Simd::Splat(1))));
+  })), "M/s");
+  Bench::Report("atan2, libm", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+      out1[i] = std::atan2(in[i], in[count - 1 - i]);
+  })), "M/s");
+  Bench::Report("atan2, float", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i++)
+      out1[i] = Math::Fast::Atan2(in[i], in[count - 1 - i]);
+  })), "M/s");
+  Bench::Report("atan2, Float4", rate(Bench::Time(reps, [&]
+  {
+    for(size_t i = 0; i < count; i += 4)
+      Simd::Store(&out1[i], Math::Fast::Atan2(Simd::Load(&in[i]), Simd::Load(&in[count - 4 - i])));
+  })), "M/s");
+  Bench::Consume(out1[3] + out2[5]);
+}
@@ -0,0 +1,172 @@
+#include "Bench.h"
+#include "MeshGenerators.h"
+#include "Reference.h"
+
+#include <Mesh.h>
+#include <MeshCodec.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <vector>
+
+using namespace Greet;
+
+namespace
+{
+  // Version 1 file without attributes of about the given size, the data is a byte pattern
+  void WriteVersion1File(const std::string& filename, size_t bytes)
+  {
+    uint32_t vertexCount = bytes * 3 / 4 / sizeof(Vec3);
+    uint32_t indexCount = (bytes - vertexCount * sizeof(Vec3)) / sizeof(uint32_t);
+    size_t attributeCount = 0;
+    std::ofstream fout(filename, std::ios::binary);
+    fout.write("MESH", 4);
+    fout.write((char*)&vertexCount, sizeof(uint32_t));
+    fout.write((char*)&indexCount, sizeof(uint32_t));
+    fout.write((char*)&attributeCount, sizeof(size_t));
+
+    std::vector<char> buffer(1 << 20);
+    for(size_t i = 0; i < buffer.size(); i++)
+      buffer[i] = (char)i;
+    size_t left = vertexCount * sizeof(Vec3) + (size_t)indexCount * sizeof(uint32_t);
+    while(left > 0)
+    {
+      size_t size = std::min(left, buffer.size());
+      fout.write(buffer.data(), size);
+      left -= size;
+    }
+    if(!fout)
+      throw std::runtime_error("Could not write " + filename);
+  }
+
+  // The sections are copied into memory standing in for a staging buffer, as the application
+  // would upload them
+  size_t CopyToStaging(const Mesh::MeshView& view, std::vector<char>& staging)
+  {
+    size_t offset = 0;
+    for(const Mesh::Section& section : view.sections)
+    {
+      std::memcpy(staging.data() + offset, section.data, section.size);
+      offset += section.size;
+    }
+    return offset;
+  }
+}
+
+// Loading version 1 files with the original ifstream reader, ReadFromFile and MappedMesh. The
+// page cache is hot, every file is read once before it is timed.
+BENCHMARK(MeshLoad)
+{
+  std::string filename = Bench::TempPath("load.mesh");
+  for(size_t megabytes : Bench::IsQuick() ? std::vector<size_t>{10, 100} : std::vector<size_t>{10, 100, 1000, 2048})
+  {
+    size_t bytes = megabytes << 20;
+    WriteVersion1File(filename, bytes);
+    int reps = megabytes >= 1000 ? 2 : 5;
+    auto rate = [&](double seconds) { return bytes / seconds / 1e9; };
+    std::string size = std::to_string(megabytes) + " MB";
+
+    // The original reader can't read files of 2 GiB and above
+    if(megabytes < 2048)
+    {
+      Bench::Report(size + ", ifstream+new[]", rate(Bench::Time(reps, [&]
+      {
+        Reference::MeshData data = Reference::ReadMeshFile(filename);
+        Bench::Consume(data.indices[data.indexCount - 1]);
+      })), "GB/s");
+    }
+    Bench::Report(size + ", ReadFromFile", rate(Bench::Time(reps, [&]
+    {
+      Mesh::MeshData data = Mesh::ReadFromFile(filename);
+      Bench::Consume(data.indices[data.indexCount - 1]);
+    })), "GB/s");
+
+    // Allocated only now so that a 2 GiB file doesn't need memory for two copies at once
+    std::vector<char> staging(bytes);
+    std::memset(staging.data(), 0, staging.size());
+    Bench::Report(size + ", MappedMesh->staging", rate(Bench::Time(reps, [&]
+    {
+      Mesh::MappedMesh mesh{filename};
+      Bench::Consume(CopyToStaging(mesh.GetView(), staging));
+    })), "GB/s");
+  }
+  std::remove(filename.c_str());
+}
+
+// Loading a version 2 file into staging memory with and without checking the section checksums
+BENCHMARK(MeshChecksums)
+{
+  uint32_t vertexCount = Bench::Size(45u << 20, 5u << 20);
+  uint32_t indexCount = vertexCount;
+  Mesh::MeshData data{vertexCount, indexCount};
+  for(uint32_t i = 0; i < vertexCount; i++)
+    data.vertices[i] = Vec3(i, i * 0.5f, 1);
+  for(uint32_t i = 0; i < indexCount; i++)
+    data.indices[i] = (i * 7) % vertexCount;
+
+  std::string filename = Bench::TempPath("checksums.mesh");
+  Mesh::WriteToFile(filename, data);
+  size_t bytes = vertexCount * sizeof(Vec3) + (size_t)indexCount * sizeof(uint32_t);
+  std::vector<char> staging(bytes);
+  std::memset(staging.data(), 0, staging.size());
+  auto rate = [&](double seconds) { return bytes / seconds / 1e9; };
+  std::string size = std::to_string(bytes >> 20) + " MB";
+
+  Bench::Report(size + ", without checksums", rate(Bench::Time(5, [&]
+  {
+    Mesh::MappedMesh mesh{filename, false};
+    Bench::Consume(CopyToStaging(mesh.GetView(), staging));
+  })), "GB/s");
+  Bench::Report(size + ", with checksums", rate(Bench::Time(5, [&]
+  {
+    Mesh::MappedMesh mesh{filename, true};
+    Bench::Consume(CopyToStaging(mesh.GetView(), staging));
+  })), "GB/s");
+  Bench::Report("Crc32", rate(Bench::Time(5, [&]
+  {
+    Bench::Consume(Mesh::Crc32((const char*)data.vertices.get(), vertexCount * sizeof(Vec3)) +
+        Mesh::Crc32((const char*)data.indices.get(), indexCount * sizeof(uint32_t)));
+  })), "GB/s");
+  std::remove(filename.c_str());
+}
+
+// Quantizing a 600x600 grid with 32 byte vertices and decoding its varint encoded indices
+BENCHMARK(MeshCodec)
+{
+  const uint32_t width = 600;
+  uint32_t vertexCount = width * width;
+  std::vector<Vec3> positions(vertexCount);
+  std::vector<Vec3> normals(vertexCount, Vec3(0, 1, 0));
+  std::vector<Vec2> texCoords = MeshGenerators::GridTexCoords(width);
+  for(uint32_t y = 0; y < width; y++)
+  {
+    for(uint32_t x = 0; x < width; x++)
+      positions[y * width + x] = Vec3(x * 0.37f - 50, std::sin(x * 0.1f) * 3, y * 0.21f + 7);
+  }
+  std::vector<uint32_t> indices = MeshGenerators::GridIndices(width);
+
+  Mesh::QuantizedMesh quantized;
+  Bench::Report("quantize", Bench::Time(5, [&]
+  {
+    quantized = Mesh::Quantize(positions.data(), normals.data(), texCoords.data(), vertexCount, indices.data(), indices.size(), true);
+  }) * 1e3, "ms");
+  size_t vertexBytes = (quantized.positions.size() + quantized.normals.size() + quantized.texCoords.size()) * sizeof(uint16_t);
+  Bench::Report("vertex bytes, float", vertexCount * 32 / 1e6, "MB");
+  Bench::Report("vertex bytes, quantized", vertexBytes / 1e6, "MB");
+  Bench::Report("index bytes, 32-bit", indices.size() * sizeof(uint32_t) / 1e6, "MB");
+  Bench::Report("index bytes, encoded", quantized.indices.size() / 1e6, "MB");
+  Bench::Report("encoded bytes per index", quantized.indices.size() / (double)indices.size(), "B");
+
+  Mesh::MeshView view = quantized.GetView();
+  const Mesh::Section* section = view.FindSection(Mesh::Semantic::Index);
+  std::vector<uint32_t> decoded(indices.size());
+  Bench::Report("decode indices", indices.size() / Bench::Time(10, [&]
+  {
+    Mesh::DecodeIndices(*section, indices.size(), decoded.data());
+  }) / 1e6, "M/s");
+  if(decoded != indices)
+    throw std::runtime_error("Decoded indices don't match");
+}
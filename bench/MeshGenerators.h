@@ -0,0 +1,68 @@
+#pragma once
+
+#include <math/Maths.h>
+
+#include <cmath>
+#include <cstdint>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Test meshes for the mesh benchmarks, all of them a width x width vertex grid
+namespace MeshGenerators
+{
+  // Two triangles per grid cell in row order
+  inline std::vector<uint32_t> GridIndices(uint32_t width)
+  {
+    std::vector<uint32_t> indices;
+    indices.reserve((size_t)(width - 1) * (width - 1) * 6);
+    for(uint32_t y = 0; y + 1 < width; y++)
+    {
+      for(uint32_t x = 0; x + 1 < width; x++)
+      {
+        uint32_t a = y * width + x;
+        indices.insert(indices.end(), {a, a + width, a + 1, a + 1, a + width, a + width + 1});
+      }
+    }
+    return indices;
+  }
+
+  // The grid wrapped onto a unit sphere, with bumps of the given relative height
+  inline std::vector<Greet::Vec3> SpherePositions(uint32_t width, float bumpHeight = 0.0f)
+  {
+    std::vector<Greet::Vec3> positions(width * width);
+    for(uint32_t y = 0; y < width; y++)
+    {
+      for(uint32_t x = 0; x < width; x++)
+      {
+        float theta = x * 6.2831853f / (width - 1);
+        float phi = y * 3.14159265f / (width - 1);
+        float r = 1 + bumpHeight * std::sin(theta * 12) * std::sin(phi * 9);
+        positions[y * width + x] = Greet::Vec3(r * std::sin(phi) * std::cos(theta), r * std::cos(phi), r * std::sin(phi) * std::sin(theta));
+      }
+    }
+    return positions;
+  }
+
+  inline std::vector<Greet::Vec2> GridTexCoords(uint32_t width)
+  {
+    std::vector<Greet::Vec2> texCoords(width * width);
+    for(uint32_t i = 0; i < width * width; i++)
+      texCoords[i] = Greet::Vec2(i % width / (float)width, i / width / (float)width);
+    return texCoords;
+  }
+
+  // Triangles in random order, the worst case for the vertex cache
+  inline std::vector<uint32_t> ShuffleTriangles(std::vector<uint32_t> indices)
+  {
+    std::mt19937 rng(5);
+    size_t triangleCount = indices.size() / 3;
+    for(size_t i = triangleCount - 1; i > 0; i--)
+    {
+      size_t j = rng() % (i + 1);
+      for(int k = 0; k < 3; k++)
+        std::swap(indices[i * 3 + k], indices[j * 3 + k]);
+    }
+    return indices;
+  }
+}
@@ -0,0 +1,176 @@
+#include "Bench.h"
+#include "MeshGenerators.h"
+
+#include <Mesh.h>
+#include <MeshCodec.h>
+#include <MeshOptimizer.h>
+#include <MeshSimplifier.h>
+#include <ThreadPool.h>
+
+#include <cstdio>
+#include <vector>
+
+using namespace Greet;
+
+namespace
+{
+  const std::vector<float> LOD_ERRORS = {0.0005f, 0.002f, 0.008f, 0.032f};
+
+  // Writes the sphere grid quantized, with varint encoded indices in shuffled order
+  void WriteShuffledSphere(const std::string& filename, uint32_t width, float bumpHeight)
+  {
+    std::vector<Vec3> positions = MeshGenerators::SpherePositions(width, bumpHeight);
+    std::vector<Vec2> texCoords = MeshGenerators::GridTexCoords(width);
+    std::vector<uint32_t> indices = MeshGenerators::ShuffleTriangles(MeshGenerators::GridIndices(width));
+    Mesh::QuantizedMesh quantized = Mesh::Quantize(positions.data(), positions.data(), texCoords.data(), positions.size(),
+        indices.data(), indices.size(), true);
+    Mesh::WriteToFile(filename, quantized.GetView());
+  }
+
+  std::vector<uint32_t> ReadIndices(const Mesh::MeshView& view)
+  {
+    std::vector<uint32_t> indices(view.indexCount);
+    Mesh::DecodeIndices(*view.FindSection(Mesh::Semantic::Index), view.indexCount, indices.data());
+    return indices;
+  }
+}
+
+// The vertex cache, overdraw and vertex fetch passes on sphere grids in row and shuffled
+// triangle order, ACMR and ATVR for a 16 entry FIFO cache
+BENCHMARK(MeshOptimizer)
+{
+  ThreadPool pool;
+  for(uint32_t width : Bench::IsQuick() ? std::vector<uint32_t>{300} : std::vector<uint32_t>{300, 1000})
+  {
+    uint32_t vertexCount = width * width;
+    std::vector<Vec3> positions = MeshGenerators::SpherePositions(width);
+    std::vector<uint32_t> rows = MeshGenerators::GridIndices(width);
+    std::vector<uint32_t> shuffled = MeshGenerators::ShuffleTriangles(rows);
+    for(const std::vector<uint32_t>* source : {&rows, &shuffled})
+    {
+      std::string name = std::to_string(rows.size() / 3000) + "K tris, " + (source == &rows ? "row order" : "shuffled");
+      Mesh::VertexCacheStatistics before = Mesh::AnalyzeVertexCache(source->data(), source->size(), vertexCount);
+
+      std::vector<uint32_t> indices = *source;
+      double seconds = Bench::Time(1, [&] { Mesh::OptimizeVertexCache(indices.data(), indices.size(), vertexCount); });
+      Mesh::VertexCacheStatistics after = Mesh::AnalyzeVertexCache(indices.data(), indices.size(), vertexCount);
+      Bench::Report(name + ", ACMR before", before.acmr, "");
+      Bench::Report(name + ", ACMR after", after.acmr, "");
+      Bench::Report(name + ", ATVR after", after.atvr, "");
+      Bench::Report(name + ", vertex cache pass", seconds * 1e3, "ms");
+
+      std::vector<uint32_t> chunked = *source;
+      seconds = Bench::Time(1, [&] { Mesh::OptimizeVertexCache(chunked.data(), chunked.size(), vertexCount, &pool); });
+      Bench::Report(name + ", ACMR after, chunked", Mesh::AnalyzeVertexCache(chunked.data(), chunked.size(), vertexCount).acmr, "");
+      Bench::Report(name + ", vertex cache pass, chunked", seconds * 1e3, "ms");
+
+      seconds = Bench::Time(1, [&] { Mesh::OptimizeOverdraw(indices.data(), indices.size(), positions.data(), vertexCount); });
+      Bench::Report(name + ", overdraw pass", seconds * 1e3, "ms");
+      seconds = Bench::Time(1, [&] { Bench::Consume(Mesh::OptimizeVertexFetch(indices.data(), indices.size(), vertexCount).size()); });
+      Bench::Report(name + ", vertex fetch pass", seconds * 1e3, "ms");
+    }
+  }
+
+  // The offline tool on a quantized mesh with varint encoded indices
+  uint32_t width = Bench::Size(1000u, 300u);
+  std::string input = Bench::TempPath("optimizer-in.mesh");
+  std::string output = Bench::TempPath("optimizer-out.mesh");
+  WriteShuffledSphere(input, width, 0.0f);
+  double seconds = Bench::Time(1, [&] { Mesh::OptimizeFile(input, output, true, {}, &pool); });
+  {
+    Mesh::MappedMesh before{input};
+    Mesh::MappedMesh after{output};
+    std::vector<uint32_t> beforeIndices = ReadIndices(before.GetView());
+    std::vector<uint32_t> afterIndices = ReadIndices(after.GetView());
+    Mesh::VertexCacheStatistics beforeStats = Mesh::AnalyzeVertexCache(beforeIndices.data(), beforeIndices.size(), width * width);
+    Mesh::VertexCacheStatistics afterStats = Mesh::AnalyzeVertexCache(afterIndices.data(), afterIndices.size(), width * width);
+    std::string name = "OptimizeFile, " + std::to_string(beforeIndices.size() / 3000) + "K tris";
+    Bench::Report(name, seconds * 1e3, "ms");
+    Bench::Report(name + ", ACMR before", beforeStats.acmr, "");
+    Bench::Report(name + ", ACMR after", afterStats.acmr, "");
+    Bench::Report(name + ", ATVR before", beforeStats.atvr, "");
+    Bench::Report(name + ", ATVR after", afterStats.atvr, "");
+    Bench::Report(name + ", encoded indices before", before.GetView().FindSection(Mesh::Semantic::Index)->size / 1e6, "MB");
+    Bench::Report(name + ", encoded indices after", after.GetView().FindSection(Mesh::Semantic::Index)->size / 1e6, "MB");
+  }
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+// Simplification and LOD chains of a bumpy sphere grid
+BENCHMARK(MeshSimplifier)
+{
+  ThreadPool pool;
+  uint32_t width = Bench::Size(1000u, 300u);
+  uint32_t vertexCount = width * width;
+  std::vector<Vec3> positions = MeshGenerators::SpherePositions(width, 0.02f);
+  std::vector<uint32_t> grid = MeshGenerators::GridIndices(width);
+  std::string name = std::to_string(grid.size() / 3000) + "K tris";
+
+  std::vector<uint32_t> indices = grid;
+  std::vector<Mesh::Lod> lods;
+  double seconds = Bench::Time(1, [&] { lods = Mesh::GenerateLods(indices, positions.data(), vertexCount, LOD_ERRORS); });
+  Bench::Report("GenerateLods, " + name, seconds, "s");
+  Bench::Report("GenerateLods, " + name + ", input rate", grid.size() / 3 / seconds / 1e6, "M tris/s");
+  for(size_t i = 1; i < lods.size(); i++)
+    Bench::Report("level " + std::to_string(i) + " triangles", lods[i].indexCount / 3, "");
+
+  seconds = Bench::Time(1, [&]
+  {
+    Bench::Consume(Mesh::Simplify(grid.data(), grid.size(), positions.data(), vertexCount, grid.size() / 4, 1e9f).size());
+  });
+  Bench::Report("Simplify to 25%, " + name, seconds, "s");
+
+  std::string input = Bench::TempPath("simplifier-in.mesh");
+  std::string output = Bench::TempPath("simplifier-out.mesh");
+  WriteShuffledSphere(input, width, 0.02f);
+  seconds = Bench::Time(1, [&] { Mesh::OptimizeFile(input, output, true, LOD_ERRORS, &pool); });
+  Bench::Report("OptimizeFile with LODs, " + name, seconds, "s");
+  std::remove(input.c_str());
+  std::remove(output.c_str());
+}
+
+// A field of 64x64 copies of a sphere seen from a camera flying over it at 1080p, culled and
+// with a level selected for every visible copy
+BENCHMARK(LodSelection)
+{
+  const int count = 64;
+  const float spacing = 4;
+  const int frames = 120;
+  Mat4 projection = Mat4::ProjectionMatrix(1920 / 1080.0f, 90, 0.1f, 500.0f);
+  for(uint32_t width : Bench::IsQuick() ? std::vector<uint32_t>{300} : std::vector<uint32_t>{300, 1000})
+  {
+    std::vector<Vec3> positions = MeshGenerators::SpherePositions(width, 0.02f);
+    std::vector<uint32_t> indices = MeshGenerators::GridIndices(width);
+    std::vector<Mesh::Lod> lods = Mesh::GenerateLods(indices, positions.data(), positions.size(), LOD_ERRORS);
+    AABB bounds = AABB::FromPoints(positions.data(), positions.size());
+
+    double fullTriangles = 0;
+    double lodTriangles = 0;
+    double selectSeconds = 0;
+    for(int frame = 0; frame < frames; frame++)
+    {
+      Vec3 eye(count * spacing * frame / frames, 6, count * spacing * 0.5f);
+      Mat4 view = Mat4::LookAt(eye, eye + Vec3(1, -0.3f, 0.2f), Vec3(0, 1, 0));
+      Frustum frustum(projection * view);
+      Bench::Clock::time_point start = Bench::Clock::now();
+      for(int z = 0; z < count; z++)
+      {
+        for(int x = 0; x < count; x++)
+        {
+          Mat4 model = Mat4::Translate(Vec3(x * spacing, 0, z * spacing));
+          if(!frustum.Intersects(bounds.Transform(model)))
+            continue;
+          size_t lod = Mesh::SelectLod(lods, bounds, view * model, projection, 1080.0f);
+          fullTriangles += lods[0].indexCount / 3;
+          lodTriangles += lods[lod].indexCount / 3;
+        }
+      }
+      selectSeconds += Bench::Seconds(start);
+    }
+    std::string name = std::to_string(lods[0].indexCount / 3000) + "K tris";
+    Bench::Report(name + ", triangles per frame, full", fullTriangles / frames / 1e6, "M");
+    Bench::Report(name + ", triangles per frame, with LOD", lodTriangles / frames / 1e6, "M");
+    Bench::Report(name + ", cull and select per object", selectSeconds / (count * count * frames) * 1e9, "ns");
+  }
+}
@@ -0,0 +1,194 @@
+#include "Reference.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+using namespace Greet;
+
+namespace Reference
+{
+  Mat4 Multiply(const Mat4& first, const Mat4& second)
+  {
+    Mat4 result;
+    for(int row = 0; row < 4; row++)
+    {
+      for(int col = 0; col < 4; col++)
+      {
+        float sum = 0.0f;
+        for(int e = 0; e < 4; e++)
+          sum += first.elements[col + e * 4] * second.elements[e + row * 4];
+        result.elements[col + row * 4] = sum;
+      }
+    }
+    return result;
+  }
+
+  Vec4 Multiply(const Mat4& matrix, const Vec4& vector)
+  {
+    const float* e = matrix.elements;
+    return Vec4(
+        e[0] * vector.x + e[4] * vector.y + e[8] * vector.z + e[12] * vector.w,
+        e[1] * vector.x + e[5] * vector.y + e[9] * vector.z + e[13] * vector.w,
+        e[2] * vector.x + e[6] * vector.y + e[10] * vector.z + e[14] * vector.w,
+        e[3] * vector.x + e[7] * vector.y + e[11] * vector.z + e[15] * vector.w);
+  }
+
+  Mat4 Inverse(const Mat4& inv)
+  {
+    float temp[16], det;
+    int i;
+
+    temp[0] = inv.elements[5] * inv.elements[10] * inv.elements[15] -
+      inv.elements[5] * inv.elements[11] * inv.elements[14] -
+      inv.elements[9] * inv.elements[6] * inv.elements[15] +
+      inv.elements[9] * inv.elements[7] * inv.elements[14] +
+      inv.elements[13] * inv.elements[6] * inv.elements[11] -
+      inv.elements[13] * inv.elements[7] * inv.elements[10];
+
+    temp[4] = -inv.elements[4] * inv.elements[10] * inv.elements[15] +
+      inv.elements[4] * inv.elements[11] * inv.elements[14] +
+      inv.elements[8] * inv.elements[6] * inv.elements[15] -
+      inv.elements[8] * inv.elements[7] * inv.elements[14] -
+      inv.elements[12] * inv.elements[6] * inv.elements[11] +
+      inv.elements[12] * inv.elements[7] * inv.elements[10];
+
+    temp[8] = inv.elements[4] * inv.elements[9] * inv.elements[15] -
+      inv.elements[4] * inv.elements[11] * inv.elements[13] -
+      inv.elements[8] * inv.elements[5] * inv.elements[15] +
+      inv.elements[8] * inv.elements[7] * inv.elements[13] +
+      inv.elements[12] * inv.elements[5] * inv.elements[11] -
+      inv.elements[12] * inv.elements[7] * inv.elements[9];
+
+    temp[12] = -inv.elements[4] * inv.elements[9] * inv.elements[14] +
+      inv.elements[4] * inv.elements[10] * inv.elements[13] +
+      inv.elements[8] * inv.elements[5] * inv.elements[14] -
+      inv.elements[8] * inv.elements[6] * inv.elements[13] -
+      inv.elements[12] * inv.elements[5] * inv.elements[10] +
+      inv.elements[12] * inv.elements[6] * inv.elements[9];
+
+    temp[1] = -inv.elements[1] * inv.elements[10] * inv.elements[15] +
+      inv.elements[1] * inv.elements[11] * inv.elements[14] +
+      inv.elements[9] * inv.elements[2] * inv.elements[15] -
+      inv.elements[9] * inv.elements[3] * inv.elements[14] -
+      inv.elements[13] * inv.elements[2] * inv.elements[11] +
+      inv.elements[13] * inv.elements[3] * inv.elements[10];
+
+    temp[5] = inv.elements[0] * inv.elements[10] * inv.elements[15] -
+      inv.elements[0] * inv.elements[11] * inv.elements[14] -
+      inv.elements[8] * inv.elements[2] * inv.elements[15] +
+      inv.elements[8] * inv.elements[3] * inv.elements[14] +
+      inv.elements[12] * inv.elements[2] * inv.elements[11] -
+      inv.elements[12] * inv.elements[3] * inv.elements[10];
+
+    temp[9] = -inv.elements[0] * inv.elements[9] * inv.elements[15] +
+      inv.elements[0] * inv.elements[11] * inv.elements[13] +
+      inv.elements[8] * inv.elements[1] * inv.elements[15] -
+      inv.elements[8] * inv.elements[3] * inv.elements[13] -
+      inv.elements[12] * inv.elements[1] * inv.elements[11] +
+      inv.elements[12] * inv.elements[3] * inv.elements[9];
+
+    temp[13] = inv.elements[0] * inv.elements[9] * inv.elements[14] -
+      inv.elements[0] * inv.elements[10] * inv.elements[13] -
+      inv.elements[8] * inv.elements[1] * inv.elements[14] +
+      inv.elements[8] * inv.elements[2] * inv.elements[13] +
+      inv.elements[12] * inv.elements[1] * inv.elements[10] -
+      inv.elements[12] * inv.elements[2] * inv.elements[9];
+
+    temp[2] = inv.elements[1] * inv.elements[6] * inv.elements[15] -
+      inv.elements[1] * inv.elements[7] * inv.elements[14] -
+      inv.elements[5] * inv.elements[2] * inv.elements[15] +
+      inv.elements[5] * inv.elements[3] * inv.elements[14] +
+      inv.elements[13] * inv.elements[2] * inv.elements[7] -
+      inv.elements[13] * inv.elements[3] * inv.elements[6];
+
+    temp[6] = -inv.elements[0] * inv.elements[6] * inv.elements[15] +
+      inv.elements[0] * inv.elements[7] * inv.elements[14] +
+      inv.elements[4] * inv.elements[2] * inv.elements[15] -
+      inv.elements[4] * inv.elements[3] * inv.elements[14] -
+      inv.elements[12] * inv.elements[2] * inv.elements[7] +
+      inv.elements[12] * inv.elements[3] * inv.elements[6];
+
+    temp[10] = inv.elements[0] * inv.elements[5] * inv.elements[15] -
+      inv.elements[0] * inv.elements[7] * inv.elements[13] -
+      inv.elements[4] * inv.elements[1] * inv.elements[15] +
+      inv.elements[4] * inv.elements[3] * inv.elements[13] +
+      inv.elements[12] * inv.elements[1] * inv.elements[7] -
+      inv.elements[12] * inv.elements[3] * inv.elements[5];
+
+    temp[14] = -inv.elements[0] * inv.elements[5] * inv.elements[14] +
+      inv.elements[0] * inv.elements[6] * inv.elements[13] +
+      inv.elements[4] * inv.elements[1] * inv.elements[14] -
+      inv.elements[4] * inv.elements[2] * inv.elements[13] -
+      inv.elements[12] * inv.elements[1] * inv.elements[6] +
+      inv.elements[12] * inv.elements[2] * inv.elements[5];
+
+    temp[3] = -inv.elements[1] * inv.elements[6] * inv.elements[11] +
+      inv.elements[1] * inv.elements[7] * inv.elements[10] +
+      inv.elements[5] * inv.elements[2] * inv.elements[11] -
+      inv.elements[5] * inv.elements[3] * inv.elements[10] -
+      inv.elements[9] * inv.elements[2] * inv.elements[7] +
+      inv.elements[9] * inv.elements[3] * inv.elements[6];
+
+    temp[7] = inv.elements[0] * inv.elements[6] * inv.elements[11] -
+      inv.elements[0] * inv.elements[7] * inv.elements[10] -
+      inv.elements[4] * inv.elements[2] * inv.elements[11] +
+      inv.elements[4] * inv.elements[3] * inv.elements[10] +
+      inv.elements[8] * inv.elements[2] * inv.elements[7] -
+      inv.elements[8] * inv.elements[3] * inv.elements[6];
+
+    temp[11] = -inv.elements[0] * inv.elements[5] * inv.elements[11] +
+      inv.elements[0] * inv.elements[7] * inv.elements[9] +
+      inv.elements[4] * inv.elements[1] * inv.elements[11] -
+      inv.elements[4] * inv.elements[3] * inv.elements[9] -
+      inv.elements[8] * inv.elements[1] * inv.elements[7] +
+      inv.elements[8] * inv.elements[3] * inv.elements[5];
+
+    temp[15] = inv.elements[0] * inv.elements[5] * inv.elements[10] -
+      inv.elements[0] * inv.elements[6] * inv.elements[9] -
+      inv.elements[4] * inv.elements[1] * inv.elements[10] +
+      inv.elements[4] * inv.elements[2] * inv.elements[9] +
+      inv.elements[8] * inv.elements[1] * inv.elements[6] -
+      inv.elements[8] * inv.elements[2] * inv.elements[5];
+
+    det = inv.elements[0] * temp[0] + inv.elements[1] * temp[4] + inv.elements[2] * temp[8] + inv.elements[3] * temp[12];
+
+    if (det == 0)
+      return inv;
+
+    det = 1.0f / det;
+
+    Mat4 result = inv;
+
+    for (i = 0; i < 16; i++)
+      result.elements[i] = temp[i] * det;
+
+    return result;
+  }
+
+  MeshData ReadMeshFile(const std::string& filename)
+  {
+    std::ifstream fin(filename, std::ios::binary);
+    fin.seekg(0, std::ios::end);
+    // The original kept the size in an int, which fails from 2 GiB on
+    int fileSize = (int)fin.tellg();
+    fin.seekg(0, std::ios::beg);
+
+    char signature[4];
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    size_t attributeCount;
+    fin.read(signature, 4);
+    fin.read((char*)&vertexCount, sizeof(uint32_t));
+    fin.read((char*)&indexCount, sizeof(uint32_t));
+    fin.read((char*)&attributeCount, sizeof(size_t));
+    if(std::memcmp(signature, "MESH", 4) != 0 || attributeCount != 0 ||
+        fileSize < (int)(20 + vertexCount * sizeof(Vec3) + indexCount * sizeof(uint32_t)))
+      throw std::runtime_error("Could not read MESH file");
+
+    MeshData data{std::unique_ptr<Vec3[]>{new Vec3[vertexCount]}, std::unique_ptr<uint32_t[]>{new uint32_t[indexCount]}, vertexCount, indexCount};
+    fin.read((char*)data.vertices.get(), vertexCount * sizeof(Vec3));
+    fin.read((char*)data.indices.get(), indexCount * sizeof(uint32_t));
+    return data;
+  }
+}
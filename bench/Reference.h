@@ -0,0 +1,29 @@
+#pragma once
+
+#include <math/Maths.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+// The implementations that the optimized code replaced, kept out of line in Reference.cpp like
+// the originals were so that the comparisons measure the same calls
+namespace Reference
+{
+  // The triple loop, cofactor inverse and per-component vector transform of the original Mat4
+  Greet::Mat4 Multiply(const Greet::Mat4& first, const Greet::Mat4& second);
+  Greet::Vec4 Multiply(const Greet::Mat4& matrix, const Greet::Vec4& vector);
+  Greet::Mat4 Inverse(const Greet::Mat4& matrix);
+
+  struct MeshData
+  {
+    std::unique_ptr<Greet::Vec3[]> vertices;
+    std::unique_ptr<uint32_t[]> indices;
+    uint32_t vertexCount;
+    uint32_t indexCount;
+  };
+
+  // The original version 1 MESH reader, std::ifstream into new[] arrays, for files without
+  // attributes
+  MeshData ReadMeshFile(const std::string& filename);
+}
@@ -0,0 +1,144 @@
+#include "Bench.h"
+
+#include <ThreadPool.h>
+#include <TransformHierarchy.h>
+#include <math/Culling.h>
+#include <math/Maths.h>
+
+#include <random>
+#include <vector>
+
+using namespace Greet;
+
+// Culling::CullSpheres and CullAABBs against testing one bound at a time
+BENCHMARK(Culling)
+{
+  Mat4 projection = Mat4::ProjectionMatrix(16 / 9.0f, 70, 0.1f, 500);
+  Mat4 view = Mat4::LookAt(Vec3(0, 0, 0), Vec3(1, 0.2f, 0.5f), Vec3(0, 1, 0));
+  Frustum frustum(projection * view);
+  std::mt19937 rng(5);
+  std::uniform_real_distribution<float> random(-1, 1);
+  ThreadPool pool;
+
+  for(size_t count : Bench::IsQuick() ? std::vector<size_t>{10000, 100000} : std::vector<size_t>{10000, 100000, 1000000})
+  {
+    std::vector<Sphere> spheres(count);
+    std::vector<AABB> boxes(count);
+    std::vector<uint32_t> visible(count);
+    for(size_t i = 0; i < count; i++)
+    {
+      Vec3 center(random(rng) * 500, random(rng) * 500, random(rng) * 500);
+      float radius = (random(rng) + 1) * 5;
+      spheres[i] = Sphere(center, radius);
+      boxes[i] = AABB(center - radius, center + Vec3(radius * 0.5f, radius, radius * 2));
+    }
+
+    int reps = Bench::Size(20000000, 2000000) / count + 3;
+    auto perObject = [&](double seconds) { return seconds * 1e9 / count; };
+    std::string size = std::to_string(count) + " ";
+    Bench::Report(size + "spheres, one at a time", perObject(Bench::Time(reps, [&]
+    {
+      size_t visibleCount = 0;
+      for(size_t i = 0; i < count; i++)
+      {
+        if(frustum.Intersects(spheres[i]))
+          visible[visibleCount++] = i;
+      }
+    })), "ns");
+    Bench::Report(size + "spheres, batched", perObject(Bench::Time(reps, [&]
+    {
+      Culling::CullSpheres(frustum, spheres.data(), count, visible.data());
+    })), "ns");
+    Bench::Report(size + "spheres, batched on " + std::to_string(pool.GetThreadCount()) + " threads", perObject(Bench::Time(reps, [&]
+    {
+      Culling::CullSpheres(frustum, spheres.data(), count, visible.data(), &pool);
+    })), "ns");
+    Bench::Report(size + "AABBs, one at a time", perObject(Bench::Time(reps, [&]
+    {
+      size_t visibleCount = 0;
+      for(size_t i = 0; i < count; i++)
+      {
+        if(frustum.Intersects(boxes[i]))
+          visible[visibleCount++] = i;
+      }
+    })), "ns");
+    Bench::Report(size + "AABBs, batched", perObject(Bench::Time(reps, [&]
+    {
+      Culling::CullAABBs(frustum, boxes.data(), count, visible.data());
+    })), "ns");
+    Bench::Consume(visible[0]);
+  }
+}
+
+// TransformHierarchy::Update with a few or all nodes dirty, against recomputing every world
+// matrix from the local transforms
+BENCHMARK(TransformHierarchy)
+{
+  const uint32_t count = Bench::Size(100000, 10000);
+  const int reps = Bench::Size(50, 10);
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<float> random(-1, 1);
+  ThreadPool pool;
+
+  const char* shapes[] = {"characters", "random parents"};
+  for(int shape = 0; shape < 2; shape++)
+  {
+    // Characters of 100 bones each below one scene root, where every bone has about three
+    // children, or every node parented to a random earlier one
+    TransformHierarchy hierarchy;
+    for(uint32_t i = 0; i < count; i++)
+    {
+      uint32_t parent;
+      if(i == 0)
+        parent = TransformHierarchy::NO_PARENT;
+      else if(shape == 0)
+      {
+        uint32_t bone = (i - 1) % 100;
+        parent = bone == 0 ? 0 : i - bone + (bone - 1) / 3;
+      }
+      else
+        parent = rng() % i;
+
+      uint32_t node = hierarchy.AddNode(parent);
+      Vec3 axis(random(rng), random(rng), random(rng));
+      hierarchy.SetPosition(node, Vec3(random(rng), random(rng), random(rng)));
+      hierarchy.SetRotation(node, Quaternion::RotationR(random(rng) * 3, axis.Normalize()));
+      hierarchy.SetScale(node, Vec3(1 + random(rng) * 0.01f, 1, 1));
+    }
+    hierarchy.Update();
+
+    auto update = [&](const std::string& name, double fraction, ThreadPool* updatePool)
+    {
+      uint32_t dirtyCount = count * fraction;
+      double total = 0;
+      for(int r = 0; r < reps; r++)
+      {
+        for(uint32_t k = 0; k < dirtyCount; k++)
+        {
+          uint32_t node = fraction >= 1 ? k : rng() % count;
+          hierarchy.SetPosition(node, hierarchy.GetPosition(node));
+        }
+        Bench::Clock::time_point start = Bench::Clock::now();
+        hierarchy.Update(updatePool);
+        total += Bench::Seconds(start);
+      }
+      Bench::Report(std::string(shapes[shape]) + ", " + name, total * 1e3 / reps, "ms");
+    };
+    update("1% dirty", 0.01, nullptr);
+    update("100% dirty", 1.0, nullptr);
+    update("1% dirty on " + std::to_string(pool.GetThreadCount()) + " threads", 0.01, &pool);
+    update("100% dirty on " + std::to_string(pool.GetThreadCount()) + " threads", 1.0, &pool);
+
+    std::vector<Mat4> world(count);
+    Bench::Report(std::string(shapes[shape]) + ", full recompute", Bench::Time(10, [&]
+    {
+      for(uint32_t i = 0; i < count; i++)
+      {
+        Mat4 local = Mat4::Translate(hierarchy.GetPosition(i)) * hierarchy.GetRotation(i).ToMat4() * Mat4::Scale(hierarchy.GetScale(i));
+        uint32_t parent = hierarchy.GetParent(i);
+        world[i] = parent == TransformHierarchy::NO_PARENT ? local : world[parent] * local;
+      }
+    }) * 1e3, "ms");
+    Bench::Consume(world[5].elements[3]);
+  }
+}
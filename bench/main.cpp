@@ -0,0 +1,40 @@
+#include "Bench.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+  // Optional arguments select the benchmarks whose name contains one of them
+  std::vector<const char*> filters;
+  for(int i = 1; i < argc; i++)
+  {
+    if(std::strcmp(argv[i], "--quick") == 0)
+      Bench::IsQuick() = true;
+    else
+      filters.push_back(argv[i]);
+  }
+
+  for(auto&& benchmark : Bench::GetBenchmarks())
+  {
+    bool selected = filters.empty();
+    for(auto&& filter : filters)
+      selected |= std::strstr(benchmark.name, filter) != nullptr;
+    if(!selected)
+      continue;
+
+    std::cout << "INFO: " << benchmark.name << std::endl;
+    try
+    {
+      benchmark.function();
+    }
+    catch(const std::exception& e)
+    {
+      std::cerr << "ERROR: " << benchmark.name << ": " << e.what() << std::endl;
+      return EXIT_FAILURE;
+    }
+  }
+  return EXIT_SUCCESS;
+}
@@ -1,9 +1,19 @@
 #pragma once
 
 #include "Device.h"
+#include "CpuProfiler.h"
+#include "FrameStats.h"
+#include "GpuProfiler.h"
+#include "Mesh.h"
+#include "MeshCodec.h"
 
 #include "SwapChainHandler.h"
+#include "TransformHierarchy.h"
 #include "ImageView.h"
+#include "MemoryAllocator.h"
+#include "PipelineCache.h"
+#include "UniformRingBuffer.h"
+#include "UploadContext.h"
 #include "VulkanHandle.h"
 #include <GLFW/glfw3.h>
 #include <iostream>
@@ -24,7 +34,9 @@ const std::vector<const char*> validationLayers = {
 const uint32_t DEFAULT_WIDTH = 1280;
 const uint32_t DEFAULT_HEIGHT = 720;
 
-const int MAX_FRAMES_IN_FLIGHT = 2;
+const uint32_t MAX_UNIFORM_OBJECTS = 4096;
+const VkDeviceSize STAGING_BUFFER_SIZE = 32 * 1024 * 1024;
+const char* const PIPELINE_CACHE_FILE = "pipeline.cache";
 
 #ifdef _DEBUG
 const bool enableValidationLayers = true;
@@ -95,17 +107,48 @@ const std::vector<uint16_t> indices = {
   4, 5, 6, 5, 7, 6,
 };
 
+struct ApplicationSettings
+{
+  SwapChainSettings swapChain;
+  // More frames in flight trade latency for throughput
+  uint32_t framesInFlight = 2;
+  // Prints a frame pacing report every this many frames, 0 only reports on exit
+  uint32_t reportInterval = 0;
+  // Renders this many frames into offscreen images without a window and exits, 0 opens a window
+  uint32_t headlessFrames = 0;
+  // Writes the GPU timings as a Chrome trace on exit if set
+  std::string gpuTraceFile;
+  // Records CPU scopes and writes them as a Chrome trace on exit or when F12 is pressed if set
+  std::string cpuTraceFile;
+  // Optimizes this MESH file and exits without rendering if set, the result replaces the file
+  // unless meshOutputFile is set
+  std::string optimizeMeshFile;
+  std::string meshOutputFile;
+  bool reduceOverdraw = false;
+  // Levels of detail to generate for the optimized mesh, as fractions of the mesh size
+  std::vector<float> lodErrors;
+  // Draws this MESH file instead of the built-in quads if set, its vertices have to be quantized
+  // like Mesh::Quantize does
+  std::string meshFile;
+  // Creates the graphics pipeline this many times with an empty and with the loaded pipeline
+  // cache, prints both timings and exits without rendering if non zero
+  uint32_t pipelineBenchIterations = 0;
+};
+
 class Application
 {
   private:
-    GLFWwindow* window;
+    ApplicationSettings settings;
+    GLFWwindow* window = nullptr;
     Device* device;
 
     VkInstance instance;
     VkDebugUtilsMessengerEXT debugMessenger;
-    VkSurfaceKHR surface;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
 
     SwapChainHandler* swapChains;
+    UploadContext* uploadContext;
+    PipelineCache* pipelineCache;
 
     VkDescriptorSetLayout descriptorSetLayout;
     VkPipelineLayout pipelineLayout;
@@ -114,18 +157,34 @@ class Application
     VkImage textureImage;
     VkImageView textureImageView;
     VkSampler textureSampler;
-    VkDeviceMemory textureImageMemory;
+    MemoryAllocation textureImageMemory;
 
     VkBuffer vertexBuffer;
-    VkDeviceMemory vertexBufferMemory;
+    MemoryAllocation vertexBufferMemory;
+    // One binding per vertex stream, every stream lies in vertexBuffer at its offset
+    std::vector<VkVertexInputBindingDescription> vertexBindings;
+    std::vector<VkVertexInputAttributeDescription> vertexAttributes;
+    std::vector<VkBuffer> vertexBuffers;
+    std::vector<VkDeviceSize> vertexOffsets;
+    std::string vertexShaderFile;
+    // Takes quantized positions back into mesh units, it is folded into ubo.model
+    Greet::Mat4 meshDequantization = Greet::Mat4(1.0f);
+    Greet::AABB meshBounds;
+    // Whether meshBounds is inside the frustum of the current frame
+    bool meshVisible = true;
+    // Every level of detail is a range of the index buffer, meshLod is drawn in the current frame
+    std::vector<Mesh::Lod> meshLods;
+    size_t meshLod = 0;
+    TransformHierarchy* scene;
+    uint32_t meshNode;
     VkBuffer indexBuffer;
-    VkDeviceMemory indexBufferMemory;
+    MemoryAllocation indexBufferMemory;
+    VkIndexType indexType = VK_INDEX_TYPE_UINT16;
 
-    std::vector<VkBuffer> uniformBuffers;
-    std::vector<VkDeviceMemory> uniformBuffersMemory;
+    UniformRingBuffer* uniformBuffer;
 
     VkDescriptorPool descriptorPool;
-    std::vector<VkDescriptorSet> descriptorSets;
+    VkDescriptorSet descriptorSet;
 
     std::vector<VkCommandBuffer> commandBuffers;
 
@@ -133,21 +192,42 @@ class Application
     std::vector<VkSemaphore> renderFinishedSemaphores;
     std::vector<VkFence> inFlightFences;
     size_t currentFrame = 0;
+    FrameStats* frameStats;
+    GpuProfiler* gpuProfiler;
 
     bool framebufferResized = false;
 
 
 
   public:
+    Application(const ApplicationSettings& settings)
+      : settings{settings}
+    {
+      if(this->settings.framesInFlight == 0)
+        throw std::runtime_error("At least one frame has to be in flight");
+      // Every frame in flight renders into its own offscreen image
+      if(IsHeadless())
+        this->settings.swapChain.imageCount = this->settings.framesInFlight;
+    }
+
     void run()
     {
-      InitWindow();
+      CpuProfiler::SetEnabled(!settings.cpuTraceFile.empty());
+      CpuProfiler::SetThreadName("Main");
+      if(!IsHeadless())
+        InitWindow();
       InitVulkan();
-      MainLoop();
+      if(settings.pipelineBenchIterations == 0)
+        MainLoop();
       Cleanup();
     }
 
   private:
+    bool IsHeadless() const
+    {
+      return settings.headlessFrames > 0;
+    }
+
     void InitWindow()
     {
       glfwInit();
@@ -156,51 +236,70 @@ class Application
       window = glfwCreateWindow(DEFAULT_WIDTH, DEFAULT_HEIGHT, "Vulkan window", nullptr, nullptr);
       glfwSetWindowUserPointer(window, this);
       glfwSetFramebufferSizeCallback(window, FramebufferResizeCallback);
+      glfwSetKeyCallback(window, KeyCallback);
     }
 
     void InitVulkan()
     {
       CreateInstance();
       SetupDebugMessenger();
-      CreateSurface();
+      std::vector<const char*> deviceExtensions;
+      if(!IsHeadless())
+      {
+        CreateSurface();
+        deviceExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+      }
       device = new Device(
-          {VK_KHR_SWAPCHAIN_EXTENSION_NAME},
+          deviceExtensions,
           {"VK_LAYER_LUNARG_standard_validation"},
           instance,
           surface);
-      swapChains = new SwapChainHandler(window, surface, device);
+      swapChains = new SwapChainHandler(window, surface, device, settings.swapChain);
+      uploadContext = new UploadContext(device, STAGING_BUFFER_SIZE);
+      pipelineCache = new PipelineCache(device, PIPELINE_CACHE_FILE);
       CreateDescriptorSetLayout();
+      // The mesh decides the vertex input of the pipeline
+      if(settings.meshFile.empty())
+      {
+        CreateVertexBuffer();
+        CreateIndexBuffer();
+      }
+      else
+        LoadMeshFile();
       CreateGraphicsPipeline();
       CreateTextureImage();
       CreateTextureImageView();
       CreateTextureSampler();
-      CreateVertexBuffer();
-      CreateIndexBuffer();
+      uploadContext->Flush();
       CreateUniformBuffers();
       CreateDescriptorPool();
       CreateDescriptorSets();
       CreateCommandBuffers();
       CreateSyncObjects();
+      frameStats = new FrameStats(settings.framesInFlight);
+      gpuProfiler = new GpuProfiler(device, settings.framesInFlight);
+      scene = new TransformHierarchy();
+      meshNode = scene->AddNode();
+      device->GetAllocator()->PrintStats();
     }
 
     void RecreateSwapChain()
     {
       int width = 0;
       int height = 0;
-      while(width==0 || height == 0)
+      glfwGetFramebufferSize(window, &width, &height);
+      // A minimized window has no size, sleep until it is restored
+      while(width == 0 || height == 0)
       {
+        if(glfwWindowShouldClose(window))
+          return;
+        glfwWaitEvents();
         glfwGetFramebufferSize(window, &width, &height);
-        //glfwWaitEvents();
       }
 
-      vkDeviceWaitIdle(device->GetDevice());
-
-      CleanupSwapChain();
-
-      delete swapChains;
-      swapChains = new SwapChainHandler(window, surface, device);
-      CreateGraphicsPipeline();
-      CreateCommandBuffers();
+      // Only the size dependent resources are rebuilt, the pipeline uses dynamic viewport and scissor.
+      // Frames still in flight keep using the old resources until their fences have been waited on.
+      swapChains->Recreate();
     }
 
     void CreateInstance()
@@ -271,7 +370,7 @@ class Application
     {
       VkDescriptorSetLayoutBinding uboLayoutBinding = {};
       uboLayoutBinding.binding = 0;
-      uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+      uboLayoutBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
       uboLayoutBinding.descriptorCount = 1;
       uboLayoutBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
       uboLayoutBinding.pImmutableSamplers = nullptr;
@@ -301,7 +400,7 @@ class Application
 
     void CreateGraphicsPipeline()
     {
-      auto vertShaderCode = readFile("res/shaders/shader.vert.spv");
+      auto vertShaderCode = readFile(vertexShaderFile);
       auto fragShaderCode = readFile("res/shaders/shader.frag.spv");
       VkShaderModule vertShaderModule = CreateShaderModule(vertShaderCode);
       VkShaderModule fragShaderModule = CreateShaderModule(fragShaderCode);
@@ -320,38 +419,31 @@ class Application
 
       VkPipelineShaderStageCreateInfo shaderStages[] = {vertShaderStageInfo, fragShaderStageInfo};
 
-      auto bindingDescription = Vertex::GetBindingDescription();
-      auto attributeDescriptions = Vertex::GetAttributeDescriptions();
       VkPipelineVertexInputStateCreateInfo vertexInputInfo = {};
       vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-      vertexInputInfo.vertexBindingDescriptionCount = 1;
-      vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
-      vertexInputInfo.pVertexBindingDescriptions = &bindingDescription;
-      vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
+      vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(vertexBindings.size());
+      vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(vertexAttributes.size());
+      vertexInputInfo.pVertexBindingDescriptions = vertexBindings.data();
+      vertexInputInfo.pVertexAttributeDescriptions = vertexAttributes.data();
 
       VkPipelineInputAssemblyStateCreateInfo inputAssembly = {};
       inputAssembly.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
       inputAssembly.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
       inputAssembly.primitiveRestartEnable = VK_FALSE;
 
-      VkViewport viewport = {};
-      viewport.x = 0.0f;
-      viewport.y = 0.0f;
-      viewport.width = (float) swapChains->GetWidth();
-      viewport.height = (float) swapChains->GetHeight();
-      viewport.minDepth = 0.0f;
-      viewport.maxDepth = 1.0f;
-
-      VkRect2D scissor = {};
-      scissor.offset = {0,0};
-      scissor.extent = swapChains->GetExtent();
-
+      // Viewport and scissor are set when recording, so the pipeline survives swap chain resizes
       VkPipelineViewportStateCreateInfo viewportState = {};
       viewportState.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
       viewportState.viewportCount = 1;
-      viewportState.pViewports = &viewport;
+      viewportState.pViewports = nullptr;
       viewportState.scissorCount = 1;
-      viewportState.pScissors = &scissor;
+      viewportState.pScissors = nullptr;
+
+      std::array<VkDynamicState, 2> dynamicStates = {VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR};
+      VkPipelineDynamicStateCreateInfo dynamicState = {};
+      dynamicState.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+      dynamicState.dynamicStateCount = static_cast<uint32_t>(dynamicStates.size());
+      dynamicState.pDynamicStates = dynamicStates.data();
 
       VkPipelineRasterizationStateCreateInfo rasterizer = {};
       rasterizer.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
@@ -428,43 +520,69 @@ class Application
       pipelineInfo.pMultisampleState = &multisampling;
       pipelineInfo.pDepthStencilState = &depthStencil;
       pipelineInfo.pColorBlendState = &colorBlending;
-      pipelineInfo.pDynamicState = nullptr;
+      pipelineInfo.pDynamicState = &dynamicState;
       pipelineInfo.layout = pipelineLayout;
       pipelineInfo.renderPass = swapChains->GetRenderPass();
       pipelineInfo.subpass = 0;
       pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
       pipelineInfo.basePipelineIndex = -1;
 
-      if(vkCreateGraphicsPipelines(device->GetDevice(), VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
+      auto startTime = std::chrono::high_resolution_clock::now();
+      if(vkCreateGraphicsPipelines(device->GetDevice(), pipelineCache->GetCache(), 1, &pipelineInfo, nullptr, &graphicsPipeline) != VK_SUCCESS)
         throw std::runtime_error("Failed to create graphics pipeline");
+      float time = std::chrono::duration<float, std::chrono::milliseconds::period>(std::chrono::high_resolution_clock::now() - startTime).count();
+      std::cout << "INFO: Created graphics pipeline in " << time << " ms (" << (pipelineCache->IsWarm() ? "warm" : "cold") << " cache)" << std::endl;
 
+      if(settings.pipelineBenchIterations > 0)
+        BenchmarkPipelineCache(pipelineInfo);
 
       vkDestroyShaderModule(device->GetDevice(), fragShaderModule, nullptr);
       vkDestroyShaderModule(device->GetDevice(), vertShaderModule, nullptr);
     }
 
-    void CreateTextureImage()
+    // Every empty cache run gets a new cache, so only the driver's own shader cache can help it.
+    // The loaded cache already holds the pipeline, even if it was cold on disk.
+    void BenchmarkPipelineCache(const VkGraphicsPipelineCreateInfo& pipelineInfo)
     {
-      uint32_t width, height;
-      BYTE* bytes = ImageUtils::loadImage("res/textures/test.png", &width, &height);
+      VkPipelineCacheCreateInfo cacheInfo = {};
+      cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
 
-      VkDeviceSize imageSize = width * height * 4;
+      float emptyTime = 0.0f;
+      float loadedTime = 0.0f;
+      for(uint32_t i = 0; i < settings.pipelineBenchIterations; i++)
+      {
+        VkPipelineCache emptyCache;
+        if(vkCreatePipelineCache(device->GetDevice(), &cacheInfo, nullptr, &emptyCache) != VK_SUCCESS)
+          throw std::runtime_error("Failed to create pipeline cache");
+        emptyTime += TimePipelineCreation(pipelineInfo, emptyCache);
+        vkDestroyPipelineCache(device->GetDevice(), emptyCache, nullptr);
+        loadedTime += TimePipelineCreation(pipelineInfo, pipelineCache->GetCache());
+      }
+      float iterations = (float)settings.pipelineBenchIterations;
+      std::cout << "INFO: Created graphics pipeline " << settings.pipelineBenchIterations << " times, " << emptyTime / iterations << " ms with an empty cache and "
+        << loadedTime / iterations << " ms with the loaded cache (" << (pipelineCache->IsWarm() ? "warm" : "cold") << " on disk) on average" << std::endl;
+    }
 
-      VkBuffer stagingBuffer;
-      VkDeviceMemory stagingBufferMemory;
-      CreateBuffer(imageSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer, stagingBufferMemory);
+    float TimePipelineCreation(const VkGraphicsPipelineCreateInfo& pipelineInfo, VkPipelineCache cache)
+    {
+      VkPipeline pipeline;
+      auto startTime = std::chrono::high_resolution_clock::now();
+      if(vkCreateGraphicsPipelines(device->GetDevice(), cache, 1, &pipelineInfo, nullptr, &pipeline) != VK_SUCCESS)
+        throw std::runtime_error("Failed to create graphics pipeline");
+      float time = std::chrono::duration<float, std::chrono::milliseconds::period>(std::chrono::high_resolution_clock::now() - startTime).count();
+      vkDestroyPipeline(device->GetDevice(), pipeline, nullptr);
+      return time;
+    }
 
-      UpdateBuffer(stagingBufferMemory, bytes, imageSize);
+    void CreateTextureImage()
+    {
+      uint32_t width, height;
+      BYTE* bytes = ImageUtils::loadImage("res/textures/test.png", &width, &height);
 
-      delete[] bytes;
       ImageView::CreateImage(device, width, height, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, textureImage, textureImageMemory);
+      uploadContext->UploadImage(textureImage, VK_FORMAT_R8G8B8A8_UNORM, bytes, width, height, 4);
 
-      ImageView::TransitionImageLayout(device, swapChains->GetCommandPool(), device->GetGraphicsQueue(), textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-      CopyBufferToImage(stagingBuffer, textureImage, width, height);
-      ImageView::TransitionImageLayout(device, swapChains->GetCommandPool(), device->GetGraphicsQueue(), textureImage, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
-      vkDestroyBuffer(device->GetDevice(), stagingBuffer, nullptr);
-      vkFreeMemory(device->GetDevice(), stagingBufferMemory, nullptr);
-
+      delete[] bytes;
     }
 
     void CreateTextureImageView()
@@ -481,8 +599,8 @@ class Application
       samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_REPEAT;
       samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_REPEAT;
       samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_REPEAT;
-      samplerInfo.anisotropyEnable = VK_TRUE;
-      samplerInfo.maxAnisotropy = 16;
+      samplerInfo.anisotropyEnable = device->GetEnabledFeatures().samplerAnisotropy;
+      samplerInfo.maxAnisotropy = samplerInfo.anisotropyEnable ? 16 : 1;
 
       samplerInfo.borderColor = VK_BORDER_COLOR_INT_OPAQUE_BLACK;
       samplerInfo.unnormalizedCoordinates = VK_FALSE;
@@ -501,65 +619,100 @@ class Application
     void CreateVertexBuffer()
     {
       VkDeviceSize bufferSize = vertices.size() * sizeof(Vertex);
-      VkBuffer stagingBuffer;
-      VkDeviceMemory stagingBufferMemory;
-
-      CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,stagingBufferMemory);
-
-      UpdateBuffer(stagingBufferMemory, vertices.data(), bufferSize);
-
       CreateBuffer(bufferSize,VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer,vertexBufferMemory);
+      uploadContext->UploadBuffer(vertexBuffer, vertices.data(), bufferSize);
 
-      CopyBuffer(stagingBuffer, vertexBuffer, bufferSize);
-
-      vkDestroyBuffer(device->GetDevice(), stagingBuffer, nullptr);
-      vkFreeMemory(device->GetDevice(), stagingBufferMemory, nullptr);
+      auto attributeDescriptions = Vertex::GetAttributeDescriptions();
+      vertexBindings = {Vertex::GetBindingDescription()};
+      vertexAttributes.assign(attributeDescriptions.begin(), attributeDescriptions.end());
+      vertexBuffers = {vertexBuffer};
+      vertexOffsets = {0};
+      vertexShaderFile = "res/shaders/shader.vert.spv";
+
+      meshBounds = Greet::AABB(vertices[0].position, vertices[0].position);
+      for(const Vertex& vertex : vertices)
+        meshBounds.Expand(vertex.position);
     }
 
     void CreateIndexBuffer()
     {
       VkDeviceSize bufferSize = indices.size() * sizeof(indices[0]);
-      VkBuffer stagingBuffer;
-      VkDeviceMemory stagingBufferMemory;
-
-      CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, stagingBuffer,stagingBufferMemory);
-
-      UpdateBuffer(stagingBufferMemory, indices.data(), bufferSize);
-
       CreateBuffer(bufferSize,VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer,indexBufferMemory);
-
-      CopyBuffer(stagingBuffer, indexBuffer, bufferSize);
-
-      vkDestroyBuffer(device->GetDevice(), stagingBuffer, nullptr);
-      vkFreeMemory(device->GetDevice(), stagingBufferMemory, nullptr);
-
+      uploadContext->UploadBuffer(indexBuffer, indices.data(), bufferSize);
+      meshLods = {{0, static_cast<uint32_t>(indices.size()), 0.0f}};
     }
 
-    void CreateUniformBuffers()
+    // The vertex sections are copied from the mapping into a buffer laid out like the payload and
+    // bound at their offsets, encoded indices are decoded into the index buffer
+    void LoadMeshFile()
     {
-      VkDeviceSize bufferSize = sizeof(UniformBufferObject);
-
-      uniformBuffers.resize(swapChains->GetCount());
-      uniformBuffersMemory.resize(swapChains->GetCount());
-      for(size_t i = 0; i < swapChains->GetCount(); i++)
+      Mesh::MappedMesh mesh{settings.meshFile};
+      const Mesh::MeshView& view = mesh.GetView();
+      const Mesh::Section* positions = view.FindSection(Mesh::Semantic::Position);
+      const Mesh::Section* normals = view.FindSection(Mesh::Semantic::Normal);
+      const Mesh::Section* texCoords = view.FindSection(Mesh::Semantic::TexCoord);
+      const Mesh::Section* meshIndices = view.FindSection(Mesh::Semantic::Index);
+      // The inputs of quantized.vert
+      if(!positions || positions->format != VK_FORMAT_R16G16B16A16_UNORM || positions->location != 0 ||
+          !normals || normals->format != VK_FORMAT_R16G16_SNORM || normals->location != 1 ||
+          !texCoords || texCoords->format != VK_FORMAT_R16G16_SFLOAT || texCoords->location != 2 || !meshIndices)
+        throw std::runtime_error("Only meshes quantized by Mesh::Quantize can be drawn: " + settings.meshFile);
+
+      view.GetVertexInputDescriptions(vertexBindings, vertexAttributes);
+      CreateBuffer(view.payloadSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, vertexBuffer, vertexBufferMemory);
+      vertexBuffers.clear();
+      vertexOffsets.clear();
+      for(const Mesh::Section& section : view.sections)
+      {
+        // The sections that GetVertexInputDescriptions made bindings for, in the same order
+        if(section.semantic == Mesh::Semantic::Index || section.format == VK_FORMAT_UNDEFINED)
+          continue;
+        uploadContext->UploadBuffer(vertexBuffer, section.data, section.size, section.offset);
+        vertexBuffers.push_back(vertexBuffer);
+        vertexOffsets.push_back(section.offset);
+      }
+      vertexShaderFile = "res/shaders/quantized.vert.spv";
+      meshDequantization = Mesh::GetDequantizationMatrix(view.bounds);
+      meshBounds = view.bounds;
+
+      indexType = meshIndices->stride == sizeof(uint16_t) ? VK_INDEX_TYPE_UINT16 : VK_INDEX_TYPE_UINT32;
+      VkDeviceSize bufferSize = static_cast<VkDeviceSize>(view.indexCount) * meshIndices->stride;
+      CreateBuffer(bufferSize, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, indexBuffer, indexBufferMemory);
+      if(meshIndices->encoding == Mesh::Encoding::None)
+        uploadContext->UploadBuffer(indexBuffer, meshIndices->data, bufferSize);
+      else if(indexType == VK_INDEX_TYPE_UINT16)
+      {
+        std::vector<uint16_t> decoded(view.indexCount);
+        Mesh::DecodeIndices(*meshIndices, view.indexCount, decoded.data());
+        uploadContext->UploadBuffer(indexBuffer, decoded.data(), bufferSize);
+      }
+      else
       {
-        CreateBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT, uniformBuffers[i], uniformBuffersMemory[i]);
+        std::vector<uint32_t> decoded(view.indexCount);
+        Mesh::DecodeIndices(*meshIndices, view.indexCount, decoded.data());
+        uploadContext->UploadBuffer(indexBuffer, decoded.data(), bufferSize);
       }
+      meshLods = view.GetLods();
+    }
+
+    void CreateUniformBuffers()
+    {
+      uniformBuffer = new UniformRingBuffer(device, sizeof(UniformBufferObject), MAX_UNIFORM_OBJECTS, settings.framesInFlight);
     }
 
     void CreateDescriptorPool()
     {
       std::array<VkDescriptorPoolSize,2> poolSizes = {};
-      poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-      poolSizes[0].descriptorCount = swapChains->GetCount();
+      poolSizes[0].type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+      poolSizes[0].descriptorCount = 1;
       poolSizes[1].type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-      poolSizes[1].descriptorCount = swapChains->GetCount();
+      poolSizes[1].descriptorCount = 1;
 
       VkDescriptorPoolCreateInfo poolInfo = {};
       poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
       poolInfo.poolSizeCount = poolSizes.size();
       poolInfo.pPoolSizes = poolSizes.data();
-      poolInfo.maxSets = static_cast<uint32_t>(swapChains->GetCount());
+      poolInfo.maxSets = 1;
 
       if(vkCreateDescriptorPool(device->GetDevice(), &poolInfo, nullptr, &descriptorPool) != VK_SUCCESS)
         throw std::runtime_error("Failed to create descriptor pool!");
@@ -567,51 +720,47 @@ class Application
 
     void CreateDescriptorSets()
     {
-      std::vector<VkDescriptorSetLayout> layouts(swapChains->GetCount(), descriptorSetLayout);
+      // The uniform ring buffer is shared by all frames, each draw selects its data with a dynamic offset
       VkDescriptorSetAllocateInfo allocInfo = {};
       allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
       allocInfo.descriptorPool = descriptorPool;
-      allocInfo.descriptorSetCount = static_cast<uint32_t>(swapChains->GetCount());
-      allocInfo.pSetLayouts = layouts.data();
+      allocInfo.descriptorSetCount = 1;
+      allocInfo.pSetLayouts = &descriptorSetLayout;
 
-      descriptorSets.resize(swapChains->GetCount());
-      if(vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, descriptorSets.data()) != VK_SUCCESS)
+      if(vkAllocateDescriptorSets(device->GetDevice(), &allocInfo, &descriptorSet) != VK_SUCCESS)
         throw std::runtime_error("Failed to allocate descriptor sets");
 
-      for(size_t i = 0; i < swapChains->GetCount(); i++)
-      {
-        VkDescriptorBufferInfo bufferInfo = {};
-        bufferInfo.buffer = uniformBuffers[i];
-        bufferInfo.offset = 0;
-        bufferInfo.range = sizeof(UniformBufferObject);
-
-        VkDescriptorImageInfo imageInfo = {};
-        imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
-        imageInfo.imageView = textureImageView;
-        imageInfo.sampler = textureSampler;
-
-        std::array<VkWriteDescriptorSet, 2> descriptorWrite = {};
-        descriptorWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite[0].dstSet = descriptorSets[i];
-        descriptorWrite[0].dstBinding = 0;
-        descriptorWrite[0].dstArrayElement = 0;
-        descriptorWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
-        descriptorWrite[0].descriptorCount = 1;
-        descriptorWrite[0].pBufferInfo = &bufferInfo;
-
-        descriptorWrite[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrite[1].dstSet = descriptorSets[i];
-        descriptorWrite[1].dstBinding = 1;
-        descriptorWrite[1].dstArrayElement = 0;
-        descriptorWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
-        descriptorWrite[1].descriptorCount = 1;
-        descriptorWrite[1].pImageInfo = &imageInfo;
-
-        vkUpdateDescriptorSets(device->GetDevice(), descriptorWrite.size(), descriptorWrite.data(), 0, nullptr);
-      }
+      VkDescriptorBufferInfo bufferInfo = {};
+      bufferInfo.buffer = uniformBuffer->GetBuffer();
+      bufferInfo.offset = 0;
+      bufferInfo.range = sizeof(UniformBufferObject);
+
+      VkDescriptorImageInfo imageInfo = {};
+      imageInfo.imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+      imageInfo.imageView = textureImageView;
+      imageInfo.sampler = textureSampler;
+
+      std::array<VkWriteDescriptorSet, 2> descriptorWrite = {};
+      descriptorWrite[0].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrite[0].dstSet = descriptorSet;
+      descriptorWrite[0].dstBinding = 0;
+      descriptorWrite[0].dstArrayElement = 0;
+      descriptorWrite[0].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+      descriptorWrite[0].descriptorCount = 1;
+      descriptorWrite[0].pBufferInfo = &bufferInfo;
+
+      descriptorWrite[1].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      descriptorWrite[1].dstSet = descriptorSet;
+      descriptorWrite[1].dstBinding = 1;
+      descriptorWrite[1].dstArrayElement = 0;
+      descriptorWrite[1].descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+      descriptorWrite[1].descriptorCount = 1;
+      descriptorWrite[1].pImageInfo = &imageInfo;
+
+      vkUpdateDescriptorSets(device->GetDevice(), descriptorWrite.size(), descriptorWrite.data(), 0, nullptr);
     }
 
-    void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, VkDeviceMemory& bufferMemory)
+    void CreateBuffer(VkDeviceSize size, VkBufferUsageFlags usage, VkMemoryPropertyFlags properties, VkBuffer& buffer, MemoryAllocation& bufferMemory)
     {
       VkBufferCreateInfo bufferInfo = {};
       bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
@@ -622,34 +771,14 @@ class Application
       if(vkCreateBuffer(device->GetDevice(), &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
         throw std::runtime_error("Failed to create vertex buffer");
 
-      VkMemoryRequirements memRequirements;
-      vkGetBufferMemoryRequirements(device->GetDevice(), buffer, &memRequirements);
-
-      VkMemoryAllocateInfo allocInfo = {};
-      allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-      allocInfo.allocationSize = memRequirements.size;
-      allocInfo.memoryTypeIndex = VulkanHandle::FindMemoryType(device, memRequirements.memoryTypeBits, properties);
-
-      if(vkAllocateMemory(device->GetDevice(),&allocInfo,nullptr, &bufferMemory) != VK_SUCCESS)
-        throw std::runtime_error("Failed to allocate vertex buffer memory");
-
-      vkBindBufferMemory(device->GetDevice(), buffer, bufferMemory, 0);
-    }
-
-    void CopyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size)
-    {
-      VkCommandBuffer commandBuffer = VulkanHandle::BeginSingleTimeCommand(device, swapChains->GetCommandPool());
-      {
-        VkBufferCopy copyRegion = {};
-        copyRegion.size = size;
-        vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-      }
-      VulkanHandle::EndSingleTimeCommand(device, swapChains->GetCommandPool(), device->GetGraphicsQueue(), commandBuffer);
+      bufferMemory = device->GetAllocator()->AllocateBuffer(buffer, properties);
     }
 
     void CreateCommandBuffers()
     {
-      commandBuffers.resize(swapChains->GetCount());
+      // One command buffer per frame in flight, they are re-recorded every frame since the
+      // uniform offsets change
+      commandBuffers.resize(settings.framesInFlight);
       VkCommandBufferAllocateInfo allocInfo = {};
       allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
       allocInfo.commandPool  = swapChains->GetCommandPool();
@@ -658,58 +787,76 @@ class Application
 
       if(vkAllocateCommandBuffers(device->GetDevice(), &allocInfo, commandBuffers.data()) != VK_SUCCESS)
         throw std::runtime_error("Failed to allocate command buffers");
+    }
 
-      for(size_t i = 0; i < commandBuffers.size(); i++)
-      {
-        VkCommandBufferBeginInfo beginInfo = {};
-        beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-        beginInfo.flags = VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT;
-        beginInfo.pInheritanceInfo = nullptr;
+    void RecordCommandBuffer(VkCommandBuffer commandBuffer, uint32_t imageIndex, uint32_t uniformOffset, std::vector<VkSemaphore>& waitSemaphores, std::vector<VkPipelineStageFlags>& waitStages)
+    {
+      VkCommandBufferBeginInfo beginInfo = {};
+      beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+      beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+      beginInfo.pInheritanceInfo = nullptr;
 
-        if(vkBeginCommandBuffer(commandBuffers[i], &beginInfo) != VK_SUCCESS)
-          throw std::runtime_error("Failed to begin recording command buffer");
+      if(vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS)
+        throw std::runtime_error("Failed to begin recording command buffer");
 
-        VkRenderPassBeginInfo renderPassInfo = {};
-        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-        renderPassInfo.renderPass = swapChains->GetRenderPass();
-        renderPassInfo.framebuffer = swapChains->GetFrameBuffer(i);
-        renderPassInfo.renderArea.offset = {0, 0};
-        renderPassInfo.renderArea.extent = swapChains->GetExtent();
+      uploadContext->AcquireUploads(currentFrame, commandBuffer, waitSemaphores, waitStages);
+      gpuProfiler->BeginFrame(currentFrame, commandBuffer);
+      uint32_t renderPassScope = gpuProfiler->BeginScope(commandBuffer, "RenderPass");
 
-        std::array<VkClearValue,2> clearColors = {};
-        clearColors[0] = { 0.0f, 0.0f, 0.0f, 0.0f };
-        clearColors[1] = { 1.0f, 0 };
+      VkRenderPassBeginInfo renderPassInfo = {};
+      renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+      renderPassInfo.renderPass = swapChains->GetRenderPass();
+      renderPassInfo.framebuffer = swapChains->GetFrameBuffer(imageIndex);
+      renderPassInfo.renderArea.offset = {0, 0};
+      renderPassInfo.renderArea.extent = swapChains->GetExtent();
 
-        renderPassInfo.clearValueCount = clearColors.size();
-        renderPassInfo.pClearValues = clearColors.data();
+      std::array<VkClearValue,2> clearColors = {};
+      clearColors[0] = { 0.0f, 0.0f, 0.0f, 0.0f };
+      clearColors[1] = { 1.0f, 0 };
 
-        vkCmdBeginRenderPass(commandBuffers[i], &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+      renderPassInfo.clearValueCount = clearColors.size();
+      renderPassInfo.pClearValues = clearColors.data();
 
-        {
-          vkCmdBindPipeline(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
+      vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+
+      {
+        vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
 
-          VkBuffer vertexBuffers[] = {vertexBuffer};
-          VkDeviceSize offsets[] = {0};
+        VkViewport viewport = {};
+        viewport.x = 0.0f;
+        viewport.y = 0.0f;
+        viewport.width = (float) swapChains->GetWidth();
+        viewport.height = (float) swapChains->GetHeight();
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 
-          vkCmdBindVertexBuffers(commandBuffers[i], 0, 1,vertexBuffers, offsets);
-          vkCmdBindIndexBuffer(commandBuffers[i], indexBuffer, 0,VK_INDEX_TYPE_UINT16);
+        VkRect2D scissor = {};
+        scissor.offset = {0,0};
+        scissor.extent = swapChains->GetExtent();
+        vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 
-          vkCmdBindDescriptorSets(commandBuffers[i], VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSets[i], 0, nullptr);
+        vkCmdBindVertexBuffers(commandBuffer, 0, vertexBuffers.size(), vertexBuffers.data(), vertexOffsets.data());
+        vkCmdBindIndexBuffer(commandBuffer, indexBuffer, 0, indexType);
 
-          vkCmdDrawIndexed(commandBuffers[i], static_cast<uint32_t>(indices.size()), 1, 0, 0, 0);
+        vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &uniformOffset);
+
+        GpuScope drawScope(gpuProfiler, commandBuffer, "Draw");
+        if(meshVisible)
+          vkCmdDrawIndexed(commandBuffer, meshLods[meshLod].indexCount, 1, meshLods[meshLod].firstIndex, 0, 0);
 
-        }
-        vkCmdEndRenderPass(commandBuffers[i]);
-        if(vkEndCommandBuffer(commandBuffers[i]) != VK_SUCCESS)
-          throw std::runtime_error("Failed to record command buffer");
       }
+      vkCmdEndRenderPass(commandBuffer);
+      gpuProfiler->EndScope(commandBuffer, renderPassScope);
+      if(vkEndCommandBuffer(commandBuffer) != VK_SUCCESS)
+        throw std::runtime_error("Failed to record command buffer");
     }
 
     void CreateSyncObjects()
     {
-      imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-      renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-      inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
+      imageAvailableSemaphores.resize(settings.framesInFlight);
+      renderFinishedSemaphores.resize(settings.framesInFlight);
+      inFlightFences.resize(settings.framesInFlight);
       VkSemaphoreCreateInfo semaphoreInfo = {};
       semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
@@ -717,7 +864,7 @@ class Application
       fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
       fenceInfo.flags= VK_FENCE_CREATE_SIGNALED_BIT;
 
-      for(int i = 0;i<MAX_FRAMES_IN_FLIGHT;i++)
+      for(uint32_t i = 0;i<settings.framesInFlight;i++)
       {
         if(vkCreateSemaphore(device->GetDevice(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) != VK_SUCCESS ||
             vkCreateSemaphore(device->GetDevice(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) != VK_SUCCESS ||
@@ -741,12 +888,15 @@ class Application
 
     std::vector<const char*> GetRequiredExtensions()
     {
-      uint32_t glfwExtensionCount = 0;
-      const char** glfwExtensions;
-
-      glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+      std::vector<const char*> extensions;
+      if(!IsHeadless())
+      {
+        uint32_t glfwExtensionCount = 0;
+        const char** glfwExtensions;
 
-      std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+        glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+        extensions.insert(extensions.end(), glfwExtensions, glfwExtensions + glfwExtensionCount);
+      }
       if(enableValidationLayers)
       {
         extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -780,89 +930,152 @@ class Application
       return true;
     }
 
-    void CopyBufferToImage(VkBuffer buffer, VkImage image, uint32_t width, uint32_t height)
+    void MainLoop()
     {
-      VkCommandBuffer commandBuffer = VulkanHandle::BeginSingleTimeCommand(device, swapChains->GetCommandPool());
-
-      VkBufferImageCopy region = {};
-      region.bufferOffset = 0;
-      region.bufferRowLength = 0;
-      region.bufferImageHeight = 0;
-      region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
-      region.imageSubresource.mipLevel = 0;
-      region.imageSubresource.baseArrayLayer = 0;
-      region.imageSubresource.layerCount = 1;
-
-      region.imageOffset = {0,0,0};
-      region.imageExtent = {width,height,1};
+      if(IsHeadless())
+      {
+        HeadlessLoop();
+        return;
+      }
 
-      vkCmdCopyBufferToImage(commandBuffer, buffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+      while(!glfwWindowShouldClose(window)) {
+        {
+          CpuScope scope("PollEvents");
+          glfwPollEvents();
+        }
+        DrawFrame();
+      }
 
-      VulkanHandle::EndSingleTimeCommand(device, swapChains->GetCommandPool(), device->GetGraphicsQueue(), commandBuffer);
+      vkDeviceWaitIdle(device->GetDevice());
+      FinishProfiling();
     }
 
-    void UpdateBuffer(VkDeviceMemory buffer, const void* data, uint32_t size)
+    void HeadlessLoop()
     {
-      void* dataTemp;
-      vkMapMemory(device->GetDevice(), buffer, 0, size, 0, &dataTemp);
-      memcpy(dataTemp, data, size);
-      vkUnmapMemory(device->GetDevice(), buffer);
+      auto startTime = std::chrono::high_resolution_clock::now();
+      for(uint32_t i = 0; i < settings.headlessFrames; i++)
+        DrawFrame();
+      vkDeviceWaitIdle(device->GetDevice());
+
+      float time = std::chrono::duration<float, std::chrono::milliseconds::period>(std::chrono::high_resolution_clock::now() - startTime).count();
+      std::cout << "INFO: Rendered " << settings.headlessFrames << " frames at " << swapChains->GetWidth() << "x" << swapChains->GetHeight() <<
+        " in " << time << " ms (" << settings.headlessFrames * 1000.0f / time << " fps)" << std::endl;
+      FinishProfiling();
     }
 
-    void MainLoop()
+    // The device must be idle so the last frames' timestamps can be read back
+    void FinishProfiling()
     {
-      while(!glfwWindowShouldClose(window)) {
-        glfwPollEvents();
-        DrawFrame();
-      }
-
-      vkDeviceWaitIdle(device->GetDevice());
+      gpuProfiler->CollectAll();
+      if(frameStats->GetFrameCount() > 0)
+        PrintFrameReport();
+      if(!settings.gpuTraceFile.empty())
+        gpuProfiler->ExportTrace(settings.gpuTraceFile);
+      if(CpuProfiler::IsEnabled())
+        CpuProfiler::ExportTrace(settings.cpuTraceFile);
     }
 
     void DrawFrame()
     {
+      CpuScope frameScope("DrawFrame");
+      auto inputTime = std::chrono::high_resolution_clock::now();
 
-      vkWaitForFences(device->GetDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+      // Completed frames are noticed as early as possible to keep the latency measurement accurate
+      for(uint32_t i = 0; i < settings.framesInFlight; i++)
+      {
+        if(frameStats->IsPending(i) && vkGetFenceStatus(device->GetDevice(), inFlightFences[i]) == VK_SUCCESS)
+          frameStats->FrameCompleted(i);
+      }
 
-      uint32_t imageIndex;
-      VkResult result = vkAcquireNextImageKHR(device->GetDevice(), swapChains->GetSwapChain(), std::numeric_limits<uint64_t>::max(), imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+      {
+        CpuScope scope("WaitForFence");
+        vkWaitForFences(device->GetDevice(), 1, &inFlightFences[currentFrame], VK_TRUE, std::numeric_limits<uint64_t>::max());
+      }
+      frameStats->FrameCompleted(currentFrame);
+      swapChains->CollectRetired(currentFrame);
 
-      if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-        RecreateSwapChain();
+      // Offscreen images are owned by the frames in flight, so they are free once the fence has signaled
+      uint32_t imageIndex = currentFrame;
+      if(!IsHeadless() && !AcquireImage(imageIndex))
         return;
-      } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-        throw std::runtime_error("failed to acquire swap chain image!");
+
+      uniformBuffer->BeginFrame(currentFrame);
+      uint32_t uniformOffset;
+      {
+        CpuScope scope("UpdateUniformBuffer");
+        uniformOffset = UpdateUniformBuffer();
       }
 
-      UpdateUniformBuffer(imageIndex);
+      std::vector<VkSemaphore> waitSemaphores;
+      std::vector<VkPipelineStageFlags> waitStages;
+      if(!IsHeadless())
+      {
+        waitSemaphores.push_back(imageAvailableSemaphores[currentFrame]);
+        waitStages.push_back(VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT);
+      }
+      {
+        CpuScope scope("RecordCommandBuffer");
+        RecordCommandBuffer(commandBuffers[currentFrame], imageIndex, uniformOffset, waitSemaphores, waitStages);
+      }
 
       VkSubmitInfo submitInfo = {};
       submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
-      VkSemaphore waitSemaphores[] = {imageAvailableSemaphores[currentFrame]};
-      VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-      submitInfo.waitSemaphoreCount = 1;
-      submitInfo.pWaitSemaphores = waitSemaphores;
-      submitInfo.pWaitDstStageMask = waitStages;
+      submitInfo.waitSemaphoreCount = static_cast<uint32_t>(waitSemaphores.size());
+      submitInfo.pWaitSemaphores = waitSemaphores.data();
+      submitInfo.pWaitDstStageMask = waitStages.data();
 
       submitInfo.commandBufferCount = 1;
-      submitInfo.pCommandBuffers = &commandBuffers[imageIndex];
+      submitInfo.pCommandBuffers = &commandBuffers[currentFrame];
+
+      if(!IsHeadless())
+      {
+        submitInfo.signalSemaphoreCount = 1;
+        submitInfo.pSignalSemaphores = &renderFinishedSemaphores[currentFrame];
+      }
+
+      {
+        CpuScope scope("Submit");
+        vkResetFences(device->GetDevice(), 1, &inFlightFences[currentFrame]);
 
-      VkSemaphore signalSemaphores[] = {renderFinishedSemaphores[currentFrame]};
-      submitInfo.signalSemaphoreCount = 1;
-      submitInfo.pSignalSemaphores = signalSemaphores;
+        if (vkQueueSubmit(device->GetGraphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
+          throw std::runtime_error("failed to submit draw command buffer!");
+        }
+      }
+      frameStats->FrameSubmitted(currentFrame, inputTime);
 
-      vkResetFences(device->GetDevice(), 1, &inFlightFences[currentFrame]);
+      if(!IsHeadless())
+        PresentImage(imageIndex);
 
-      if (vkQueueSubmit(device->GetGraphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
-        throw std::runtime_error("failed to submit draw command buffer!");
+      currentFrame = (currentFrame + 1) % settings.framesInFlight;
+
+      if(settings.reportInterval > 0 && frameStats->GetFrameCount() >= settings.reportInterval)
+        PrintFrameReport();
+    }
+
+    // Returns false if the swap chain had to be recreated and the frame should be skipped
+    bool AcquireImage(uint32_t& imageIndex)
+    {
+      CpuScope scope("AcquireImage");
+      VkResult result = vkAcquireNextImageKHR(device->GetDevice(), swapChains->GetSwapChain(), std::numeric_limits<uint64_t>::max(), imageAvailableSemaphores[currentFrame], VK_NULL_HANDLE, &imageIndex);
+
+      if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        RecreateSwapChain();
+        return false;
+      } else if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+        throw std::runtime_error("failed to acquire swap chain image!");
       }
+      return true;
+    }
 
+    void PresentImage(uint32_t imageIndex)
+    {
+      CpuScope scope("PresentImage");
       VkPresentInfoKHR presentInfo = {};
       presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
       presentInfo.waitSemaphoreCount = 1;
-      presentInfo.pWaitSemaphores = signalSemaphores;
+      presentInfo.pWaitSemaphores = &renderFinishedSemaphores[currentFrame];
 
       VkSwapchainKHR chains[] = {swapChains->GetSwapChain()};
       presentInfo.swapchainCount = 1;
@@ -870,7 +1083,7 @@ class Application
 
       presentInfo.pImageIndices = &imageIndex;
 
-      result = vkQueuePresentKHR(device->GetPresentQueue(), &presentInfo);
+      VkResult result = vkQueuePresentKHR(device->GetPresentQueue(), &presentInfo);
 
       if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR || framebufferResized) {
         framebufferResized = false;
@@ -878,50 +1091,61 @@ class Application
       } else if (result != VK_SUCCESS) {
         throw std::runtime_error("failed to present swap chain image!");
       }
+    }
 
-      currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    void PrintFrameReport()
+    {
+      std::string presentMode = IsHeadless() ? "headless" : SwapChainHandler::GetPresentModeName(swapChains->GetPresentMode());
+      frameStats->PrintReport(
+          presentMode + ", " +
+          std::to_string(settings.framesInFlight) + " frames in flight, " +
+          std::to_string(swapChains->GetCount()) + " images");
+      gpuProfiler->PrintReport();
     }
 
-    void UpdateUniformBuffer(uint32_t currentImage)
+    uint32_t UpdateUniformBuffer()
     {
       static auto startTime = std::chrono::high_resolution_clock::now();
 
       auto currentTime = std::chrono::high_resolution_clock::now();
       float time = std::chrono::duration<float, std::chrono::seconds::period>(currentTime - startTime).count();
       UniformBufferObject ubo = {};
-      ubo.model = Greet::Mat4::RotateRZ(time);
+      scene->SetRotation(meshNode, Greet::Quaternion::RotationR(time, Greet::Vec3(0, 0, 1)));
+      scene->Update();
+      Greet::Mat4 world = scene->GetWorldMatrix(meshNode);
+      ubo.model = world * meshDequantization;
       ubo.view = Greet::Mat4::LookAt(Greet::Vec3(1,1,1), Greet::Vec3(0,0,0), Greet::Vec3(0,0,-1));
       ubo.proj = Greet::Mat4::ProjectionMatrix(swapChains->GetWidth() / (float) swapChains->GetHeight(), 90, 0.1f, 10.0f);
+      // The bounds are in mesh units, before the dequantization
+      meshVisible = Greet::Frustum(ubo.proj * ubo.view).Intersects(meshBounds.Transform(world));
+      meshLod = Mesh::SelectLod(meshLods, meshBounds, ubo.view * world, ubo.proj, swapChains->GetHeight());
 
-      UpdateBuffer(uniformBuffersMemory[currentImage], &ubo, sizeof(ubo));
+      return uniformBuffer->Push(ubo);
     }
 
     void Cleanup()
     {
-      CleanupSwapChain();
+      vkDestroyPipeline(device->GetDevice(), graphicsPipeline, nullptr);
+      vkDestroyPipelineLayout(device->GetDevice(), pipelineLayout, nullptr);
 
       delete swapChains;
 
       vkDestroySampler(device->GetDevice(), textureSampler, nullptr);
       vkDestroyImageView(device->GetDevice(), textureImageView, nullptr);
       vkDestroyImage(device->GetDevice(), textureImage, nullptr);
-      vkFreeMemory(device->GetDevice(), textureImageMemory, nullptr);
+      device->GetAllocator()->Free(textureImageMemory);
       vkDestroyDescriptorPool(device->GetDevice(), descriptorPool, nullptr);
 
       vkDestroyDescriptorSetLayout(device->GetDevice(), descriptorSetLayout, nullptr);
-      for(size_t i = 0; i < swapChains->GetCount(); i++)
-      {
-        vkDestroyBuffer(device->GetDevice(), uniformBuffers[i], nullptr);
-        vkFreeMemory(device->GetDevice(), uniformBuffersMemory[i], nullptr);
-      }
+      delete uniformBuffer;
 
       vkDestroyBuffer(device->GetDevice(), indexBuffer, nullptr);
-      vkFreeMemory(device->GetDevice(), indexBufferMemory, nullptr);
+      device->GetAllocator()->Free(indexBufferMemory);
 
       vkDestroyBuffer(device->GetDevice(), vertexBuffer, nullptr);
-      vkFreeMemory(device->GetDevice(), vertexBufferMemory, nullptr);
+      device->GetAllocator()->Free(vertexBufferMemory);
 
-      for(size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+      for(uint32_t i = 0; i < settings.framesInFlight; i++)
       {
         vkDestroySemaphore(device->GetDevice(), renderFinishedSemaphores[i], nullptr);
         vkDestroySemaphore(device->GetDevice(), imageAvailableSemaphores[i], nullptr);
@@ -931,23 +1155,33 @@ class Application
       if(enableValidationLayers)
         VulkanHandle::DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 
-      vkDestroyDevice(device->GetDevice(), nullptr);
-      vkDestroySurfaceKHR(instance,surface, nullptr);
+      delete frameStats;
+      delete gpuProfiler;
+      delete scene;
+      delete uploadContext;
+      delete pipelineCache;
+      delete device;
+      if(!IsHeadless())
+        vkDestroySurfaceKHR(instance,surface, nullptr);
       vkDestroyInstance(instance, nullptr);
-      glfwDestroyWindow(window);
-      glfwTerminate();
+      if(!IsHeadless())
+      {
+        glfwDestroyWindow(window);
+        glfwTerminate();
+      }
     }
 
-    void CleanupSwapChain()
+    static void FramebufferResizeCallback(GLFWwindow* window, int width, int height)
     {
-      vkDestroyPipeline(device->GetDevice(), graphicsPipeline, nullptr);
-      vkDestroyPipelineLayout(device->GetDevice(), pipelineLayout, nullptr);
+      auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
+      app->framebufferResized = true;
     }
 
-    static void FramebufferResizeCallback(GLFWwindow* window, int width, int height)
+    static void KeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods)
     {
       auto app = reinterpret_cast<Application*>(glfwGetWindowUserPointer(window));
-      app->framebufferResized = true;
+      if(key == GLFW_KEY_F12 && action == GLFW_PRESS && CpuProfiler::IsEnabled())
+        CpuProfiler::ExportTrace(app->settings.cpuTraceFile);
     }
 
     static VKAPI_ATTR VkBool32 VKAPI_CALL DebugCallback(VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity, VkDebugUtilsMessageTypeFlagsEXT messageType, const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData, void* pUserData)
@@ -0,0 +1,226 @@
+#include "BlockAllocator.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+BlockAllocator::BlockAllocator(const VkPhysicalDeviceMemoryProperties& memoryProperties, VkDeviceSize bufferImageGranularity, uint32_t maxAllocationCount,
+    const AllocateMemoryFunction& allocateMemory, const FreeMemoryFunction& freeMemory)
+  : memoryProperties{memoryProperties}, bufferImageGranularity{std::max<VkDeviceSize>(bufferImageGranularity, 1)}, maxAllocationCount{maxAllocationCount},
+  allocateMemory{allocateMemory}, freeMemory{freeMemory}
+{}
+
+BlockAllocator::~BlockAllocator()
+{
+  for(uint32_t i = 0; i < VK_MAX_MEMORY_TYPES; i++)
+  {
+    while(!blocks[i].empty())
+      DestroyBlock(blocks[i].back());
+  }
+}
+
+MemoryAllocation BlockAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceType type)
+{
+  uint32_t memoryType = FindMemoryType(memoryProperties, requirements.memoryTypeBits, properties);
+  VkDeviceSize blockSize = GetPreferredBlockSize(memoryType);
+
+  MemoryAllocation allocation;
+
+  // Large resources would leave most of a shared block unusable, give them their own memory
+  if(requirements.size > blockSize / 2)
+  {
+    MemoryBlock* block = CreateBlock(memoryType, requirements.size, true);
+    AllocateFromBlock(block, requirements, type, allocation);
+    return allocation;
+  }
+
+  for(auto&& block : blocks[memoryType])
+  {
+    if(!block->dedicated && AllocateFromBlock(block, requirements, type, allocation))
+      return allocation;
+  }
+
+  MemoryBlock* block = CreateBlock(memoryType, blockSize, false);
+  if(!AllocateFromBlock(block, requirements, type, allocation))
+    throw std::runtime_error("Failed to allocate from new memory block");
+  return allocation;
+}
+
+void BlockAllocator::Free(MemoryAllocation& allocation)
+{
+  MemoryBlock* block = allocation.block;
+  if(block == nullptr)
+    return;
+
+  FreeFromBlock(block, allocation.offset - allocation.padding);
+  allocation = {};
+
+  if(block->freeBytes != block->size)
+    return;
+
+  if(block->dedicated)
+  {
+    DestroyBlock(block);
+    return;
+  }
+
+  // Keep a single empty block around so that alternating allocations and frees don't thrash vkAllocateMemory
+  for(auto&& other : blocks[block->memoryType])
+  {
+    if(other != block && !other->dedicated && other->freeBytes == other->size)
+    {
+      DestroyBlock(block);
+      return;
+    }
+  }
+}
+
+uint32_t BlockAllocator::FindMemoryType(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeFilter, VkMemoryPropertyFlags properties)
+{
+  for(uint32_t i = 0;i<memoryProperties.memoryTypeCount; i++)
+  {
+    if(typeFilter & (1  << i) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties)
+      return i;
+  }
+  throw std::runtime_error("Failed to find suitable memory type");
+}
+
+VkDeviceSize BlockAllocator::GetPreferredBlockSize(uint32_t memoryType) const
+{
+  VkDeviceSize heapSize = memoryProperties.memoryHeaps[memoryProperties.memoryTypes[memoryType].heapIndex].size;
+  // Small heaps (eg. the host visible part of VRAM) would be exhausted by a handful of default sized blocks
+  if(heapSize <= 1024 * 1024 * 1024)
+    return AlignUp(heapSize / 8, 1024);
+  return DEFAULT_BLOCK_SIZE;
+}
+
+MemoryBlock* BlockAllocator::CreateBlock(uint32_t memoryType, VkDeviceSize size, bool dedicated)
+{
+  if(stats.blockCount >= maxAllocationCount)
+    throw std::runtime_error("Exceeded maxMemoryAllocationCount");
+
+  bool hostVisible = memoryProperties.memoryTypes[memoryType].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+  void* mapped = nullptr;
+  VkDeviceMemory memory = allocateMemory(memoryType, size, hostVisible ? &mapped : nullptr);
+
+  MemoryBlock* block = new MemoryBlock{memory, size, size, memoryType, dedicated, static_cast<char*>(mapped)};
+  block->suballocations[0] = {size, 0, ResourceType::Free};
+
+  blocks[memoryType].push_back(block);
+  stats.bytesReserved += size;
+  stats.blockCount++;
+  return block;
+}
+
+void BlockAllocator::DestroyBlock(MemoryBlock* block)
+{
+  freeMemory(block->memory, block->mapped != nullptr);
+
+  std::vector<MemoryBlock*>& typeBlocks = blocks[block->memoryType];
+  typeBlocks.erase(std::find(typeBlocks.begin(), typeBlocks.end(), block));
+  stats.bytesReserved -= block->size;
+  stats.blockCount--;
+  delete block;
+}
+
+bool BlockAllocator::AllocateFromBlock(MemoryBlock* block, const VkMemoryRequirements& requirements, ResourceType type, MemoryAllocation& allocation)
+{
+  if(block->freeBytes < requirements.size)
+    return false;
+
+  std::map<VkDeviceSize, Suballocation>& suballocations = block->suballocations;
+  for(auto it = suballocations.begin(); it != suballocations.end(); ++it)
+  {
+    if(it->second.type != ResourceType::Free || it->second.size < requirements.size)
+      continue;
+
+    VkDeviceSize start = it->first;
+    VkDeviceSize end = start + it->second.size;
+    VkDeviceSize offset = AlignUp(start, requirements.alignment);
+
+    // Linear and optimal resources sharing a bufferImageGranularity page may alias on some hardware
+    if(it != suballocations.begin())
+    {
+      auto prev = std::prev(it);
+      if(IsConflicting(prev->second.type, type) && OnSamePage(prev->first + prev->second.size - 1, offset, bufferImageGranularity))
+        offset = AlignUp(offset, bufferImageGranularity);
+    }
+    if(offset + requirements.size > end)
+      continue;
+
+    // The next resource starts after its own padding
+    auto next = std::next(it);
+    if(next != suballocations.end() && IsConflicting(type, next->second.type) && OnSamePage(offset + requirements.size - 1, next->first + next->second.padding, bufferImageGranularity))
+      continue;
+
+    VkDeviceSize padding = offset - start;
+    VkDeviceSize size = padding + requirements.size;
+    it->second = {size, padding, type};
+    if(end > start + size)
+      suballocations[start + size] = {end - start - size, 0, ResourceType::Free};
+
+    block->freeBytes -= size;
+    stats.bytesUsed += requirements.size;
+    stats.bytesWasted += padding;
+    stats.allocationCount++;
+
+    allocation.memory = block->memory;
+    allocation.offset = offset;
+    allocation.size = requirements.size;
+    allocation.padding = padding;
+    allocation.memoryType = block->memoryType;
+    allocation.block = block;
+    allocation.mapped = block->mapped ? block->mapped + offset : nullptr;
+    return true;
+  }
+  return false;
+}
+
+void BlockAllocator::FreeFromBlock(MemoryBlock* block, VkDeviceSize start)
+{
+  std::map<VkDeviceSize, Suballocation>& suballocations = block->suballocations;
+  auto it = suballocations.find(start);
+  if(it == suballocations.end() || it->second.type == ResourceType::Free)
+    throw std::runtime_error("Freeing memory which isn't allocated");
+
+  block->freeBytes += it->second.size;
+  stats.bytesUsed -= it->second.size - it->second.padding;
+  stats.bytesWasted -= it->second.padding;
+  stats.allocationCount--;
+
+  it->second.type = ResourceType::Free;
+  it->second.padding = 0;
+
+  auto next = std::next(it);
+  if(next != suballocations.end() && next->second.type == ResourceType::Free)
+  {
+    it->second.size += next->second.size;
+    suballocations.erase(next);
+  }
+
+  if(it != suballocations.begin())
+  {
+    auto prev = std::prev(it);
+    if(prev->second.type == ResourceType::Free)
+    {
+      prev->second.size += it->second.size;
+      suballocations.erase(it);
+    }
+  }
+}
+
+VkDeviceSize BlockAllocator::AlignUp(VkDeviceSize value, VkDeviceSize alignment)
+{
+  if(alignment <= 1)
+    return value;
+  return (value + alignment - 1) / alignment * alignment;
+}
+
+bool BlockAllocator::OnSamePage(VkDeviceSize endOfFirst, VkDeviceSize startOfSecond, VkDeviceSize pageSize)
+{
+  return endOfFirst / pageSize == startOfSecond / pageSize;
+}
+
+bool BlockAllocator::IsConflicting(ResourceType first, ResourceType second)
+{
+  return first != ResourceType::Free && second != ResourceType::Free && first != second;
+}
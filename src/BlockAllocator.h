@@ -0,0 +1,108 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <functional>
+#include <map>
+#include <vector>
+
+enum class ResourceType
+{
+  Free, Linear, Optimal
+};
+
+struct Suballocation
+{
+  VkDeviceSize size;
+  // Bytes skipped at the start of the range to satisfy alignment and bufferImageGranularity
+  VkDeviceSize padding;
+  ResourceType type;
+};
+
+struct MemoryBlock
+{
+  VkDeviceMemory memory;
+  VkDeviceSize size;
+  VkDeviceSize freeBytes;
+  uint32_t memoryType;
+  bool dedicated;
+  // Host visible blocks are mapped once for their whole lifetime
+  char* mapped;
+
+  // Ordered by the start offset of each range, neighbouring free ranges are always merged
+  std::map<VkDeviceSize, Suballocation> suballocations;
+};
+
+struct MemoryAllocation
+{
+  VkDeviceMemory memory = VK_NULL_HANDLE;
+  VkDeviceSize offset = 0;
+  VkDeviceSize size = 0;
+  VkDeviceSize padding = 0;
+  uint32_t memoryType = 0;
+  MemoryBlock* block = nullptr;
+  // Points at offset inside the block if the memory is host visible, otherwise nullptr
+  void* mapped = nullptr;
+};
+
+struct MemoryStats
+{
+  VkDeviceSize bytesReserved = 0;
+  VkDeviceSize bytesUsed = 0;
+  VkDeviceSize bytesWasted = 0;
+  uint32_t blockCount = 0;
+  uint32_t allocationCount = 0;
+};
+
+// Sub-allocates resources from large blocks of device memory. The blocks themselves are created
+// and destroyed through the given functions, so the bookkeeping doesn't depend on a device and
+// can be driven by a fake memory type table.
+class BlockAllocator
+{
+  public:
+    // Allocates size bytes of memoryType and, if mapped isn't nullptr, maps the whole range into
+    // it. Has to throw instead of returning if the memory can't be allocated or mapped.
+    using AllocateMemoryFunction = std::function<VkDeviceMemory(uint32_t memoryType, VkDeviceSize size, void** mapped)>;
+    // Unmaps the memory if it was mapped and frees it
+    using FreeMemoryFunction = std::function<void(VkDeviceMemory memory, bool mapped)>;
+
+    static constexpr VkDeviceSize DEFAULT_BLOCK_SIZE = 64 * 1024 * 1024;
+
+  private:
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    VkDeviceSize bufferImageGranularity;
+    uint32_t maxAllocationCount;
+    AllocateMemoryFunction allocateMemory;
+    FreeMemoryFunction freeMemory;
+
+    std::vector<MemoryBlock*> blocks[VK_MAX_MEMORY_TYPES];
+    MemoryStats stats;
+
+  public:
+    BlockAllocator(const VkPhysicalDeviceMemoryProperties& memoryProperties, VkDeviceSize bufferImageGranularity, uint32_t maxAllocationCount,
+        const AllocateMemoryFunction& allocateMemory, const FreeMemoryFunction& freeMemory);
+    ~BlockAllocator();
+
+    BlockAllocator(const BlockAllocator&) = delete;
+    BlockAllocator& operator=(const BlockAllocator&) = delete;
+
+    MemoryAllocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceType type);
+    void Free(MemoryAllocation& allocation);
+
+    const MemoryStats& GetStats() const { return stats; }
+    const std::vector<MemoryBlock*>& GetBlocks(uint32_t memoryType) const { return blocks[memoryType]; }
+    VkDeviceSize GetPreferredBlockSize(uint32_t memoryType) const;
+
+    static uint32_t FindMemoryType(const VkPhysicalDeviceMemoryProperties& memoryProperties, uint32_t typeFilter, VkMemoryPropertyFlags properties);
+
+  private:
+    MemoryBlock* CreateBlock(uint32_t memoryType, VkDeviceSize size, bool dedicated);
+    void DestroyBlock(MemoryBlock* block);
+
+    // Returns false if the block doesn't have a free range that fits the requirements
+    bool AllocateFromBlock(MemoryBlock* block, const VkMemoryRequirements& requirements, ResourceType type, MemoryAllocation& allocation);
+    void FreeFromBlock(MemoryBlock* block, VkDeviceSize start);
+
+    static VkDeviceSize AlignUp(VkDeviceSize value, VkDeviceSize alignment);
+    static bool OnSamePage(VkDeviceSize endOfFirst, VkDeviceSize startOfSecond, VkDeviceSize pageSize);
+    static bool IsConflicting(ResourceType first, ResourceType second);
+};
@@ -0,0 +1,110 @@
+#include "CpuProfiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+static const size_t EVENTS_PER_THREAD = 1 << 16;
+
+namespace
+{
+  struct ThreadBuffer
+  {
+    uint32_t threadId;
+    const char* name = nullptr;
+    uint32_t depth = 0;
+    std::vector<CpuTraceEvent> events;
+    // Total number of events written, the writer publishes with release after each event
+    std::atomic<uint64_t> written{0};
+
+    ThreadBuffer(uint32_t threadId)
+      : threadId{threadId}, events(EVENTS_PER_THREAD)
+    {}
+  };
+
+  // Buffers are kept until exit so events of finished threads can still be exported
+  std::mutex buffersMutex;
+  std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+
+  const std::chrono::steady_clock::time_point origin = std::chrono::steady_clock::now();
+
+  thread_local ThreadBuffer* threadBuffer = nullptr;
+
+  ThreadBuffer* GetThreadBuffer()
+  {
+    if(threadBuffer)
+      return threadBuffer;
+
+    std::lock_guard<std::mutex> lock(buffersMutex);
+    buffers.push_back(std::make_unique<ThreadBuffer>(buffers.size()));
+    threadBuffer = buffers.back().get();
+    return threadBuffer;
+  }
+}
+
+std::atomic<bool> CpuProfiler::enabled{false};
+
+void CpuProfiler::SetThreadName(const char* name)
+{
+  GetThreadBuffer()->name = name;
+}
+
+uint64_t CpuProfiler::Now()
+{
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - origin).count();
+}
+
+uint32_t CpuProfiler::BeginScope()
+{
+  return GetThreadBuffer()->depth++;
+}
+
+void CpuProfiler::EndScope(const char* name, uint64_t start, uint32_t depth)
+{
+  uint64_t end = Now();
+  ThreadBuffer* buffer = GetThreadBuffer();
+  buffer->depth = depth;
+
+  uint64_t index = buffer->written.load(std::memory_order_relaxed);
+  buffer->events[index % EVENTS_PER_THREAD] = {name, start, end, depth};
+  buffer->written.store(index + 1, std::memory_order_release);
+}
+
+void CpuProfiler::ExportTrace(const std::string& filename)
+{
+  std::ofstream file(filename);
+  if(!file.is_open())
+    throw std::runtime_error("Failed to open trace file " + filename);
+
+  std::lock_guard<std::mutex> lock(buffersMutex);
+  file << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+  size_t eventCount = 0;
+  bool first = true;
+  for(auto&& buffer : buffers)
+  {
+    if(buffer->name)
+    {
+      file << (first ? "" : ",") << "\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":" << buffer->threadId <<
+        ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+      first = false;
+    }
+
+    uint64_t written = buffer->written.load(std::memory_order_acquire);
+    uint64_t begin = written > EVENTS_PER_THREAD ? written - EVENTS_PER_THREAD : 0;
+    for(uint64_t i = begin; i < written; i++)
+    {
+      const CpuTraceEvent& event = buffer->events[i % EVENTS_PER_THREAD];
+      file << (first ? "" : ",") << "\n{\"name\":\"" << event.name << "\",\"cat\":\"cpu\",\"ph\":\"X\",\"pid\":0,\"tid\":" << buffer->threadId <<
+        ",\"ts\":" << event.start / 1000.0 << ",\"dur\":" << (event.end - event.start) / 1000.0 << ",\"args\":{\"depth\":" << event.depth << "}}";
+      first = false;
+    }
+    eventCount += written - begin;
+  }
+  file << "\n]}" << std::endl;
+  std::cout << "INFO: Wrote " << eventCount << " CPU trace events to " << filename << std::endl;
+}
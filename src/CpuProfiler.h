@@ -0,0 +1,64 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+struct CpuTraceEvent
+{
+  // Must be a string literal or otherwise outlive the profiler
+  const char* name;
+  // Nanoseconds since the profiler was first used
+  uint64_t start;
+  uint64_t end;
+  uint32_t depth;
+};
+
+// Records named CPU scopes into a fixed size ring buffer per thread. A thread's buffer is
+// allocated the first time it records a scope, after that recording only reads the clock and
+// writes into the buffer. When a buffer is full the oldest events are overwritten.
+class CpuProfiler
+{
+  private:
+    static std::atomic<bool> enabled;
+
+  public:
+    static void SetEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    static bool IsEnabled() { return enabled.load(std::memory_order_relaxed); }
+
+    // Shown as the thread's name in the trace
+    static void SetThreadName(const char* name);
+
+    static uint64_t Now();
+    static uint32_t BeginScope();
+    static void EndScope(const char* name, uint64_t start, uint32_t depth);
+
+    // Chrome trace event format, viewable in chrome://tracing or Perfetto. Events of threads
+    // which are recording while exporting may be torn, the main thread's events are consistent
+    // when called from the main thread.
+    static void ExportTrace(const std::string& filename);
+};
+
+struct CpuScope
+{
+  const char* name;
+  uint64_t start;
+  uint32_t depth;
+  bool enabled;
+
+  CpuScope(const char* name)
+    : name{name}, enabled{CpuProfiler::IsEnabled()}
+  {
+    if(enabled)
+    {
+      depth = CpuProfiler::BeginScope();
+      start = CpuProfiler::Now();
+    }
+  }
+
+  ~CpuScope()
+  {
+    if(enabled)
+      CpuProfiler::EndScope(name, start, depth);
+  }
+};
@@ -1,14 +1,22 @@
 #include "Device.h"
 
+#include "MemoryAllocator.h"
 #include "VulkanHandle.h"
 
 #include "SwapChainHandler.h"
 
-Device::Device(std::initializer_list<const char*> deviceExtensions,std::initializer_list<const char*> validationLayers, VkInstance instance, VkSurfaceKHR surface)
+Device::Device(const std::vector<const char*>& deviceExtensions, const std::vector<const char*>& validationLayers, VkInstance instance, VkSurfaceKHR surface)
 {
   DeviceSetup setup{deviceExtensions, validationLayers, instance, surface};
   PickPhysicalDevice(setup);
   CreateLogicalDevice(setup);
+  allocator = new MemoryAllocator(this);
+}
+
+Device::~Device()
+{
+  delete allocator;
+  vkDestroyDevice(device, nullptr);
 }
 
 void Device::PickPhysicalDevice(DeviceSetup& setup)
@@ -31,6 +39,7 @@ void Device::PickPhysicalDevice(DeviceSetup& setup)
   }
   if(physicalDevice == VK_NULL_HANDLE)
     throw std::runtime_error("Failed to find GPU with support of all needed operations");
+  vkGetPhysicalDeviceProperties(physicalDevice, &properties);
   PrintPhysicalDeviceName(physicalDevice);
 }
 
@@ -38,15 +47,14 @@ bool Device::IsDeviceSuitable(DeviceSetup& setup, VkPhysicalDevice device)
 {
   QueueFamilyIndices indices = VulkanHandle::FindQueueFamilies(device, setup.surface);
   bool extensionSupported = CheckDeviceExtensionSupport(setup, device);
-  bool swapChainAdequate = false;
-  if(extensionSupported)
+  // Without a surface nothing is presented, so the swap chain support doesn't matter
+  bool swapChainAdequate = setup.surface == VK_NULL_HANDLE;
+  if(extensionSupported && !swapChainAdequate)
   {
     SwapChainSupportDetails swapChainSupport = SwapChainHandler::QuerySwapChainSupport(setup.surface, device);
     swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
   }
-  VkPhysicalDeviceFeatures supportedFeatures;
-  vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
-  return indices.IsComplete() && extensionSupported && swapChainAdequate && supportedFeatures.samplerAnisotropy;
+  return indices.IsComplete() && extensionSupported && swapChainAdequate;
 }
 
 bool Device::CheckDeviceExtensionSupport(DeviceSetup& setup, VkPhysicalDevice device)
@@ -90,8 +98,10 @@ void Device::CreateLogicalDevice(DeviceSetup& setup)
 
   std::set<uint32_t> uniqueQueueFamilies = {
     indices.graphicsFamily.value(),
-    indices.presentFamily.value(),
+    indices.transferFamily.value(),
   };
+  if(indices.presentFamily.has_value())
+    uniqueQueueFamilies.insert(indices.presentFamily.value());
   for(uint32_t queueFamily : uniqueQueueFamilies)
   {
     VkDeviceQueueCreateInfo queueCreateInfo = {};
@@ -102,13 +112,15 @@ void Device::CreateLogicalDevice(DeviceSetup& setup)
     queueCreateInfos.push_back(queueCreateInfo);
   }
 
-  VkPhysicalDeviceFeatures deviceFeatures = {};
-  deviceFeatures.samplerAnisotropy = VK_TRUE;
+  // Anisotropic filtering is optional since software implementations may lack it
+  VkPhysicalDeviceFeatures supportedFeatures;
+  vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+  enabledFeatures.samplerAnisotropy = supportedFeatures.samplerAnisotropy;
   VkDeviceCreateInfo createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
   createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
   createInfo.pQueueCreateInfos = queueCreateInfos.data();
-  createInfo.pEnabledFeatures = &deviceFeatures;
+  createInfo.pEnabledFeatures = &enabledFeatures;
   createInfo.enabledExtensionCount = static_cast<uint32_t>(setup.deviceExtensions.size());
   createInfo.ppEnabledExtensionNames = setup.deviceExtensions.data();
 #ifdef _DEBUG
@@ -122,5 +134,20 @@ void Device::CreateLogicalDevice(DeviceSetup& setup)
     throw std::runtime_error("Failed to create logical device");
 
   vkGetDeviceQueue(device, indices.graphicsFamily.value(), 0, &graphicsQueue);
-  vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+  if(indices.presentFamily.has_value())
+    vkGetDeviceQueue(device, indices.presentFamily.value(), 0, &presentQueue);
+  vkGetDeviceQueue(device, indices.transferFamily.value(), 0, &transferQueue);
+
+  graphicsFamily = indices.graphicsFamily.value();
+  transferFamily = indices.transferFamily.value();
+
+  uint32_t queueFamilyCount;
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+  transferGranularity = queueFamilies[transferFamily].minImageTransferGranularity;
+
+  if(HasDedicatedTransferQueue())
+    std::cout << "INFO: Using dedicated transfer queue family " << transferFamily << " with image granularity " <<
+      transferGranularity.width << "x" << transferGranularity.height << "x" << transferGranularity.depth << std::endl;
 }
@@ -4,6 +4,7 @@
 #include <set>
 #include <vector>
 
+class MemoryAllocator;
 
 struct DeviceSetup
 {
@@ -18,17 +19,37 @@ class Device
 {
   private:
     VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
+    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceFeatures enabledFeatures = {};
     VkDevice device;
 
+    uint32_t graphicsFamily;
+    uint32_t transferFamily;
+    VkExtent3D transferGranularity;
     VkQueue graphicsQueue;
-    VkQueue presentQueue;
+    VkQueue presentQueue = VK_NULL_HANDLE;
+    VkQueue transferQueue;
+
+    MemoryAllocator* allocator;
   public:
-    Device(std::initializer_list<const char*> deviceExtensions, std::initializer_list<const char*> validationLayers, VkInstance instance, VkSurfaceKHR surface);
+    // A null surface creates a headless device without present support
+    Device(const std::vector<const char*>& deviceExtensions, const std::vector<const char*>& validationLayers, VkInstance instance, VkSurfaceKHR surface);
+    ~Device();
 
     VkDevice GetDevice() const { return device; }
     VkPhysicalDevice GetPhysicalDevice() const { return physicalDevice; }
+    const VkPhysicalDeviceProperties& GetProperties() const { return properties; }
+    const VkPhysicalDeviceFeatures& GetEnabledFeatures() const { return enabledFeatures; }
     VkQueue GetGraphicsQueue() const { return graphicsQueue; }
+    // VK_NULL_HANDLE for headless devices
     VkQueue GetPresentQueue() const { return presentQueue; }
+    VkQueue GetTransferQueue() const { return transferQueue; }
+    uint32_t GetGraphicsFamily() const { return graphicsFamily; }
+    uint32_t GetTransferFamily() const { return transferFamily; }
+    bool HasDedicatedTransferQueue() const { return transferFamily != graphicsFamily; }
+    // minImageTransferGranularity of the transfer family, always (1, 1, 1) for the graphics family
+    const VkExtent3D& GetTransferGranularity() const { return transferGranularity; }
+    MemoryAllocator* GetAllocator() const { return allocator; }
 
   private:
     void PickPhysicalDevice(DeviceSetup& setup);
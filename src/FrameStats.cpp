@@ -0,0 +1,57 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+void RunningSummary::Add(double value)
+{
+  count++;
+  min = count == 1 ? value : std::min(min, value);
+  max = count == 1 ? value : std::max(max, value);
+
+  double delta = value - avg;
+  avg += delta / count;
+  squaredDeviations += delta * (value - avg);
+}
+
+double RunningSummary::GetStddev() const
+{
+  return count > 0 ? std::sqrt(squaredDeviations / count) : 0;
+}
+
+FrameStats::FrameStats(uint32_t framesInFlight)
+  : inputTimes(framesInFlight), pending(framesInFlight, false)
+{}
+
+void FrameStats::FrameSubmitted(uint32_t frame, Clock::time_point inputTime)
+{
+  Clock::time_point now = Clock::now();
+  if(hasSubmitted)
+    frameTimes.Add(std::chrono::duration<double, std::milli>(now - lastSubmit).count());
+  lastSubmit = now;
+  hasSubmitted = true;
+
+  inputTimes[frame] = inputTime;
+  pending[frame] = true;
+}
+
+void FrameStats::FrameCompleted(uint32_t frame)
+{
+  if(!pending[frame])
+    return;
+  latencies.Add(std::chrono::duration<double, std::milli>(Clock::now() - inputTimes[frame]).count());
+  pending[frame] = false;
+}
+
+void FrameStats::PrintReport(const std::string& configuration)
+{
+  std::cout << "INFO: Frame pacing (" << configuration << ") over " << frameTimes.count << " frames" << std::endl;
+  std::cout << "INFO:   frame time avg " << frameTimes.avg << " ms, stddev " << frameTimes.GetStddev() <<
+    " ms, min " << frameTimes.min << " ms, max " << frameTimes.max << " ms" << std::endl;
+  std::cout << "INFO:   input latency avg " << latencies.avg << " ms, stddev " << latencies.GetStddev() <<
+    " ms, min " << latencies.min << " ms, max " << latencies.max << " ms" << std::endl;
+
+  frameTimes = {};
+  latencies = {};
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Min, max, mean and standard deviation of a stream of values, without keeping the values
+struct RunningSummary
+{
+  uint32_t count = 0;
+  double min = 0;
+  double max = 0;
+  double avg = 0;
+  // Sum of squared differences from the mean, see Welford's online algorithm
+  double squaredDeviations = 0;
+
+  void Add(double value);
+  double GetStddev() const;
+};
+
+// Collects frame pacing statistics for the frames in flight. The latency is measured from when
+// input was polled until the frame's fence is observed signaled, presentation itself can't be
+// observed without VK_GOOGLE_display_timing.
+class FrameStats
+{
+  private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    std::vector<Clock::time_point> inputTimes;
+    std::vector<bool> pending;
+
+    Clock::time_point lastSubmit;
+    bool hasSubmitted = false;
+
+    RunningSummary frameTimes;
+    RunningSummary latencies;
+
+  public:
+    FrameStats(uint32_t framesInFlight);
+
+    void FrameSubmitted(uint32_t frame, Clock::time_point inputTime);
+    void FrameCompleted(uint32_t frame);
+    bool IsPending(uint32_t frame) const { return pending[frame]; }
+    uint32_t GetFrameCount() const { return frameTimes.count; }
+
+    // Prints and clears the statistics collected since the last report
+    void PrintReport(const std::string& configuration);
+};
@@ -0,0 +1,183 @@
+#include "GpuProfiler.h"
+
+#include "Device.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+static const size_t ROLLING_WINDOW = 120;
+static const size_t MAX_TRACE_EVENTS = 1 << 20;
+static const uint32_t INVALID_SCOPE = ~0u;
+
+GpuProfiler::GpuProfiler(Device* device, uint32_t framesInFlight, uint32_t maxScopes)
+  : device{device}, maxScopes{maxScopes}, frames(framesInFlight)
+{
+  uint32_t queueFamilyCount;
+  vkGetPhysicalDeviceQueueFamilyProperties(device->GetPhysicalDevice(), &queueFamilyCount, nullptr);
+  std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+  vkGetPhysicalDeviceQueueFamilyProperties(device->GetPhysicalDevice(), &queueFamilyCount, queueFamilies.data());
+
+  uint32_t validBits = queueFamilies[device->GetGraphicsFamily()].timestampValidBits;
+  supported = validBits > 0;
+  if(!supported)
+  {
+    std::cout << "INFO: Timestamp queries are unsupported, GPU profiling is disabled" << std::endl;
+    return;
+  }
+  timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+  timestampPeriod = device->GetProperties().limits.timestampPeriod;
+
+  VkQueryPoolCreateInfo createInfo = {};
+  createInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+  createInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+  createInfo.queryCount = framesInFlight * maxScopes * 2;
+
+  if(vkCreateQueryPool(device->GetDevice(), &createInfo, nullptr, &queryPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create timestamp query pool");
+}
+
+GpuProfiler::~GpuProfiler()
+{
+  if(queryPool != VK_NULL_HANDLE)
+    vkDestroyQueryPool(device->GetDevice(), queryPool, nullptr);
+}
+
+void GpuProfiler::BeginFrame(uint32_t frame, VkCommandBuffer commandBuffer)
+{
+  if(!supported)
+    return;
+
+  CollectFrame(frame);
+  currentFrame = frame;
+  depth = 0;
+  vkCmdResetQueryPool(commandBuffer, queryPool, frame * maxScopes * 2, maxScopes * 2);
+}
+
+void GpuProfiler::CollectAll()
+{
+  if(!supported)
+    return;
+
+  for(uint32_t i = 0; i < frames.size(); i++)
+    CollectFrame(i);
+}
+
+uint32_t GpuProfiler::BeginScope(VkCommandBuffer commandBuffer, const std::string& name)
+{
+  FrameQueries& queries = frames[currentFrame];
+  if(!supported || queries.scopes.size() >= maxScopes)
+    return INVALID_SCOPE;
+
+  uint32_t scope = queries.scopes.size();
+  queries.scopes.push_back(GetScopeId(name));
+  queries.depths.push_back(depth++);
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, (currentFrame * maxScopes + scope) * 2);
+  return scope;
+}
+
+void GpuProfiler::EndScope(VkCommandBuffer commandBuffer, uint32_t scope)
+{
+  if(scope == INVALID_SCOPE)
+    return;
+
+  depth--;
+  vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, (currentFrame * maxScopes + scope) * 2 + 1);
+}
+
+void GpuProfiler::PrintReport() const
+{
+  for(uint32_t i = 0; i < scopeNames.size(); i++)
+  {
+    const std::deque<double>& scopeSamples = samples[i];
+    if(scopeSamples.empty())
+      continue;
+
+    double min = scopeSamples.front();
+    double max = scopeSamples.front();
+    double sum = 0;
+    for(auto&& sample : scopeSamples)
+    {
+      min = std::min(min, sample);
+      max = std::max(max, sample);
+      sum += sample;
+    }
+    std::cout << "INFO: GPU " << scopeNames[i] << ": min " << min << " ms, avg " << sum / scopeSamples.size() <<
+      " ms, max " << max << " ms (last " << scopeSamples.size() << " frames)" << std::endl;
+  }
+}
+
+void GpuProfiler::ExportTrace(const std::string& filename) const
+{
+  std::ofstream file(filename);
+  if(!file.is_open())
+    throw std::runtime_error("Failed to open trace file " + filename);
+
+  file << "{\"traceEvents\":[";
+  for(size_t i = 0; i < traceEvents.size(); i++)
+  {
+    const GpuTraceEvent& event = traceEvents[i];
+    if(i > 0)
+      file << ",";
+    file << "\n{\"name\":\"" << scopeNames[event.scope] << "\",\"cat\":\"gpu\",\"ph\":\"X\",\"pid\":0,\"tid\":\"GPU\"," <<
+      "\"ts\":" << event.start << ",\"dur\":" << event.duration << ",\"args\":{\"depth\":" << event.depth << "}}";
+  }
+  file << "\n]}" << std::endl;
+  std::cout << "INFO: Wrote " << traceEvents.size() << " GPU trace events to " << filename << std::endl;
+}
+
+void GpuProfiler::CollectFrame(uint32_t frame)
+{
+  FrameQueries& queries = frames[frame];
+  if(queries.scopes.empty())
+    return;
+
+  // Value and availability for the begin and end query of each scope
+  uint32_t queryCount = queries.scopes.size() * 2;
+  std::vector<uint64_t> results(queryCount * 2);
+  VkResult result = vkGetQueryPoolResults(device->GetDevice(), queryPool, frame * maxScopes * 2, queryCount,
+      results.size() * sizeof(uint64_t), results.data(), 2 * sizeof(uint64_t),
+      VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+  if(result != VK_SUCCESS && result != VK_NOT_READY)
+    throw std::runtime_error("Failed to read timestamp queries");
+
+  for(uint32_t i = 0; i < queries.scopes.size(); i++)
+  {
+    // Scopes which were never ended or not executed yet are skipped
+    if(results[i * 4 + 1] == 0 || results[i * 4 + 3] == 0)
+      continue;
+
+    uint64_t begin = results[i * 4] & timestampMask;
+    uint64_t end = results[i * 4 + 2] & timestampMask;
+    double duration = ((end - begin) & timestampMask) * timestampPeriod / 1000.0;
+
+    std::deque<double>& scopeSamples = samples[queries.scopes[i]];
+    scopeSamples.push_back(duration / 1000.0);
+    if(scopeSamples.size() > ROLLING_WINDOW)
+      scopeSamples.pop_front();
+
+    if(!hasTraceOrigin)
+    {
+      traceOrigin = begin;
+      hasTraceOrigin = true;
+    }
+    if(traceEvents.size() < MAX_TRACE_EVENTS)
+      traceEvents.push_back({queries.scopes[i], queries.depths[i], static_cast<int64_t>(begin - traceOrigin) * timestampPeriod / 1000.0, duration});
+  }
+  queries.scopes.clear();
+  queries.depths.clear();
+}
+
+uint32_t GpuProfiler::GetScopeId(const std::string& name)
+{
+  auto it = scopeIds.find(name);
+  if(it != scopeIds.end())
+    return it->second;
+
+  uint32_t id = scopeNames.size();
+  scopeNames.push_back(name);
+  scopeIds.emplace(name, id);
+  samples.emplace_back();
+  return id;
+}
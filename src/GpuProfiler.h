@@ -0,0 +1,88 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+class Device;
+
+struct GpuTraceEvent
+{
+  uint32_t scope;
+  uint32_t depth;
+  // Microseconds since the first recorded timestamp
+  double start;
+  double duration;
+};
+
+// Measures GPU time of named scopes with timestamp queries. Every frame in flight has its own
+// range of queries which is read back the next time the frame is recorded, at which point its
+// fence has signaled so the readback never stalls.
+class GpuProfiler
+{
+  private:
+    struct FrameQueries
+    {
+      std::vector<uint32_t> scopes;
+      std::vector<uint32_t> depths;
+    };
+
+    Device* device;
+    VkQueryPool queryPool = VK_NULL_HANDLE;
+    uint32_t maxScopes;
+    bool supported;
+    double timestampPeriod;
+    uint64_t timestampMask;
+
+    std::vector<FrameQueries> frames;
+    uint32_t currentFrame = 0;
+    uint32_t depth = 0;
+
+    std::vector<std::string> scopeNames;
+    std::map<std::string, uint32_t> scopeIds;
+    // Rolling window of durations in milliseconds
+    std::vector<std::deque<double>> samples;
+
+    std::vector<GpuTraceEvent> traceEvents;
+    uint64_t traceOrigin = 0;
+    bool hasTraceOrigin = false;
+
+  public:
+    GpuProfiler(Device* device, uint32_t framesInFlight, uint32_t maxScopes = 64);
+    ~GpuProfiler();
+
+    // Reads back the previous results of the frame and resets its queries. Must be recorded
+    // outside of a render pass, after the fence of the frame has been waited on.
+    void BeginFrame(uint32_t frame, VkCommandBuffer commandBuffer);
+    // Reads back every frame, the device must be idle
+    void CollectAll();
+
+    uint32_t BeginScope(VkCommandBuffer commandBuffer, const std::string& name);
+    void EndScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+    void PrintReport() const;
+    // Chrome trace event format, viewable in chrome://tracing or Perfetto
+    void ExportTrace(const std::string& filename) const;
+
+  private:
+    void CollectFrame(uint32_t frame);
+    uint32_t GetScopeId(const std::string& name);
+};
+
+struct GpuScope
+{
+  GpuProfiler* profiler;
+  VkCommandBuffer commandBuffer;
+  uint32_t scope;
+
+  GpuScope(GpuProfiler* profiler, VkCommandBuffer commandBuffer, const std::string& name)
+    : profiler{profiler}, commandBuffer{commandBuffer}, scope{profiler->BeginScope(commandBuffer, name)}
+  {}
+
+  ~GpuScope()
+  {
+    profiler->EndScope(commandBuffer, scope);
+  }
+};
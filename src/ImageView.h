@@ -2,10 +2,11 @@
 
 #include "VulkanHandle.h"
 #include "Device.h"
+#include "MemoryAllocator.h"
 
 struct ImageView
 {
-    static void CreateImage(Device* device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, VkDeviceMemory& imageMemory)
+    static void CreateImage(Device* device, uint32_t width, uint32_t height, VkFormat format, VkImageTiling tiling, VkImageUsageFlags usage, VkMemoryPropertyFlags properties, VkImage& image, MemoryAllocation& imageMemory)
     {
       if(width == 0 || height == 0)
         throw std::runtime_error("Invalid size " + std::to_string(width) + " " + std::to_string(height));
@@ -28,17 +29,7 @@ struct ImageView
       if(vkCreateImage(device->GetDevice(), &imageInfo, nullptr, &image) != VK_SUCCESS)
         throw std::runtime_error("Failed to create image");
 
-      VkMemoryRequirements memRequirements;
-      vkGetImageMemoryRequirements(device->GetDevice(), image, &memRequirements);
-
-      VkMemoryAllocateInfo allocInfo = {};
-      allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-      allocInfo.allocationSize = memRequirements.size;
-      allocInfo.memoryTypeIndex = VulkanHandle::FindMemoryType(device, memRequirements.memoryTypeBits, properties);
-
-      if(vkAllocateMemory(device->GetDevice(), &allocInfo, nullptr, &imageMemory) != VK_SUCCESS)
-        throw std::runtime_error("Failed to allocate image memory");
-      vkBindImageMemory(device->GetDevice(), image, imageMemory, 0);
+      imageMemory = device->GetAllocator()->AllocateImage(image, properties, tiling);
     }
 
     static VkImageView CreateImageView(Device* device, VkImage image, VkFormat format, VkImageAspectFlags aspectFlags)
@@ -60,10 +51,8 @@ struct ImageView
       return imageView;
     }
 
-    static void TransitionImageLayout(Device* device, VkCommandPool commandPool, VkQueue queue, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
+    static void RecordTransitionImageLayout(VkCommandBuffer commandBuffer, VkImage image, VkFormat format, VkImageLayout oldLayout, VkImageLayout newLayout)
     {
-      VkCommandBuffer commandBuffer = VulkanHandle::BeginSingleTimeCommand(device, commandPool);
-
       VkImageMemoryBarrier barrier = {};
       barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
       barrier.oldLayout = oldLayout;
@@ -117,9 +106,6 @@ struct ImageView
         throw std::runtime_error("Unsupported layout transition");
 
       vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 0, nullptr, 0, nullptr,1, &barrier);
-
-      VulkanHandle::EndSingleTimeCommand(device, commandPool, queue, commandBuffer);
-
     }
 
     static bool HasStencilComponent(VkFormat format)
@@ -0,0 +1,126 @@
+#include "MappedFile.h"
+
+#include <stdexcept>
+#include <utility>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#if defined(_WIN32)
+MappedFile::MappedFile(const std::string& filename)
+{
+  HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+  if(handle == INVALID_HANDLE_VALUE)
+    throw std::runtime_error("Failed to open " + filename);
+  file = handle;
+
+  LARGE_INTEGER fileSize;
+  if(!GetFileSizeEx(handle, &fileSize))
+  {
+    Unmap();
+    throw std::runtime_error("Failed to read size of " + filename);
+  }
+  size = fileSize.QuadPart;
+  // Empty files can't be mapped
+  if(size == 0)
+    return;
+
+  mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if(mapping)
+    data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+  if(!data)
+  {
+    Unmap();
+    throw std::runtime_error("Failed to map " + filename);
+  }
+}
+
+void MappedFile::Unmap()
+{
+  if(data)
+    UnmapViewOfFile(data);
+  if(mapping)
+    CloseHandle(mapping);
+  if(file)
+    CloseHandle(file);
+  data = nullptr;
+  mapping = nullptr;
+  file = nullptr;
+  size = 0;
+}
+#else
+MappedFile::MappedFile(const std::string& filename)
+{
+  int fd = open(filename.c_str(), O_RDONLY);
+  if(fd == -1)
+    throw std::runtime_error("Failed to open " + filename);
+
+  struct stat info;
+  if(fstat(fd, &info) != 0)
+  {
+    close(fd);
+    throw std::runtime_error("Failed to read size of " + filename);
+  }
+  size = info.st_size;
+  // Empty files can't be mapped
+  if(size == 0)
+  {
+    close(fd);
+    return;
+  }
+
+  // The mapping keeps its own reference to the file, so it can be closed right away
+  void* address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(address == MAP_FAILED)
+  {
+    size = 0;
+    throw std::runtime_error("Failed to map " + filename);
+  }
+  data = (const char*)address;
+
+  // Files are mostly read front to back, which lets the kernel read ahead more aggressively
+  madvise(address, size, MADV_SEQUENTIAL);
+}
+
+void MappedFile::Unmap()
+{
+  if(data)
+    munmap((void*)data, size);
+  data = nullptr;
+  size = 0;
+}
+#endif
+
+MappedFile::~MappedFile()
+{
+  Unmap();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+{
+  *this = std::move(other);
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+  if(this != &other)
+  {
+    Unmap();
+    std::swap(data, other.data);
+    std::swap(size, other.size);
+#if defined(_WIN32)
+    std::swap(file, other.file);
+    std::swap(mapping, other.mapping);
+#endif
+  }
+  return *this;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// Read-only memory mapping of a whole file. The pages are read in by the OS as they are touched,
+// so the contents can be handed on without copying them into a buffer of our own first.
+class MappedFile
+{
+  private:
+    const char* data = nullptr;
+    size_t size = 0;
+#if defined(_WIN32)
+    void* file = nullptr;
+    void* mapping = nullptr;
+#endif
+
+  public:
+    explicit MappedFile(const std::string& filename);
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // Only valid while the MappedFile is alive, an empty file has no data
+    const char* GetData() const { return data; }
+    size_t GetSize() const { return size; }
+
+  private:
+    void Unmap();
+};
@@ -0,0 +1,89 @@
+#include "MemoryAllocator.h"
+
+#include "Device.h"
+
+#include <iostream>
+#include <stdexcept>
+
+MemoryAllocator::MemoryAllocator(Device* device)
+  : device{device},
+  blocks{GetMemoryProperties(device), device->GetProperties().limits.bufferImageGranularity, device->GetProperties().limits.maxMemoryAllocationCount,
+    [this](uint32_t memoryType, VkDeviceSize size, void** mapped) { return AllocateMemory(memoryType, size, mapped); },
+    [this](VkDeviceMemory memory, bool mapped) { FreeMemory(memory, mapped); }}
+{}
+
+MemoryAllocation MemoryAllocator::Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceType type)
+{
+  return blocks.Allocate(requirements, properties, type);
+}
+
+MemoryAllocation MemoryAllocator::AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties)
+{
+  VkMemoryRequirements memRequirements;
+  vkGetBufferMemoryRequirements(device->GetDevice(), buffer, &memRequirements);
+
+  MemoryAllocation allocation = Allocate(memRequirements, properties, ResourceType::Linear);
+  if(vkBindBufferMemory(device->GetDevice(), buffer, allocation.memory, allocation.offset) != VK_SUCCESS)
+    throw std::runtime_error("Failed to bind buffer memory");
+  return allocation;
+}
+
+MemoryAllocation MemoryAllocator::AllocateImage(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling)
+{
+  VkMemoryRequirements memRequirements;
+  vkGetImageMemoryRequirements(device->GetDevice(), image, &memRequirements);
+
+  ResourceType type = tiling == VK_IMAGE_TILING_LINEAR ? ResourceType::Linear : ResourceType::Optimal;
+  MemoryAllocation allocation = Allocate(memRequirements, properties, type);
+  if(vkBindImageMemory(device->GetDevice(), image, allocation.memory, allocation.offset) != VK_SUCCESS)
+    throw std::runtime_error("Failed to bind image memory");
+  return allocation;
+}
+
+void MemoryAllocator::Free(MemoryAllocation& allocation)
+{
+  blocks.Free(allocation);
+}
+
+void MemoryAllocator::PrintStats() const
+{
+  const MemoryStats& stats = blocks.GetStats();
+  std::cout << "INFO: GPU memory " <<
+    stats.bytesUsed / 1024 << " KiB used, " <<
+    stats.bytesWasted / 1024 << " KiB wasted, " <<
+    stats.bytesReserved / 1024 << " KiB reserved in " <<
+    stats.blockCount << " blocks (" << stats.allocationCount << " allocations)" << std::endl;
+}
+
+VkPhysicalDeviceMemoryProperties MemoryAllocator::GetMemoryProperties(Device* device)
+{
+  VkPhysicalDeviceMemoryProperties memoryProperties;
+  vkGetPhysicalDeviceMemoryProperties(device->GetPhysicalDevice(), &memoryProperties);
+  return memoryProperties;
+}
+
+VkDeviceMemory MemoryAllocator::AllocateMemory(uint32_t memoryType, VkDeviceSize size, void** mapped)
+{
+  VkMemoryAllocateInfo allocInfo = {};
+  allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+  allocInfo.allocationSize = size;
+  allocInfo.memoryTypeIndex = memoryType;
+
+  VkDeviceMemory memory;
+  if(vkAllocateMemory(device->GetDevice(), &allocInfo, nullptr, &memory) != VK_SUCCESS)
+    throw std::runtime_error("Failed to allocate memory block");
+
+  if(mapped && vkMapMemory(device->GetDevice(), memory, 0, VK_WHOLE_SIZE, 0, mapped) != VK_SUCCESS)
+  {
+    vkFreeMemory(device->GetDevice(), memory, nullptr);
+    throw std::runtime_error("Failed to map memory block");
+  }
+  return memory;
+}
+
+void MemoryAllocator::FreeMemory(VkDeviceMemory memory, bool mapped)
+{
+  if(mapped)
+    vkUnmapMemory(device->GetDevice(), memory);
+  vkFreeMemory(device->GetDevice(), memory, nullptr);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "BlockAllocator.h"
+
+#include <vulkan/vulkan.h>
+
+class Device;
+
+class MemoryAllocator
+{
+  private:
+    Device* device;
+    BlockAllocator blocks;
+
+  public:
+    MemoryAllocator(Device* device);
+
+    MemoryAllocation Allocate(const VkMemoryRequirements& requirements, VkMemoryPropertyFlags properties, ResourceType type);
+    MemoryAllocation AllocateBuffer(VkBuffer buffer, VkMemoryPropertyFlags properties);
+    MemoryAllocation AllocateImage(VkImage image, VkMemoryPropertyFlags properties, VkImageTiling tiling);
+    void Free(MemoryAllocation& allocation);
+
+    const MemoryStats& GetStats() const { return blocks.GetStats(); }
+    void PrintStats() const;
+
+  private:
+    static VkPhysicalDeviceMemoryProperties GetMemoryProperties(Device* device);
+    VkDeviceMemory AllocateMemory(uint32_t memoryType, VkDeviceSize size, void** mapped);
+    void FreeMemory(VkDeviceMemory memory, bool mapped);
+};
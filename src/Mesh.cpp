@@ -0,0 +1,436 @@
+#include "Mesh.h"
+
+#include "MeshCodec.h"
+#include "MeshOptimizer.h"
+
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace Mesh
+{
+  static const char SIGNATURE[4] = {'G', 'M', 'S', 'H'};
+  static const char SIGNATURE_V1[4] = {'M', 'E', 'S', 'H'};
+  static const size_t HEADER_SIZE_V1 = 4 * sizeof(char) + 2 * sizeof(uint32_t) + sizeof(size_t);
+  static const size_t ATTRIBUTE_SIZE_V1 = 4 * sizeof(uint32_t) + sizeof(bool);
+
+  // Header fields are assembled byte by byte, which is independent of both the host's
+  // endianness and the alignment of the buffer
+  static uint32_t ReadU32(const char* data)
+  {
+    const unsigned char* bytes = (const unsigned char*)data;
+    return bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+  }
+
+  static uint64_t ReadU64(const char* data)
+  {
+    return ReadU32(data) | ((uint64_t)ReadU32(data + 4) << 32);
+  }
+
+  static float ReadFloat(const char* data)
+  {
+    uint32_t bits = ReadU32(data);
+    float value;
+    memcpy(&value, &bits, sizeof(float));
+    return value;
+  }
+
+  static void WriteU32(char* data, uint32_t value)
+  {
+    for(int i = 0; i < 4; i++)
+      data[i] = (char)(value >> (i * 8));
+  }
+
+  static void WriteU64(char* data, uint64_t value)
+  {
+    WriteU32(data, (uint32_t)value);
+    WriteU32(data + 4, (uint32_t)(value >> 32));
+  }
+
+  static void WriteFloat(char* data, float value)
+  {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(float));
+    WriteU32(data, bits);
+  }
+
+  static size_t AlignUp(size_t value)
+  {
+    return (value + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+  }
+
+  // Eight lookup tables so that the CRC advances 8 bytes per step instead of one, the
+  // polynomial is the reflected 0xEDB88320 of zlib and PNG
+  struct Crc32Tables
+  {
+    uint32_t tables[8][256];
+
+    Crc32Tables()
+    {
+      for(uint32_t i = 0; i < 256; i++)
+      {
+        uint32_t crc = i;
+        for(int bit = 0; bit < 8; bit++)
+          crc = (crc >> 1) ^ (0xEDB88320 & (0 - (crc & 1)));
+        tables[0][i] = crc;
+      }
+      for(uint32_t i = 0; i < 256; i++)
+      {
+        for(int table = 1; table < 8; table++)
+          tables[table][i] = (tables[table - 1][i] >> 8) ^ tables[0][tables[table - 1][i] & 0xFF];
+      }
+    }
+  };
+
+  uint32_t Crc32(const char* data, size_t size, uint32_t crc)
+  {
+    static const Crc32Tables crcTables;
+    const uint32_t (*t)[256] = crcTables.tables;
+    const unsigned char* bytes = (const unsigned char*)data;
+
+    crc = ~crc;
+    for(; size >= 8; size -= 8, bytes += 8)
+    {
+      uint32_t low = ReadU32((const char*)bytes) ^ crc;
+      uint32_t high = ReadU32((const char*)bytes + 4);
+      crc = t[7][low & 0xFF] ^ t[6][(low >> 8) & 0xFF] ^ t[5][(low >> 16) & 0xFF] ^ t[4][low >> 24] ^
+        t[3][high & 0xFF] ^ t[2][(high >> 8) & 0xFF] ^ t[1][(high >> 16) & 0xFF] ^ t[0][high >> 24];
+    }
+    for(; size > 0; size--, bytes++)
+      crc = (crc >> 8) ^ t[0][(crc ^ *bytes) & 0xFF];
+    return ~crc;
+  }
+
+  static MeshView ParseMeshV1(const char* data, size_t size)
+  {
+    // Check if the file is big enough to contain signature, vertex count, index count and attribute count
+    if(size < HEADER_SIZE_V1)
+      throw std::runtime_error("Could not read MESH file, file is too small to contain signature.");
+
+    MeshView view;
+    size_t attributeCount;
+    memcpy(&view.vertexCount, data + 4, sizeof(uint32_t));
+    memcpy(&view.indexCount, data + 8, sizeof(uint32_t));
+    memcpy(&attributeCount, data + 12, sizeof(size_t));
+    if(view.vertexCount == 0)
+      throw std::runtime_error("VertexCount is 0");
+    if(view.indexCount == 0)
+      throw std::runtime_error("IndexCount is 0");
+
+    // Remaining is what is left of the file after each section, all sizes fit in 64 bits so
+    // only the attribute count has to be checked before multiplying
+    uint64_t remaining = size - HEADER_SIZE_V1;
+    if(attributeCount > remaining / ATTRIBUTE_SIZE_V1)
+      throw std::runtime_error("Could not read MESH file, file is too small to contain attribute parameters");
+    remaining -= attributeCount * ATTRIBUTE_SIZE_V1;
+
+    view.payload = data + HEADER_SIZE_V1 + attributeCount * ATTRIBUTE_SIZE_V1;
+    view.payloadSize = remaining;
+
+    uint64_t offset = 0;
+    auto addSection = [&](Semantic semantic, uint32_t location, VkFormat format, uint32_t stride, uint64_t count, const char* error)
+    {
+      uint64_t sectionSize = stride * count;
+      if(remaining < sectionSize)
+        throw std::runtime_error(error);
+      remaining -= sectionSize;
+      view.sections.push_back({semantic, location, format, stride, offset, sectionSize, 0, view.payload + offset});
+      offset += sectionSize;
+    };
+    addSection(Semantic::Position, 0, VK_FORMAT_R32G32B32_SFLOAT, sizeof(Greet::Vec3), view.vertexCount, "Could not read MESH file, file is too small to contain vertex data");
+    addSection(Semantic::Index, 0, VK_FORMAT_UNDEFINED, sizeof(uint32_t), view.indexCount, "Could not read MESH file, file is too small to contain index data");
+
+    // Version 1 attributes have OpenGL types, which have no direct Vulkan equivalent
+    const char* pointer = data + HEADER_SIZE_V1;
+    for(size_t i = 0; i < attributeCount; i++, pointer += ATTRIBUTE_SIZE_V1)
+      addSection(Semantic::Custom, ReadU32(pointer), VK_FORMAT_UNDEFINED, ReadU32(pointer + 8), view.vertexCount, "Could not read MESH file, file is too small to contain attribute data");
+
+    Greet::Vec3 position;
+    memcpy(&position, view.sections[0].data, sizeof(Greet::Vec3));
+    view.bounds = Greet::AABB(position, position);
+    for(uint32_t i = 1; i < view.vertexCount; i++)
+    {
+      memcpy(&position, view.sections[0].data + i * sizeof(Greet::Vec3), sizeof(Greet::Vec3));
+      view.bounds.Expand(position);
+    }
+    return view;
+  }
+
+  MeshView ParseMesh(const char* data, size_t size, bool verifyChecksums)
+  {
+    if(size >= 4 && memcmp(data, SIGNATURE_V1, 4) == 0)
+      return ParseMeshV1(data, size);
+
+    if(size < HEADER_SIZE)
+      throw std::runtime_error("Could not read MESH file, file is too small to contain header.");
+    if(memcmp(data, SIGNATURE, 4) != 0)
+      throw std::runtime_error("Could not read MESH file, signature invalid.");
+    if(ReadU32(data + 4) != VERSION)
+      throw std::runtime_error("Could not read MESH file, unsupported version " + std::to_string(ReadU32(data + 4)));
+
+    // Later versions may extend the header, the section table always comes right after it
+    uint32_t headerSize = ReadU32(data + 8);
+    uint32_t sectionCount = ReadU32(data + 12);
+    if(headerSize < HEADER_SIZE || headerSize > size || sectionCount > (size - headerSize) / SECTION_ENTRY_SIZE)
+      throw std::runtime_error("Could not read MESH file, file is too small to contain section table");
+    const char* table = data + headerSize;
+    if(Crc32(table, sectionCount * SECTION_ENTRY_SIZE, Crc32(data, 48)) != ReadU32(data + 48))
+      throw std::runtime_error("Could not read MESH file, header checksum mismatch");
+
+    MeshView view;
+    view.vertexCount = ReadU32(data + 16);
+    view.indexCount = ReadU32(data + 20);
+    view.bounds = Greet::AABB(
+        Greet::Vec3(ReadFloat(data + 24), ReadFloat(data + 28), ReadFloat(data + 32)),
+        Greet::Vec3(ReadFloat(data + 36), ReadFloat(data + 40), ReadFloat(data + 44)));
+    size_t payloadOffset = AlignUp(headerSize + sectionCount * SECTION_ENTRY_SIZE);
+    if(payloadOffset > size)
+      throw std::runtime_error("Could not read MESH file, file is too small to contain section data");
+    view.payload = data + payloadOffset;
+    view.payloadSize = size - payloadOffset;
+
+    bool hasIndices = false;
+    bool hasLods = false;
+    view.sections.resize(sectionCount);
+    for(uint32_t i = 0; i < sectionCount; i++)
+    {
+      const char* entry = table + i * SECTION_ENTRY_SIZE;
+      Section& section = view.sections[i];
+      section.semantic = (Semantic)ReadU32(entry);
+      section.location = ReadU32(entry + 4);
+      section.format = (VkFormat)ReadU32(entry + 8);
+      section.stride = ReadU32(entry + 12);
+      section.offset = ReadU64(entry + 16);
+      section.size = ReadU64(entry + 24);
+      section.checksum = ReadU32(entry + 32);
+      section.encoding = (Encoding)ReadU32(entry + 36);
+
+      if(section.semantic > Semantic::Lod)
+        throw std::runtime_error("Could not read MESH file, unknown section semantic");
+      if(section.encoding > Encoding::DeltaVarint || (section.encoding != Encoding::None && section.semantic != Semantic::Index))
+        throw std::runtime_error("Could not read MESH file, invalid section encoding");
+      if(section.offset % SECTION_ALIGNMENT != 0 || section.offset > view.payloadSize || section.size > view.payloadSize - section.offset)
+        throw std::runtime_error("Could not read MESH file, section out of bounds");
+
+      uint64_t count = view.vertexCount;
+      if(section.semantic == Semantic::Index)
+      {
+        if(hasIndices)
+          throw std::runtime_error("Could not read MESH file, more than one index section");
+        if(section.stride != sizeof(uint16_t) && section.stride != sizeof(uint32_t))
+          throw std::runtime_error("Could not read MESH file, indices have to be 16 or 32 bits");
+        hasIndices = true;
+        count = view.indexCount;
+      }
+      else if(section.semantic == Semantic::Lod)
+      {
+        if(hasLods)
+          throw std::runtime_error("Could not read MESH file, more than one LOD table");
+        if(section.stride != LOD_ENTRY_SIZE || section.size == 0)
+          throw std::runtime_error("Could not read MESH file, invalid LOD table");
+        hasLods = true;
+        count = section.size / section.stride;
+      }
+      // Encoded sections are only checked when they are decoded
+      if(section.stride == 0 || (section.encoding == Encoding::None && section.size != section.stride * count))
+        throw std::runtime_error("Could not read MESH file, section size doesn't match its element count");
+
+      section.data = view.payload + section.offset;
+      if(verifyChecksums && Crc32(section.data, section.size) != section.checksum)
+        throw std::runtime_error("Could not read MESH file, section checksum mismatch");
+
+      for(uint64_t lod = 0; section.semantic == Semantic::Lod && lod < count; lod++)
+      {
+        const char* entry = section.data + lod * LOD_ENTRY_SIZE;
+        if((uint64_t)ReadU32(entry) + ReadU32(entry + 4) > view.indexCount)
+          throw std::runtime_error("Could not read MESH file, LOD out of bounds");
+      }
+    }
+    if(!hasIndices && view.indexCount != 0)
+      throw std::runtime_error("Could not read MESH file, index count without an index section");
+    return view;
+  }
+
+  const Section* MeshView::FindSection(Semantic semantic) const
+  {
+    for(const Section& section : sections)
+    {
+      if(section.semantic == semantic)
+        return &section;
+    }
+    return nullptr;
+  }
+
+  std::vector<Lod> MeshView::GetLods() const
+  {
+    const Section* section = FindSection(Semantic::Lod);
+    if(!section)
+      return {{0, indexCount, 0.0f}};
+
+    std::vector<Lod> lods(section->size / LOD_ENTRY_SIZE);
+    for(size_t i = 0; i < lods.size(); i++)
+    {
+      const char* entry = section->data + i * LOD_ENTRY_SIZE;
+      lods[i] = {ReadU32(entry), ReadU32(entry + 4), ReadFloat(entry + 8)};
+    }
+    return lods;
+  }
+
+  void MeshView::GetVertexInputDescriptions(std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription>& attributes) const
+  {
+    bindings.clear();
+    attributes.clear();
+    for(const Section& section : sections)
+    {
+      if(section.semantic == Semantic::Index || section.format == VK_FORMAT_UNDEFINED)
+        continue;
+
+      VkVertexInputBindingDescription binding = {};
+      binding.binding = bindings.size();
+      binding.stride = section.stride;
+      binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+      bindings.push_back(binding);
+
+      VkVertexInputAttributeDescription attribute = {};
+      attribute.binding = binding.binding;
+      attribute.location = section.location;
+      attribute.format = section.format;
+      attribute.offset = 0;
+      attributes.push_back(attribute);
+    }
+  }
+
+  MeshData ReadFromFile(const std::string& filename, bool optimize)
+  {
+    MappedMesh mesh(filename);
+    const MeshView& view = mesh.GetView();
+    const Section* positions = view.FindSection(Semantic::Position);
+    const Section* indices = view.FindSection(Semantic::Index);
+    if(!positions || positions->format != VK_FORMAT_R32G32B32_SFLOAT || positions->stride != sizeof(Greet::Vec3))
+      throw std::runtime_error("Could not read MESH file, no 32-bit float positions. Quantized meshes can only be drawn through MappedMesh");
+    if(!indices)
+      throw std::runtime_error("Could not read MESH file, no indices");
+
+    MeshData data(view.vertexCount, view.indexCount);
+    memcpy(data.vertices.get(), positions->data, positions->size);
+    DecodeIndices(*indices, view.indexCount, data.indices.get());
+    data.lods = view.GetLods();
+    if(optimize)
+    {
+      for(uint32_t i = 0; i < data.indexCount; i++)
+      {
+        if(data.indices[i] >= data.vertexCount)
+          throw std::runtime_error("Could not optimize MESH file, it has indices out of range");
+      }
+      Optimize(data, false);
+    }
+    return data;
+  }
+
+  void WriteToFile(const std::string& filename, const MeshView& mesh)
+  {
+    size_t tableSize = mesh.sections.size() * SECTION_ENTRY_SIZE;
+    size_t payloadOffset = AlignUp(HEADER_SIZE + tableSize);
+    std::vector<char> head(payloadOffset, 0);
+    char* table = head.data() + HEADER_SIZE;
+
+    uint64_t offset = 0;
+    for(size_t i = 0; i < mesh.sections.size(); i++)
+    {
+      const Section& section = mesh.sections[i];
+      uint64_t count = section.semantic == Semantic::Index ? mesh.indexCount : mesh.vertexCount;
+      uint64_t size = section.encoding == Encoding::None && section.semantic != Semantic::Lod ? section.stride * count : section.size;
+      char* entry = table + i * SECTION_ENTRY_SIZE;
+      WriteU32(entry, (uint32_t)section.semantic);
+      WriteU32(entry + 4, section.location);
+      WriteU32(entry + 8, section.format);
+      WriteU32(entry + 12, section.stride);
+      WriteU64(entry + 16, offset);
+      WriteU64(entry + 24, size);
+      WriteU32(entry + 32, Crc32(section.data, size));
+      WriteU32(entry + 36, (uint32_t)section.encoding);
+      offset = AlignUp(offset + size);
+    }
+
+    memcpy(head.data(), SIGNATURE, 4);
+    WriteU32(head.data() + 4, VERSION);
+    WriteU32(head.data() + 8, HEADER_SIZE);
+    WriteU32(head.data() + 12, mesh.sections.size());
+    WriteU32(head.data() + 16, mesh.vertexCount);
+    WriteU32(head.data() + 20, mesh.indexCount);
+    WriteFloat(head.data() + 24, mesh.bounds.min.x);
+    WriteFloat(head.data() + 28, mesh.bounds.min.y);
+    WriteFloat(head.data() + 32, mesh.bounds.min.z);
+    WriteFloat(head.data() + 36, mesh.bounds.max.x);
+    WriteFloat(head.data() + 40, mesh.bounds.max.y);
+    WriteFloat(head.data() + 44, mesh.bounds.max.z);
+    WriteU32(head.data() + 48, Crc32(table, tableSize, Crc32(head.data(), 48)));
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    if(!file.is_open())
+      throw std::runtime_error("Failed to open " + filename);
+    file.write(head.data(), head.size());
+
+    static const char padding[SECTION_ALIGNMENT] = {};
+    for(size_t i = 0; i < mesh.sections.size(); i++)
+    {
+      uint64_t size = ReadU64(table + i * SECTION_ENTRY_SIZE + 24);
+      file.write(mesh.sections[i].data, size);
+      // The last section isn't padded, the file ends with its data
+      if(i + 1 < mesh.sections.size())
+        file.write(padding, AlignUp(size) - size);
+    }
+    if(!file)
+      throw std::runtime_error("Failed to write " + filename);
+  }
+
+  void WriteToFile(const std::string& filename, const MeshData& mesh)
+  {
+    MeshView view;
+    view.vertexCount = mesh.vertexCount;
+    view.indexCount = mesh.indexCount;
+    view.bounds = Greet::AABB::FromPoints(mesh.vertices.get(), mesh.vertexCount);
+    view.sections.push_back({Semantic::Position, 0, VK_FORMAT_R32G32B32_SFLOAT, sizeof(Greet::Vec3), 0, 0, 0, (const char*)mesh.vertices.get()});
+    view.sections.push_back({Semantic::Index, 0, VK_FORMAT_UNDEFINED, sizeof(uint32_t), 0, 0, 0, (const char*)mesh.indices.get()});
+    std::vector<char> lods;
+    if(mesh.lods.size() > 1)
+    {
+      lods = EncodeLods(mesh.lods);
+      view.sections.push_back({Semantic::Lod, 0, VK_FORMAT_UNDEFINED, LOD_ENTRY_SIZE, 0, lods.size(), 0, lods.data()});
+    }
+    WriteToFile(filename, view);
+  }
+
+  std::vector<char> EncodeLods(const std::vector<Lod>& lods)
+  {
+    std::vector<char> data(lods.size() * LOD_ENTRY_SIZE, 0);
+    for(size_t i = 0; i < lods.size(); i++)
+    {
+      char* entry = data.data() + i * LOD_ENTRY_SIZE;
+      WriteU32(entry, lods[i].firstIndex);
+      WriteU32(entry + 4, lods[i].indexCount);
+      WriteFloat(entry + 8, lods[i].error);
+    }
+    return data;
+  }
+
+  size_t SelectLod(const std::vector<Lod>& lods, const Greet::AABB& bounds, const Greet::Mat4& modelView,
+      const Greet::Mat4& projection, float viewportHeight, float maxPixelError)
+  {
+    // The errors are measured at the point of the bounding sphere closest to the camera, which
+    // overestimates them for the rest of the mesh
+    Greet::Sphere sphere = Greet::Sphere::FromAABB(bounds);
+    Greet::Sphere viewSphere = sphere.Transform(modelView);
+    float distance = -viewSphere.center.z - viewSphere.radius;
+    if(distance <= 0)
+      return 0;
+
+    // elements[5] is the cotangent of half the vertical field of view
+    float scale = sphere.radius > 0 ? viewSphere.radius / sphere.radius : 1.0f;
+    float pixelsPerUnit = scale * projection.elements[5] * viewportHeight * 0.5f / distance;
+    size_t lod = 0;
+    while(lod + 1 < lods.size() && lods[lod + 1].error * pixelsPerUnit <= maxPixelError)
+      lod++;
+    return lod;
+  }
+}
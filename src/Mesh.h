@@ -1,128 +1,168 @@
-#include <string.h>
-#include <fstream>
+#pragma once
+
+#include "MappedFile.h"
+
+#include <vulkan/vulkan.h>
 #include <math/Maths.h>
 
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
 namespace Mesh
 {
-  struct MeshData
+  // Version 2 MESH files are laid out as
+  //   Header, 64 bytes
+  //     char signature[4] = "GMSH", uint32 version, uint32 headerSize, uint32 sectionCount,
+  //     uint32 vertexCount, uint32 indexCount, float boundsMin[3], float boundsMax[3],
+  //     uint32 headerChecksum, 12 reserved bytes
+  //   sectionCount section entries, 48 bytes each
+  //     uint32 semantic, uint32 location, uint32 format, uint32 stride, uint64 offset,
+  //     uint64 size, uint32 checksum, uint32 encoding, 8 reserved bytes
+  //   The section data, every section starts at a multiple of SECTION_ALIGNMENT
+  // All fields are fixed width and little-endian. Each section holds one attribute of every
+  // vertex, all of the indices or the LOD table, and the sections lie back to back at the end
+  // of the file.
+  // So the whole payload can be uploaded with one copy and every section bound at its
+  // offset into it. The header checksum is the CRC32 of the header fields before it followed by
+  // the section table, each section's checksum the CRC32 of its data. Padding isn't covered.
+  //
+  // A mesh with levels of detail has one LOD table section of LOD_ENTRY_SIZE byte entries
+  //   uint32 firstIndex, uint32 indexCount, float error, 4 reserved bytes
+  // Every level is a range of the index section and all of them share the vertices, indexCount
+  // in the header counts the indices of every level. Meshes without the table have one level.
+  //
+  // Version 1 files, the original "MESH" layout, can still be read:
+  //   "MESH", uint32_t vertexCount, uint32_t indexCount, size_t attributeCount
+  //   attributeCount * {uint32_t location, vertexValueSize, memoryValueSize, glType; bool normalized}
+  //   vertexCount * Vec3 positions
+  //   indexCount * uint32_t indices
+  //   memoryValueSize * vertexCount bytes for every attribute
+  // Its fields are packed, so none of its sections are guaranteed to be aligned.
+  static const uint32_t VERSION = 2;
+  static const size_t HEADER_SIZE = 64;
+  static const size_t SECTION_ENTRY_SIZE = 48;
+  // Covers the alignment of every vertex format and the largest minStorageBufferOffsetAlignment
+  static const size_t SECTION_ALIGNMENT = 256;
+  static const size_t LOD_ENTRY_SIZE = 16;
+
+  enum class Semantic : uint32_t
   {
-    Greet::Vec3* vertices;
-    uint32_t* indices;
-    uint32_t vertexCount;
+    Index, Position, Normal, Tangent, TexCoord, Color, Custom, Lod
+  };
+
+  // How a section's elements are stored in the file. Only index sections can be encoded, their
+  // stride is then the width of the decoded indices. See MeshCodec.h for the encodings.
+  enum class Encoding : uint32_t
+  {
+    None, DeltaVarint
+  };
+
+  // One stream of the mesh. Index sections have a stride of 2 or 4 bytes and no format, LOD
+  // tables one entry per level and no format, other sections hold one element of the given
+  // format per vertex.
+  struct Section
+  {
+    Semantic semantic;
+    uint32_t location;
+    VkFormat format;
+    uint32_t stride;
+    // From the start of the payload, a multiple of SECTION_ALIGNMENT in version 2 files
+    uint64_t offset;
+    uint64_t size;
+    uint32_t checksum;
+    const char* data;
+    Encoding encoding = Encoding::None;
+  };
+
+  // One level of detail, levels are sorted from the full mesh to the coarsest. The error
+  // estimates how far in mesh units the level's surface is from the full mesh.
+  struct Lod
+  {
+    uint32_t firstIndex;
     uint32_t indexCount;
+    float error;
+  };
+
+  // Sections of a MESH file in memory, points into the parsed buffer and doesn't own anything.
+  // Also describes the mesh to write with WriteToFile.
+  struct MeshView
+  {
+    std::vector<Section> sections;
+    uint32_t vertexCount = 0;
+    uint32_t indexCount = 0;
+    Greet::AABB bounds;
+    const char* payload = nullptr;
+    size_t payloadSize = 0;
+
+    // The first section with the semantic, nullptr if the mesh has none
+    const Section* FindSection(Semantic semantic) const;
 
-    MeshData(Greet::Vec3* vertices, uint32_t vertexCount, uint32_t* indices, uint32_t indexCount)
-      : vertices{vertices}, vertexCount{vertexCount}, indices{indices}, indexCount{indexCount}
-    {
-    
-    }
+    // The levels of the LOD table, or a single level with all indices if the mesh has none
+    std::vector<Lod> GetLods() const;
+
+    // One binding per vertex section, bound at the section's offset into the uploaded payload
+    void GetVertexInputDescriptions(std::vector<VkVertexInputBindingDescription>& bindings, std::vector<VkVertexInputAttributeDescription>& attributes) const;
   };
 
-  static MeshData ReadFromFile(const std::string& filename)
+  // Positions and 32-bit indices copied out of a mesh, only meshes with 32-bit float positions
+  // can be read this way. The indices hold every level of detail.
+  struct MeshData
   {
-    using namespace Greet;
-    // Small buffer for initial stuffs
-    char buffer[1024];
-    std::ifstream fin(filename);
-
-    // Determine size of the file and reset to beginning.
-    int fileSize = fin.tellg();
-    fin.seekg(0,std::ios::end);
-    fileSize = (uint32_t)fin.tellg() - fileSize;
-    fin.seekg(0,std::ios::beg);
-
-    // Check if the file is big enough to contain signature, vertex count, index count and attribute count
-    fileSize -= 4 * sizeof(char) + 2 * sizeof(uint32_t) + sizeof(size_t);
-    if(fileSize < 0)
-    {
-      throw std::runtime_error("Could not read MESH file, file is too small to contain signature.");
-    }
-
-    // Read signature
-    fin.read(buffer, 4 * sizeof(char));
-
-    if(std::string(buffer, 4) != "MESH")
-    {
-      throw std::runtime_error("Could not read MESH file, signature invalid.");
-    }
-    // Read how many attributes we have. 
+    std::unique_ptr<Greet::Vec3[]> vertices;
+    std::unique_ptr<uint32_t[]> indices;
     uint32_t vertexCount;
-    fin.read((char*)&vertexCount,sizeof(uint32_t));
-    fileSize -= vertexCount * sizeof(Vec3);
-    if(fileSize < 0)
-    {
-      throw std::runtime_error("Could not read MESH file, file is too small to contain vertex data");
-    }
-    if(vertexCount == 0)
-      throw std::runtime_error("VertexCount is 0");
-
-    // Read how many attributes we have. 
     uint32_t indexCount;
-    fin.read((char*)&indexCount,sizeof(uint32_t));
-    fileSize -= indexCount * sizeof(uint32_t);
-    if(fileSize < 0)
-    {
-      throw std::runtime_error("Could not read MESH file, file is too small to contain vertex data");
-    }
-    if(indexCount == 0)
-      throw std::runtime_error("IndexCount is 0");
-
-    // Read how many attributes we have. 
-    size_t attributeCount;
-    fin.read((char*)&attributeCount,sizeof(size_t));
-
-    // Check if the file is big enough to contain attribute parameters.
-    int attribLength = (sizeof(uint32_t) * 4 + sizeof(bool));
-    int attribsLength = attributeCount * attribLength; 
-
-    // Remove attribLength from fileSize to easier check sizes later.
-    fileSize -= attribsLength;
-
-    if(fileSize < 0)
-    {
-      throw std::runtime_error("Could not read MESH file, file is too small to contain attribute parameters");
-    }
-
-    if(attribLength > 1024)
-    {
-      throw std::runtime_error("Could not read MESH file, too many attributes.");
-    }
-    fin.read(buffer,attribsLength);
-
-    const char* pointer = buffer;
-    for(size_t i = 0;i<attributeCount;i++)
-    {
-      // Read uints
-      uint32_t location = ((uint*)pointer)[0];
-      uint32_t vertexValueSize = ((uint*)pointer)[1];
-      uint32_t memoryValueSize = ((uint*)pointer)[2];
-      uint32_t glType = ((uint*)pointer)[3];
-
-      // Move pointer
-      pointer += sizeof(uint32_t)*4;
-
-      // Read bool
-      bool normalized = ((bool*)buffer)[0];
-
-      // Move pointer
-      pointer += sizeof(bool);
-
-      fileSize -= memoryValueSize * vertexCount;
-      if(fileSize < 0)
-      {
-        throw std::runtime_error("Could not read MESH file, file is too small to contain attribute data");
-      }
-    }
-
-    // Read vertices
-    Vec3* vertices = new Vec3[vertexCount];
-    fin.read((char*)vertices,vertexCount*sizeof(Vec3));
-
-    // Read indices 
-    uint32_t* indices = new uint32_t[indexCount];
-    fin.read((char*)indices,indexCount*sizeof(uint32_t));
-
-    return {vertices, vertexCount, indices, indexCount};
-  }
+    std::vector<Lod> lods;
+
+    MeshData(uint32_t vertexCount, uint32_t indexCount)
+      : vertices{new Greet::Vec3[vertexCount]}, indices{new uint32_t[indexCount]}, vertexCount{vertexCount}, indexCount{indexCount},
+      lods{{0, indexCount, 0.0f}}
+    {}
+  };
+
+  uint32_t Crc32(const char* data, size_t size, uint32_t crc = 0);
+
+  // Validates the header and section table against the size of the buffer once, so that the
+  // sections can be read afterwards without any further checks. Checking the sections'
+  // checksums reads the whole file, skip it for trusted files where load time matters.
+  MeshView ParseMesh(const char* data, size_t size, bool verifyChecksums = true);
+
+  // MESH file mapped into memory, the sections point straight into the mapping so they can be
+  // copied into staging memory without an intermediate copy. The mapping is page aligned, so
+  // the sections of version 2 files can be cast to their element types.
+  class MappedMesh
+  {
+    private:
+      MappedFile file;
+      MeshView view;
+
+    public:
+      explicit MappedMesh(const std::string& filename, bool verifyChecksums = true)
+        : file{filename}, view{ParseMesh(file.GetData(), file.GetSize(), verifyChecksums)}
+      {}
+
+      const MeshView& GetView() const { return view; }
+  };
+
+  // Copies the positions and indices out of the file, use MappedMesh to avoid the copy.
+  // Optimizing reorders them for the vertex cache while loading, for meshes that weren't
+  // optimized offline.
+  MeshData ReadFromFile(const std::string& filename, bool optimize = false);
+
+  // Always writes version 2, the sections' offset, size and checksum are computed. Only encoded
+  // sections and LOD tables need their size set, as it can't be derived from the element count.
+  void WriteToFile(const std::string& filename, const MeshView& mesh);
+  void WriteToFile(const std::string& filename, const MeshData& mesh);
+
+  // Data of a LOD table section for the levels
+  std::vector<char> EncodeLods(const std::vector<Lod>& lods);
 
+  // Picks the coarsest level whose error projected on the screen is at most maxPixelError pixels
+  // tall. The bounds are the mesh's, modelView takes them into view space where the camera looks
+  // down -z as with Mat4::LookAt, and projection is a Mat4::ProjectionMatrix.
+  size_t SelectLod(const std::vector<Lod>& lods, const Greet::AABB& bounds, const Greet::Mat4& modelView,
+      const Greet::Mat4& projection, float viewportHeight, float maxPixelError = 1.0f);
 }
@@ -0,0 +1,326 @@
+#include "MeshCodec.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+
+namespace Mesh
+{
+  static const float UNORM16_MAX = 65535.0f;
+  static const float SNORM16_MAX = 32767.0f;
+
+  Greet::Mat4 GetDequantizationMatrix(const Greet::AABB& bounds)
+  {
+    return Greet::Mat4::Translate(bounds.min) * Greet::Mat4::Scale(bounds.max - bounds.min);
+  }
+
+  Greet::Vec3 GetQuantizationError(const Greet::AABB& bounds)
+  {
+    return (bounds.max - bounds.min) / (2.0f * UNORM16_MAX);
+  }
+
+  static uint16_t QuantizeUnorm16(float value, float min, float scale)
+  {
+    float quantized = (value - min) * scale + 0.5f;
+    return (uint16_t)std::min(std::max(quantized, 0.0f), UNORM16_MAX);
+  }
+
+  void QuantizePositions(const Greet::Vec3* positions, size_t count, const Greet::AABB& bounds, uint16_t* out)
+  {
+    // Flat axes have no extent to divide by, all their positions become 0
+    Greet::Vec3 extent = bounds.max - bounds.min;
+    Greet::Vec3 scale(
+        extent.x > 0 ? UNORM16_MAX / extent.x : 0,
+        extent.y > 0 ? UNORM16_MAX / extent.y : 0,
+        extent.z > 0 ? UNORM16_MAX / extent.z : 0);
+    for(size_t i = 0; i < count; i++)
+    {
+      out[i * 4 + 0] = QuantizeUnorm16(positions[i].x, bounds.min.x, scale.x);
+      out[i * 4 + 1] = QuantizeUnorm16(positions[i].y, bounds.min.y, scale.y);
+      out[i * 4 + 2] = QuantizeUnorm16(positions[i].z, bounds.min.z, scale.z);
+      out[i * 4 + 3] = 0;
+    }
+  }
+
+  Greet::Vec3 DequantizePosition(const uint16_t* quantized, const Greet::AABB& bounds)
+  {
+    Greet::Vec3 extent = bounds.max - bounds.min;
+    return Greet::Vec3(
+        bounds.min.x + quantized[0] / UNORM16_MAX * extent.x,
+        bounds.min.y + quantized[1] / UNORM16_MAX * extent.y,
+        bounds.min.z + quantized[2] / UNORM16_MAX * extent.z);
+  }
+
+  static float SignNotZero(float value)
+  {
+    return value >= 0.0f ? 1.0f : -1.0f;
+  }
+
+  // The same decoding as in res/shaders/quantized.vert
+  static Greet::Vec3 DecodeOctahedral(float x, float y)
+  {
+    Greet::Vec3 normal(x, y, 1.0f - std::abs(x) - std::abs(y));
+    float fold = std::max(-normal.z, 0.0f);
+    normal.x -= fold * SignNotZero(normal.x);
+    normal.y -= fold * SignNotZero(normal.y);
+    return normal.Normalize();
+  }
+
+  static float DecodeSnorm16(int16_t value)
+  {
+    return std::max(value / SNORM16_MAX, -1.0f);
+  }
+
+  void EncodeNormals(const Greet::Vec3* normals, size_t count, int16_t* out)
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      // Project onto the octahedron |x| + |y| + |z| = 1 and fold the lower half over the upper
+      const Greet::Vec3& normal = normals[i];
+      float length = std::abs(normal.x) + std::abs(normal.y) + std::abs(normal.z);
+      float x = length > 0 ? normal.x / length : 0;
+      float y = length > 0 ? normal.y / length : 0;
+      if(normal.z < 0)
+      {
+        float foldedX = (1.0f - std::abs(y)) * SignNotZero(x);
+        y = (1.0f - std::abs(x)) * SignNotZero(y);
+        x = foldedX;
+      }
+
+      // Rounding each component on its own isn't always closest after decoding, so try all
+      // four neighbours of the grid and keep the best
+      float baseX = std::floor(x * SNORM16_MAX);
+      float baseY = std::floor(y * SNORM16_MAX);
+      float bestDot = -2.0f;
+      for(int offset = 0; offset < 4; offset++)
+      {
+        float candidateX = std::min(std::max(baseX + (offset & 1), -SNORM16_MAX), SNORM16_MAX);
+        float candidateY = std::min(std::max(baseY + (offset >> 1), -SNORM16_MAX), SNORM16_MAX);
+        float dot = DecodeOctahedral(candidateX / SNORM16_MAX, candidateY / SNORM16_MAX).Dot(normal);
+        if(dot > bestDot)
+        {
+          bestDot = dot;
+          out[i * 2 + 0] = (int16_t)candidateX;
+          out[i * 2 + 1] = (int16_t)candidateY;
+        }
+      }
+    }
+  }
+
+  Greet::Vec3 DecodeNormal(const int16_t* encoded)
+  {
+    return DecodeOctahedral(DecodeSnorm16(encoded[0]), DecodeSnorm16(encoded[1]));
+  }
+
+  uint16_t FloatToHalf(float value)
+  {
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(float));
+    uint32_t sign = (bits >> 16) & 0x8000;
+    int exponent = (int)((bits >> 23) & 0xFF) - 127 + 15;
+    uint32_t mantissa = bits & 0x7FFFFF;
+
+    // Infinity and NaN, NaN keeps a mantissa bit so that it stays NaN
+    if(exponent == 128 + 15)
+      return sign | 0x7C00 | (mantissa ? 0x200 : 0);
+    if(exponent >= 31)
+      return sign | 0x7C00;
+
+    // Subnormal halfs have no implicit leading one, so it is shifted into the mantissa
+    uint32_t shift = 13;
+    uint32_t half;
+    if(exponent > 0)
+      half = ((uint32_t)exponent << 10) | (mantissa >> 13);
+    else
+    {
+      if(exponent < -10)
+        return sign;
+      mantissa |= 0x800000;
+      shift = 14 - exponent;
+      half = mantissa >> shift;
+    }
+
+    // Round to nearest even, a carry out of the mantissa correctly bumps the exponent
+    uint32_t remainder = mantissa & ((1u << shift) - 1);
+    uint32_t halfway = 1u << (shift - 1);
+    if(remainder > halfway || (remainder == halfway && (half & 1)))
+      half++;
+    return sign | half;
+  }
+
+  float HalfToFloat(uint16_t value)
+  {
+    uint32_t sign = (uint32_t)(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1F;
+    uint32_t mantissa = value & 0x3FF;
+
+    uint32_t bits;
+    if(exponent == 0)
+    {
+      float result = std::ldexp((float)mantissa, -24);
+      return sign ? -result : result;
+    }
+    if(exponent == 31)
+      bits = sign | 0x7F800000 | (mantissa << 13);
+    else
+      bits = sign | ((exponent - 15 + 127) << 23) | (mantissa << 13);
+
+    float result;
+    memcpy(&result, &bits, sizeof(float));
+    return result;
+  }
+
+  void EncodeTexCoords(const Greet::Vec2* texCoords, size_t count, uint16_t* out)
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      out[i * 2 + 0] = FloatToHalf(texCoords[i].x);
+      out[i * 2 + 1] = FloatToHalf(texCoords[i].y);
+    }
+  }
+
+  std::vector<char> EncodeIndices(const uint32_t* indices, size_t count)
+  {
+    std::vector<char> encoded;
+    encoded.reserve(count * 2);
+    uint32_t previous = 0;
+    for(size_t i = 0; i < count; i++)
+    {
+      // The difference wraps around, decoding wraps it back the same way
+      int32_t delta = (int32_t)(indices[i] - previous);
+      uint32_t zigzag = ((uint32_t)delta << 1) ^ (uint32_t)(delta >> 31);
+      while(zigzag >= 0x80)
+      {
+        encoded.push_back((char)(zigzag | 0x80));
+        zigzag >>= 7;
+      }
+      encoded.push_back((char)zigzag);
+      previous = indices[i];
+    }
+    return encoded;
+  }
+
+  template <typename T>
+  static void DecodeIndicesTo(const Section& section, uint32_t count, T* out)
+  {
+    const unsigned char* data = (const unsigned char*)section.data;
+    const unsigned char* end = data + section.size;
+    uint32_t maxIndex = 0;
+
+    if(section.encoding == Encoding::None && section.stride == sizeof(T))
+    {
+      memcpy(out, data, count * sizeof(T));
+      return;
+    }
+    if(section.encoding == Encoding::None)
+    {
+      for(uint32_t i = 0; i < count; i++)
+      {
+        uint32_t index = 0;
+        if(section.stride == sizeof(uint16_t))
+        {
+          uint16_t index16;
+          memcpy(&index16, data + i * sizeof(uint16_t), sizeof(uint16_t));
+          index = index16;
+        }
+        else
+          memcpy(&index, data + i * sizeof(uint32_t), sizeof(uint32_t));
+        maxIndex = std::max(maxIndex, index);
+        out[i] = (T)index;
+      }
+    }
+    else
+    {
+      uint32_t previous = 0;
+      for(uint32_t i = 0; i < count; i++)
+      {
+        uint32_t zigzag = 0;
+        for(uint32_t shift = 0;; shift += 7)
+        {
+          if(data == end || shift > 28)
+            throw std::runtime_error("Could not decode MESH indices, data is truncated or invalid");
+          uint32_t byte = *data++;
+          zigzag |= (byte & 0x7F) << shift;
+          if(byte < 0x80)
+            break;
+        }
+        previous += (zigzag >> 1) ^ (0 - (zigzag & 1));
+        maxIndex = std::max(maxIndex, previous);
+        out[i] = (T)previous;
+      }
+      if(data != end)
+        throw std::runtime_error("Could not decode MESH indices, data has trailing bytes");
+    }
+
+    if(sizeof(T) < sizeof(uint32_t) && maxIndex > UINT16_MAX)
+      throw std::runtime_error("Could not decode MESH indices, indices don't fit in 16 bits");
+  }
+
+  void DecodeIndices(const Section& section, uint32_t count, uint32_t* out)
+  {
+    DecodeIndicesTo(section, count, out);
+  }
+
+  void DecodeIndices(const Section& section, uint32_t count, uint16_t* out)
+  {
+    DecodeIndicesTo(section, count, out);
+  }
+
+  MeshView QuantizedMesh::GetView() const
+  {
+    MeshView view;
+    view.vertexCount = vertexCount;
+    view.indexCount = indexCount;
+    view.bounds = bounds;
+    view.sections.push_back({Semantic::Position, 0, VK_FORMAT_R16G16B16A16_UNORM, 4 * sizeof(uint16_t), 0, 0, 0, (const char*)positions.data()});
+    if(!normals.empty())
+      view.sections.push_back({Semantic::Normal, 1, VK_FORMAT_R16G16_SNORM, 2 * sizeof(int16_t), 0, 0, 0, (const char*)normals.data()});
+    if(!texCoords.empty())
+      view.sections.push_back({Semantic::TexCoord, 2, VK_FORMAT_R16G16_SFLOAT, 2 * sizeof(uint16_t), 0, 0, 0, (const char*)texCoords.data()});
+    view.sections.push_back({Semantic::Index, 0, VK_FORMAT_UNDEFINED, indexStride, 0, indices.size(), 0, indices.data(), indexEncoding});
+    return view;
+  }
+
+  QuantizedMesh Quantize(const Greet::Vec3* positions, const Greet::Vec3* normals, const Greet::Vec2* texCoords, uint32_t vertexCount,
+      const uint32_t* indices, uint32_t indexCount, bool encodeIndices)
+  {
+    QuantizedMesh mesh;
+    mesh.vertexCount = vertexCount;
+    mesh.indexCount = indexCount;
+    mesh.bounds = Greet::AABB::FromPoints(positions, vertexCount);
+
+    mesh.positions.resize(vertexCount * 4);
+    QuantizePositions(positions, vertexCount, mesh.bounds, mesh.positions.data());
+    if(normals)
+    {
+      mesh.normals.resize(vertexCount * 2);
+      EncodeNormals(normals, vertexCount, mesh.normals.data());
+    }
+    if(texCoords)
+    {
+      mesh.texCoords.resize(vertexCount * 2);
+      EncodeTexCoords(texCoords, vertexCount, mesh.texCoords.data());
+    }
+
+    uint32_t maxIndex = 0;
+    for(uint32_t i = 0; i < indexCount; i++)
+      maxIndex = std::max(maxIndex, indices[i]);
+    mesh.indexStride = maxIndex <= UINT16_MAX ? sizeof(uint16_t) : sizeof(uint32_t);
+    mesh.indexEncoding = encodeIndices ? Encoding::DeltaVarint : Encoding::None;
+    if(encodeIndices)
+      mesh.indices = EncodeIndices(indices, indexCount);
+    else if(mesh.indexStride == sizeof(uint16_t))
+    {
+      mesh.indices.resize(indexCount * sizeof(uint16_t));
+      for(uint32_t i = 0; i < indexCount; i++)
+      {
+        uint16_t index = indices[i];
+        memcpy(mesh.indices.data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+      }
+    }
+    else
+      mesh.indices.assign((const char*)indices, (const char*)(indices + indexCount));
+    return mesh;
+  }
+}
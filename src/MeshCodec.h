@@ -0,0 +1,72 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <math/Maths.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compact vertex and index encodings for MESH files. A quantized vertex is 16 bytes instead of
+// the 32 bytes of float positions, normals and texture coordinates:
+//   position  R16G16B16A16_UNORM within the mesh bounds, 8 bytes
+//   normal    R16G16_SNORM octahedral, 4 bytes
+//   texCoord  R16G16_SFLOAT, 4 bytes
+// All three formats are required to be supported as vertex input, so the vertex shader gets
+// the positions in [0, 1] and the texture coordinates as floats for free. The positions are
+// mapped back into the bounds by GetDequantizationMatrix, the normals are decoded in
+// res/shaders/quantized.vert.
+namespace Mesh
+{
+  // Maps unorm positions in [0, 1] back into the bounds, put it right of the model matrix
+  Greet::Mat4 GetDequantizationMatrix(const Greet::AABB& bounds);
+
+  // Largest error of a quantized position along each axis, half a step of the 16-bit grid. Float
+  // rounding while quantizing and dequantizing can add a fraction of a percent to it.
+  Greet::Vec3 GetQuantizationError(const Greet::AABB& bounds);
+
+  // Four values per position, the fourth is unused padding so that the format is supported
+  void QuantizePositions(const Greet::Vec3* positions, size_t count, const Greet::AABB& bounds, uint16_t* out);
+  Greet::Vec3 DequantizePosition(const uint16_t* quantized, const Greet::AABB& bounds);
+
+  // Unit normals folded onto an octahedron and stored as two snorm values
+  void EncodeNormals(const Greet::Vec3* normals, size_t count, int16_t* out);
+  Greet::Vec3 DecodeNormal(const int16_t* encoded);
+
+  // IEEE half floats, rounded to nearest even
+  uint16_t FloatToHalf(float value);
+  float HalfToFloat(uint16_t value);
+  void EncodeTexCoords(const Greet::Vec2* texCoords, size_t count, uint16_t* out);
+
+  // Encoding::DeltaVarint stores every index as the zigzag encoded difference to the previous
+  // index in LEB128 varints, so indices close to their predecessor take a single byte. That is
+  // most of them after the vertex cache optimization.
+  std::vector<char> EncodeIndices(const uint32_t* indices, size_t count);
+
+  // Indices of any index section, decoded and widened or narrowed. Narrowing throws if an index
+  // doesn't fit in 16 bits.
+  void DecodeIndices(const Section& section, uint32_t count, uint32_t* out);
+  void DecodeIndices(const Section& section, uint32_t count, uint16_t* out);
+
+  // Owns the encoded streams of a mesh, GetView describes them for WriteToFile
+  struct QuantizedMesh
+  {
+    uint32_t vertexCount;
+    uint32_t indexCount;
+    Greet::AABB bounds;
+    std::vector<uint16_t> positions;
+    std::vector<int16_t> normals;
+    std::vector<uint16_t> texCoords;
+    // 16-bit if every index fits, otherwise 32-bit, and optionally DeltaVarint encoded
+    uint32_t indexStride;
+    Encoding indexEncoding;
+    std::vector<char> indices;
+
+    MeshView GetView() const;
+  };
+
+  // Normals and texCoords may be nullptr to leave out their streams
+  QuantizedMesh Quantize(const Greet::Vec3* positions, const Greet::Vec3* normals, const Greet::Vec2* texCoords, uint32_t vertexCount,
+      const uint32_t* indices, uint32_t indexCount, bool encodeIndices);
+}
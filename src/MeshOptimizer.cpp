@@ -0,0 +1,556 @@
+#include "MeshOptimizer.h"
+
+#include "MeshCodec.h"
+#include "MeshSimplifier.h"
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+
+namespace Mesh
+{
+  // Indices per range of the parallel cache optimization, a multiple of 3
+  static const size_t PARALLEL_BATCH_SIZE = 3 << 16;
+
+  // The LRU cache that Forsyth's scores model and the valence up to which the scores are tabled
+  static const uint32_t FORSYTH_CACHE_SIZE = 32;
+  static const uint32_t FORSYTH_MAX_VALENCE = 32;
+
+  // Vertices used by the last triangle get a fixed score, so that the next triangle doesn't
+  // just continue the strip, older vertices score less the further back they are. Vertices with
+  // few triangles left are boosted so that no lone triangles are left behind.
+  struct ForsythScores
+  {
+    float cache[FORSYTH_CACHE_SIZE];
+    float valence[FORSYTH_MAX_VALENCE];
+
+    ForsythScores()
+    {
+      for(uint32_t i = 0; i < FORSYTH_CACHE_SIZE; i++)
+        cache[i] = i < 3 ? 0.75f : std::pow(1.0f - (i - 3) / (float)(FORSYTH_CACHE_SIZE - 3), 1.5f);
+      valence[0] = 0;
+      for(uint32_t i = 1; i < FORSYTH_MAX_VALENCE; i++)
+        valence[i] = 2.0f / std::sqrt((float)i);
+    }
+
+    float Score(int32_t cachePosition, uint32_t remaining) const
+    {
+      if(remaining == 0)
+        return 0;
+      float score = cachePosition < 0 ? 0 : cache[cachePosition];
+      return score + valence[std::min(remaining, FORSYTH_MAX_VALENCE - 1)];
+    }
+  };
+
+  VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize)
+  {
+    // A vertex is in the FIFO cache if fewer than cacheSize misses happened since it was added
+    std::vector<uint32_t> timestamps(vertexCount, 0);
+    std::vector<uint8_t> used(vertexCount, 0);
+    uint32_t time = cacheSize + 1;
+    size_t misses = 0;
+    size_t usedCount = 0;
+    for(size_t i = 0; i < indexCount; i++)
+    {
+      uint32_t vertex = indices[i];
+      if(time - timestamps[vertex] > cacheSize)
+      {
+        timestamps[vertex] = time++;
+        misses++;
+      }
+      usedCount += used[vertex] ^ 1;
+      used[vertex] = 1;
+    }
+
+    VertexCacheStatistics statistics;
+    statistics.acmr = indexCount ? misses / (float)(indexCount / 3) : 0;
+    statistics.atvr = usedCount ? misses / (float)usedCount : 0;
+    return statistics;
+  }
+
+  static void OptimizeVertexCacheRange(uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+  {
+    static const ForsythScores scores;
+    // Trailing indices that don't form a whole triangle are left where they are
+    size_t triangleCount = indexCount / 3;
+    indexCount = triangleCount * 3;
+
+    // The triangles of every vertex, the ones that are still to be emitted are kept at the
+    // front of each list
+    std::vector<uint32_t> adjacencyStarts(vertexCount + 1, 0);
+    for(size_t i = 0; i < indexCount; i++)
+      adjacencyStarts[indices[i] + 1]++;
+    for(uint32_t i = 0; i < vertexCount; i++)
+      adjacencyStarts[i + 1] += adjacencyStarts[i];
+    std::vector<uint32_t> remaining(vertexCount);
+    for(uint32_t i = 0; i < vertexCount; i++)
+      remaining[i] = adjacencyStarts[i + 1] - adjacencyStarts[i];
+    std::vector<uint32_t> adjacency(indexCount);
+    std::vector<uint32_t> adjacencyEnds(adjacencyStarts.begin(), adjacencyStarts.end() - 1);
+    for(size_t i = 0; i < indexCount; i++)
+      adjacency[adjacencyEnds[indices[i]]++] = i / 3;
+
+    std::vector<float> vertexScores(vertexCount);
+    for(uint32_t i = 0; i < vertexCount; i++)
+      vertexScores[i] = scores.Score(-1, remaining[i]);
+    std::vector<float> triangleScores(triangleCount);
+    for(size_t i = 0; i < triangleCount; i++)
+      triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+
+    std::vector<uint8_t> emitted(triangleCount, 0);
+    std::vector<uint32_t> output(indexCount);
+    uint32_t cache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t newCache[FORSYTH_CACHE_SIZE + 3];
+    uint32_t cacheCount = 0;
+    size_t deadEndCursor = 0;
+    int64_t best = -1;
+
+    for(size_t outputTriangle = 0; outputTriangle < triangleCount; outputTriangle++)
+    {
+      // No triangle touches the cache anymore, continue with the next one in the input
+      if(best < 0)
+      {
+        while(emitted[deadEndCursor])
+          deadEndCursor++;
+        best = deadEndCursor;
+      }
+
+      const uint32_t* triangle = indices + best * 3;
+      emitted[best] = 1;
+      uint32_t newCacheCount = 0;
+      for(int i = 0; i < 3; i++)
+      {
+        uint32_t vertex = triangle[i];
+        output[outputTriangle * 3 + i] = vertex;
+
+        // Degenerate triangles list a vertex twice, it is only removed once each time
+        uint32_t* first = adjacency.data() + adjacencyStarts[vertex];
+        uint32_t* last = first + remaining[vertex];
+        uint32_t* found = std::find(first, last, (uint32_t)best);
+        if(found != last)
+        {
+          *found = *(last - 1);
+          remaining[vertex]--;
+        }
+
+        if(std::find(newCache, newCache + newCacheCount, vertex) == newCache + newCacheCount)
+          newCache[newCacheCount++] = vertex;
+      }
+      uint32_t triangleVertexCount = newCacheCount;
+      for(uint32_t i = 0; i < cacheCount; i++)
+      {
+        if(std::find(newCache, newCache + triangleVertexCount, cache[i]) == newCache + triangleVertexCount)
+          newCache[newCacheCount++] = cache[i];
+      }
+
+      // Rescore the cached vertices, including the ones that just fell out, and pass the change
+      // on to their remaining triangles
+      for(uint32_t i = 0; i < newCacheCount; i++)
+      {
+        uint32_t vertex = newCache[i];
+        int32_t position = i < FORSYTH_CACHE_SIZE ? i : -1;
+        float score = scores.Score(position, remaining[vertex]);
+        float delta = score - vertexScores[vertex];
+        vertexScores[vertex] = score;
+        const uint32_t* adjacent = adjacency.data() + adjacencyStarts[vertex];
+        for(uint32_t j = 0; j < remaining[vertex]; j++)
+          triangleScores[adjacent[j]] += delta;
+      }
+
+      cacheCount = std::min(newCacheCount, FORSYTH_CACHE_SIZE);
+      std::copy(newCache, newCache + cacheCount, cache);
+      best = -1;
+      float bestScore = -1;
+      for(uint32_t i = 0; i < cacheCount; i++)
+      {
+        uint32_t vertex = cache[i];
+        const uint32_t* adjacent = adjacency.data() + adjacencyStarts[vertex];
+        for(uint32_t j = 0; j < remaining[vertex]; j++)
+        {
+          if(triangleScores[adjacent[j]] > bestScore)
+          {
+            bestScore = triangleScores[adjacent[j]];
+            best = adjacent[j];
+          }
+        }
+      }
+    }
+    std::copy(output.begin(), output.end(), indices);
+  }
+
+  // Orders the triangles breadth first through shared vertices, so that consecutive triangles
+  // are close on the surface whatever the order of the input was
+  static void OrderTrianglesBreadthFirst(uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+  {
+    size_t triangleCount = indexCount / 3;
+    std::vector<uint32_t> adjacencyStarts(vertexCount + 1, 0);
+    for(size_t i = 0; i < triangleCount * 3; i++)
+      adjacencyStarts[indices[i] + 1]++;
+    for(uint32_t i = 0; i < vertexCount; i++)
+      adjacencyStarts[i + 1] += adjacencyStarts[i];
+    std::vector<uint32_t> adjacency(triangleCount * 3);
+    std::vector<uint32_t> adjacencyEnds(adjacencyStarts.begin(), adjacencyStarts.end() - 1);
+    for(size_t i = 0; i < triangleCount * 3; i++)
+      adjacency[adjacencyEnds[indices[i]]++] = i / 3;
+
+    // The order itself is the queue, every triangle is added once when it is first reached
+    std::vector<uint8_t> visited(triangleCount, 0);
+    std::vector<uint32_t> order;
+    order.reserve(triangleCount);
+    for(size_t seed = 0; seed < triangleCount; seed++)
+    {
+      if(visited[seed])
+        continue;
+      visited[seed] = 1;
+      order.push_back(seed);
+      for(size_t next = order.size() - 1; next < order.size(); next++)
+      {
+        const uint32_t* triangle = indices + order[next] * 3;
+        for(int i = 0; i < 3; i++)
+        {
+          for(uint32_t j = adjacencyStarts[triangle[i]]; j < adjacencyStarts[triangle[i] + 1]; j++)
+          {
+            uint32_t adjacent = adjacency[j];
+            if(!visited[adjacent])
+            {
+              visited[adjacent] = 1;
+              order.push_back(adjacent);
+            }
+          }
+        }
+      }
+    }
+
+    std::vector<uint32_t> output(triangleCount * 3);
+    for(size_t i = 0; i < triangleCount; i++)
+      std::copy(indices + order[i] * 3, indices + order[i] * 3 + 3, output.begin() + i * 3);
+    std::copy(output.begin(), output.end(), indices);
+  }
+
+  void OptimizeVertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount, ThreadPool* pool)
+  {
+    if(!pool || indexCount < PARALLEL_THRESHOLD)
+    {
+      OptimizeVertexCacheRange(indices, indexCount, vertexCount);
+      return;
+    }
+
+    // The ranges only keep their locality if their triangles are close together already. Every
+    // range is renumbered to the vertices it uses, so that its arrays stay small.
+    OrderTrianglesBreadthFirst(indices, indexCount, vertexCount);
+    size_t rangeCount = (indexCount + PARALLEL_BATCH_SIZE - 1) / PARALLEL_BATCH_SIZE;
+    pool->ParallelFor(rangeCount, 1, [&](size_t begin, size_t end)
+    {
+      for(size_t range = begin; range < end; range++)
+      {
+        uint32_t* rangeIndices = indices + range * PARALLEL_BATCH_SIZE;
+        size_t count = std::min(PARALLEL_BATCH_SIZE, indexCount - range * PARALLEL_BATCH_SIZE);
+        std::vector<uint32_t> vertices(rangeIndices, rangeIndices + count);
+        std::sort(vertices.begin(), vertices.end());
+        vertices.erase(std::unique(vertices.begin(), vertices.end()), vertices.end());
+        for(size_t i = 0; i < count; i++)
+          rangeIndices[i] = std::lower_bound(vertices.begin(), vertices.end(), rangeIndices[i]) - vertices.begin();
+
+        OptimizeVertexCacheRange(rangeIndices, count, vertices.size());
+        for(size_t i = 0; i < count; i++)
+          rangeIndices[i] = vertices[rangeIndices[i]];
+      }
+    });
+  }
+
+  // Counts the misses of each triangle in a FIFO cache, like AnalyzeVertexCache
+  struct CacheSimulation
+  {
+    static const uint32_t CACHE_SIZE = 16;
+    std::vector<uint32_t> timestamps;
+    uint32_t time = CACHE_SIZE + 1;
+
+    CacheSimulation(uint32_t vertexCount)
+      : timestamps(vertexCount, 0)
+    {}
+
+    uint32_t Misses(const uint32_t* triangle)
+    {
+      uint32_t misses = 0;
+      for(int i = 0; i < 3; i++)
+      {
+        if(time - timestamps[triangle[i]] > CACHE_SIZE)
+        {
+          timestamps[triangle[i]] = time++;
+          misses++;
+        }
+      }
+      return misses;
+    }
+
+    void Clear()
+    {
+      time += CACHE_SIZE + 1;
+    }
+  };
+
+  void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Greet::Vec3* positions, uint32_t vertexCount, float threshold)
+  {
+    // Pedro Sander et al., Fast Triangle Reordering for Vertex Locality and Reduced Overdraw.
+    // The cache optimization only jumps to a new region of the mesh where all three vertices of
+    // a triangle miss, those points are the hard boundaries that clusters can't cross.
+    size_t triangleCount = indexCount / 3;
+    if(triangleCount == 0)
+      return;
+    CacheSimulation cache(vertexCount);
+    std::vector<size_t> hardClusters;
+    for(size_t i = 0; i < triangleCount; i++)
+    {
+      if(cache.Misses(indices + i * 3) == 3 || i == 0)
+        hardClusters.push_back(i);
+    }
+    hardClusters.push_back(triangleCount);
+
+    // Hard clusters are split further as soon as the part so far is within threshold of the ACMR
+    // of the whole hard cluster, every split starts with an empty cache
+    std::vector<size_t> clusters;
+    for(size_t c = 0; c + 1 < hardClusters.size(); c++)
+    {
+      size_t start = hardClusters[c];
+      size_t end = hardClusters[c + 1];
+      cache.Clear();
+      size_t misses = 0;
+      for(size_t i = start; i < end; i++)
+        misses += cache.Misses(indices + i * 3);
+      float clusterThreshold = threshold * misses / (end - start);
+
+      cache.Clear();
+      clusters.push_back(start);
+      size_t clusterStart = start;
+      misses = 0;
+      for(size_t i = start; i + 1 < end; i++)
+      {
+        misses += cache.Misses(indices + i * 3);
+        if(misses <= clusterThreshold * (i - clusterStart + 1))
+        {
+          clusters.push_back(i + 1);
+          clusterStart = i + 1;
+          misses = 0;
+          cache.Clear();
+        }
+      }
+    }
+    clusters.push_back(triangleCount);
+
+    // Sort key is how far the cluster faces away from the mesh center, using its area weighted
+    // normal and the average center of its triangles
+    size_t clusterCount = clusters.size() - 1;
+    std::vector<Greet::Vec3> centers(clusterCount, Greet::Vec3(0, 0, 0));
+    std::vector<Greet::Vec3> normals(clusterCount, Greet::Vec3(0, 0, 0));
+    Greet::Vec3 meshCenter(0, 0, 0);
+    for(size_t c = 0; c < clusterCount; c++)
+    {
+      for(size_t i = clusters[c]; i < clusters[c + 1]; i++)
+      {
+        const Greet::Vec3& a = positions[indices[i * 3]];
+        const Greet::Vec3& b = positions[indices[i * 3 + 1]];
+        const Greet::Vec3& c3 = positions[indices[i * 3 + 2]];
+        centers[c] += (a + b + c3) / 3.0f;
+        normals[c] += (b - a).Cross(c3 - a);
+      }
+      meshCenter += centers[c];
+      centers[c] /= (float)(clusters[c + 1] - clusters[c]);
+    }
+    meshCenter /= (float)triangleCount;
+
+    std::vector<float> keys(clusterCount);
+    std::vector<uint32_t> order(clusterCount);
+    for(size_t c = 0; c < clusterCount; c++)
+    {
+      float length = normals[c].Length();
+      keys[c] = length > 0 ? normals[c].Dot(centers[c] - meshCenter) / length : 0;
+      order[c] = c;
+    }
+    std::stable_sort(order.begin(), order.end(), [&](uint32_t first, uint32_t second) { return keys[first] > keys[second]; });
+
+    std::vector<uint32_t> output;
+    output.reserve(triangleCount * 3);
+    for(uint32_t c : order)
+      output.insert(output.end(), indices + clusters[c] * 3, indices + clusters[c + 1] * 3);
+    std::copy(output.begin(), output.end(), indices);
+  }
+
+  std::vector<uint32_t> OptimizeVertexFetch(uint32_t* indices, size_t indexCount, uint32_t vertexCount)
+  {
+    std::vector<uint32_t> remap(vertexCount, UINT32_MAX);
+    uint32_t next = 0;
+    for(size_t i = 0; i < indexCount; i++)
+    {
+      uint32_t& vertex = remap[indices[i]];
+      if(vertex == UINT32_MAX)
+        vertex = next++;
+      indices[i] = vertex;
+    }
+    for(uint32_t& vertex : remap)
+    {
+      if(vertex == UINT32_MAX)
+        vertex = next++;
+    }
+    return remap;
+  }
+
+  void RemapVertices(const void* vertices, size_t vertexCount, size_t stride, const uint32_t* remap, void* out)
+  {
+    const char* in = (const char*)vertices;
+    for(size_t i = 0; i < vertexCount; i++)
+      memcpy((char*)out + remap[i] * stride, in + i * stride, stride);
+  }
+
+  // Reordering a level that overlaps another would change the triangles of the other level
+  static void OptimizeLods(uint32_t* indices, uint32_t vertexCount, std::vector<Lod> lods, const Greet::Vec3* positions, ThreadPool* pool)
+  {
+    std::sort(lods.begin(), lods.end(), [](const Lod& a, const Lod& b) { return a.firstIndex < b.firstIndex; });
+    for(size_t i = 0; i + 1 < lods.size(); i++)
+    {
+      if((uint64_t)lods[i].firstIndex + lods[i].indexCount > lods[i + 1].firstIndex)
+        throw std::runtime_error("Can't optimize overlapping levels of detail");
+    }
+    for(const Lod& lod : lods)
+    {
+      OptimizeVertexCache(indices + lod.firstIndex, lod.indexCount, vertexCount, pool);
+      if(positions)
+        OptimizeOverdraw(indices + lod.firstIndex, lod.indexCount, positions, vertexCount);
+    }
+  }
+
+  void Optimize(MeshData& mesh, bool reduceOverdraw, ThreadPool* pool)
+  {
+    OptimizeLods(mesh.indices.get(), mesh.vertexCount, mesh.lods, reduceOverdraw ? mesh.vertices.get() : nullptr, pool);
+    std::vector<uint32_t> remap = OptimizeVertexFetch(mesh.indices.get(), mesh.indexCount, mesh.vertexCount);
+
+    std::unique_ptr<Greet::Vec3[]> vertices(new Greet::Vec3[mesh.vertexCount]);
+    RemapVertices(mesh.vertices.get(), mesh.vertexCount, sizeof(Greet::Vec3), remap.data(), vertices.get());
+    mesh.vertices = std::move(vertices);
+  }
+
+  static std::vector<Greet::Vec3> ReadPositions(const MeshView& view)
+  {
+    std::vector<Greet::Vec3> positions;
+    const Section* section = view.FindSection(Semantic::Position);
+    if(section && section->format == VK_FORMAT_R32G32B32_SFLOAT && section->stride == sizeof(Greet::Vec3))
+    {
+      positions.resize(view.vertexCount);
+      memcpy(positions.data(), section->data, section->size);
+    }
+    else if(section && section->format == VK_FORMAT_R16G16B16A16_UNORM && section->stride == 4 * sizeof(uint16_t))
+    {
+      positions.resize(view.vertexCount);
+      for(uint32_t i = 0; i < view.vertexCount; i++)
+      {
+        uint16_t quantized[4];
+        memcpy(quantized, section->data + i * sizeof(quantized), sizeof(quantized));
+        positions[i] = DequantizePosition(quantized, view.bounds);
+      }
+    }
+    return positions;
+  }
+
+  static void PrintStatistics(const std::string& name, const VertexCacheStatistics& before, const VertexCacheStatistics& after)
+  {
+    std::cout << "INFO: " << name << " ACMR " << before.acmr << " -> " << after.acmr << ", ATVR " << before.atvr << " -> " << after.atvr << std::endl;
+  }
+
+  void OptimizeFile(const std::string& input, const std::string& output, bool reduceOverdraw, const std::vector<float>& lodErrors, ThreadPool* pool)
+  {
+    MappedMesh mesh(input);
+    MeshView view = mesh.GetView();
+    Section* indexSection = nullptr;
+    Section* lodSection = nullptr;
+    for(Section& section : view.sections)
+    {
+      if(section.semantic == Semantic::Index)
+        indexSection = &section;
+      else if(section.semantic == Semantic::Lod)
+        lodSection = &section;
+    }
+    if(!indexSection)
+      throw std::runtime_error("Can't optimize " + input + ", it has no indices");
+
+    std::vector<uint32_t> indices(view.indexCount);
+    DecodeIndices(*indexSection, view.indexCount, indices.data());
+    for(uint32_t index : indices)
+    {
+      if(index >= view.vertexCount)
+        throw std::runtime_error("Can't optimize " + input + ", it has indices out of range");
+    }
+
+    std::vector<Greet::Vec3> positions;
+    if(reduceOverdraw || !lodErrors.empty())
+    {
+      positions = ReadPositions(view);
+      if(positions.empty())
+        std::cout << "WARN: " << input << " has no float or quantized positions, overdraw is not reduced and no levels of detail are generated" << std::endl;
+    }
+
+    std::vector<Lod> lods = view.GetLods();
+    std::vector<Lod> unoptimized = lods;
+    VertexCacheStatistics before = AnalyzeVertexCache(indices.data() + lods[0].firstIndex, lods[0].indexCount, view.vertexCount);
+    const Greet::Vec3* overdrawPositions = reduceOverdraw && !positions.empty() ? positions.data() : nullptr;
+    if(!lodErrors.empty() && !positions.empty())
+    {
+      // The simplification walks the mesh, which takes about half the time in vertex cache order,
+      // so the full mesh is optimized first
+      indices = std::vector<uint32_t>(indices.begin() + lods[0].firstIndex, indices.begin() + lods[0].firstIndex + lods[0].indexCount);
+      OptimizeLods(indices.data(), view.vertexCount, {{0, (uint32_t)indices.size(), 0.0f}}, overdrawPositions, pool);
+      lods = GenerateLods(indices, positions.data(), view.vertexCount, lodErrors);
+      unoptimized.assign(lods.begin() + 1, lods.end());
+      for(size_t i = 1; i < lods.size(); i++)
+        std::cout << "INFO: " << input << " LOD " << i << ", " << lods[i].indexCount / 3 << " triangles, error " << lods[i].error << std::endl;
+    }
+    OptimizeLods(indices.data(), view.vertexCount, unoptimized, overdrawPositions, pool);
+    std::vector<uint32_t> remap = OptimizeVertexFetch(indices.data(), indices.size(), view.vertexCount);
+    PrintStatistics(input, before, AnalyzeVertexCache(indices.data() + lods[0].firstIndex, lods[0].indexCount, view.vertexCount));
+
+    // Every section gets a copy of its own, so none of them point into the file anymore when the
+    // output replaces the input
+    std::vector<std::vector<char>> buffers;
+    buffers.reserve(view.sections.size() + 1);
+    for(Section& section : view.sections)
+    {
+      if(&section == indexSection || &section == lodSection)
+        continue;
+      buffers.emplace_back(section.size);
+      RemapVertices(section.data, view.vertexCount, section.stride, remap.data(), buffers.back().data());
+      section.data = buffers.back().data();
+    }
+
+    if(indexSection->encoding == Encoding::DeltaVarint)
+      buffers.push_back(EncodeIndices(indices.data(), indices.size()));
+    else if(indexSection->stride == sizeof(uint16_t))
+    {
+      buffers.emplace_back(indices.size() * sizeof(uint16_t));
+      for(size_t i = 0; i < indices.size(); i++)
+      {
+        uint16_t index = indices[i];
+        memcpy(buffers.back().data() + i * sizeof(uint16_t), &index, sizeof(uint16_t));
+      }
+    }
+    else
+      buffers.emplace_back((const char*)indices.data(), (const char*)(indices.data() + indices.size()));
+    indexSection->data = buffers.back().data();
+    indexSection->size = buffers.back().size();
+    view.indexCount = indices.size();
+
+    if(lods.size() > 1 || lodSection)
+    {
+      buffers.push_back(EncodeLods(lods));
+      if(!lodSection)
+      {
+        view.sections.push_back({Semantic::Lod, 0, VK_FORMAT_UNDEFINED, LOD_ENTRY_SIZE, 0, 0, 0, nullptr});
+        lodSection = &view.sections.back();
+      }
+      lodSection->data = buffers.back().data();
+      lodSection->size = buffers.back().size();
+    }
+
+    WriteToFile(output, view);
+  }
+}
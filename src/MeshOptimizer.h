@@ -0,0 +1,59 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <math/Maths.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+// Reorders triangle lists for the GPU. All of these keep the triangles and their winding, only
+// the order of the triangles and of the vertices changes.
+namespace Mesh
+{
+  const size_t PARALLEL_THRESHOLD = 1 << 18;
+
+  // Measured with a FIFO cache of the given size, the usual model of post-transform caches.
+  // ACMR is the average number of vertices transformed per triangle, between 0.5 for a perfect
+  // regular grid and 3, ATVR is the number transformed per vertex, 1 at best.
+  struct VertexCacheStatistics
+  {
+    float acmr;
+    float atvr;
+  };
+
+  VertexCacheStatistics AnalyzeVertexCache(const uint32_t* indices, size_t indexCount, uint32_t vertexCount, uint32_t cacheSize = 16);
+
+  // Tom Forsyth's linear-speed vertex cache optimization. With a pool, index buffers of at least
+  // PARALLEL_THRESHOLD indices are put in breadth first order and split into ranges that are
+  // optimized on its threads, which costs a little locality where the ranges meet.
+  void OptimizeVertexCache(uint32_t* indices, size_t indexCount, uint32_t vertexCount, ThreadPool* pool = nullptr);
+
+  // Splits a cache optimized index buffer into clusters and draws the clusters facing away from
+  // the mesh center first, so that they occlude the rest. Clusters are only split where the
+  // ACMR grows by less than threshold times, 1.05 allows 5%.
+  void OptimizeOverdraw(uint32_t* indices, size_t indexCount, const Greet::Vec3* positions, uint32_t vertexCount, float threshold = 1.05f);
+
+  // Numbers the vertices in the order the indices first use them, which turns vertex fetches
+  // into mostly sequential reads. The indices are rewritten and the returned remap gives the new
+  // index of every old vertex, unused vertices are moved to the end.
+  std::vector<uint32_t> OptimizeVertexFetch(uint32_t* indices, size_t indexCount, uint32_t vertexCount);
+
+  // out[remap[i]] = vertices[i] for vertices of stride bytes, out must not overlap vertices
+  void RemapVertices(const void* vertices, size_t vertexCount, size_t stride, const uint32_t* remap, void* out);
+
+  // All of the above, in the order that they have to be run. Every level of detail is
+  // optimized on its own and the vertices are ordered for the full mesh.
+  void Optimize(MeshData& mesh, bool reduceOverdraw, ThreadPool* pool = nullptr);
+
+  // Optimizes every stream of a MESH file, whatever its vertex formats and index encoding, and
+  // prints the ACMR and ATVR before and after. With lodErrors the levels of detail are
+  // generated first, see GenerateLods. Overdraw is only reduced and levels are only generated
+  // for meshes with 32-bit float or quantized positions.
+  void OptimizeFile(const std::string& input, const std::string& output, bool reduceOverdraw, const std::vector<float>& lodErrors = {},
+      ThreadPool* pool = nullptr);
+}
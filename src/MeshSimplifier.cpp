@@ -0,0 +1,478 @@
+#include "MeshSimplifier.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <stdexcept>
+
+namespace Mesh
+{
+  // Borders are held in place by planes through their edges, perpendicular to the surface. They
+  // are weighted this many times the squared edge length, which keeps holes and open edges from
+  // shrinking before the rest of the surface is simplified.
+  static const float BORDER_WEIGHT = 10.0f;
+
+  // Manifold vertices can collapse into any neighbour, border vertices only into their
+  // neighbours along the border and locked vertices stay where they are
+  enum class VertexKind : uint8_t
+  {
+    Manifold, Border, Locked
+  };
+
+  // The planes of the triangles around a vertex as a symmetric 4x4 matrix. The error at a point
+  // is the weighted mean of its squared distances to the planes.
+  struct Quadric
+  {
+    float a00 = 0, a11 = 0, a22 = 0, a10 = 0, a20 = 0, a21 = 0;
+    float b0 = 0, b1 = 0, b2 = 0;
+    float c = 0;
+    float weight = 0;
+
+    Quadric() = default;
+
+    // The plane normal . p + d = 0, normal has to be normalized
+    Quadric(const Greet::Vec3& normal, float d, float weight)
+      : a00{normal.x * normal.x * weight}, a11{normal.y * normal.y * weight}, a22{normal.z * normal.z * weight},
+      a10{normal.y * normal.x * weight}, a20{normal.z * normal.x * weight}, a21{normal.z * normal.y * weight},
+      b0{normal.x * d * weight}, b1{normal.y * d * weight}, b2{normal.z * d * weight},
+      c{d * d * weight}, weight{weight}
+    {}
+
+    Quadric& operator+=(const Quadric& other)
+    {
+      a00 += other.a00;
+      a11 += other.a11;
+      a22 += other.a22;
+      a10 += other.a10;
+      a20 += other.a20;
+      a21 += other.a21;
+      b0 += other.b0;
+      b1 += other.b1;
+      b2 += other.b2;
+      c += other.c;
+      weight += other.weight;
+      return *this;
+    }
+
+    float GetError(const Greet::Vec3& p) const
+    {
+      float x = a00 * p.x + a10 * p.y + a20 * p.z + b0 * 2;
+      float y = a10 * p.x + a11 * p.y + a21 * p.z + b1 * 2;
+      float z = a20 * p.x + a21 * p.y + a22 * p.z + b2 * 2;
+      float error = x * p.x + y * p.y + z * p.z + c;
+      return weight > 0 ? std::fabs(error) / weight : 0;
+    }
+  };
+
+  struct Collapse
+  {
+    uint32_t from;
+    uint32_t to;
+    float error;
+  };
+
+  static size_t NextCorner(size_t corner)
+  {
+    return corner - corner % 3 + (corner + 1) % 3;
+  }
+
+  // Maps every vertex to the first vertex at its position, so that the seams where vertices are
+  // split for their attributes don't split the surface
+  static std::vector<uint32_t> FindCanonicalVertices(const Greet::Vec3* positions, uint32_t vertexCount)
+  {
+    std::vector<uint32_t> order(vertexCount);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+    {
+      const Greet::Vec3& pa = positions[a];
+      const Greet::Vec3& pb = positions[b];
+      if(pa.x != pb.x)
+        return pa.x < pb.x;
+      if(pa.y != pb.y)
+        return pa.y < pb.y;
+      if(pa.z != pb.z)
+        return pa.z < pb.z;
+      return a < b;
+    });
+
+    std::vector<uint32_t> canonical(vertexCount);
+    for(uint32_t i = 0, first = 0; i < vertexCount; i++)
+    {
+      if(positions[order[i]] != positions[order[first]])
+        first = i;
+      canonical[order[i]] = order[first];
+    }
+    return canonical;
+  }
+
+  // Triangles of every canonical vertex, triangles[offsets[v]] to triangles[offsets[v + 1]]
+  static void BuildAdjacency(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& canonical, uint32_t vertexCount,
+      std::vector<uint32_t>& offsets, std::vector<uint32_t>& triangles)
+  {
+    offsets.assign(vertexCount + 1, 0);
+    for(uint32_t index : indices)
+      offsets[canonical[index] + 1]++;
+    for(uint32_t i = 0; i < vertexCount; i++)
+      offsets[i + 1] += offsets[i];
+
+    triangles.resize(indices.size());
+    std::vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+    for(size_t i = 0; i < indices.size(); i++)
+      triangles[fill[canonical[indices[i]]]++] = i / 3;
+  }
+
+  // Number of triangles around the canonical vertex from that have the edge from -> to
+  static uint32_t CountEdge(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& canonical,
+      const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& triangles, uint32_t from, uint32_t to)
+  {
+    uint32_t count = 0;
+    for(uint32_t i = offsets[from]; i < offsets[from + 1]; i++)
+    {
+      const uint32_t* triangle = &indices[triangles[i] * 3];
+      for(uint32_t corner = 0; corner < 3; corner++)
+        count += canonical[triangle[corner]] == from && canonical[triangle[(corner + 1) % 3]] == to;
+    }
+    return count;
+  }
+
+  // Finds the open edges, which only one triangle uses in its direction and none in the other,
+  // and links the border vertices to their neighbours along them. Vertices on edges used twice
+  // in one direction, where borders cross or on seams are locked.
+  static void ClassifyVertices(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& canonical, uint32_t vertexCount,
+      const std::vector<uint32_t>& offsets, const std::vector<uint32_t>& triangles,
+      std::vector<VertexKind>& kinds, std::vector<uint32_t>& borderNext, std::vector<uint32_t>& borderPrev, std::vector<uint8_t>& openEdges)
+  {
+    std::vector<uint8_t> used(vertexCount, 0);
+    std::vector<uint32_t> wedges(vertexCount, 0);
+    std::vector<uint32_t> openOut(vertexCount, 0);
+    std::vector<uint32_t> openIn(vertexCount, 0);
+    std::vector<uint8_t> nonManifold(vertexCount, 0);
+    borderNext.assign(vertexCount, 0);
+    borderPrev.assign(vertexCount, 0);
+    openEdges.assign(indices.size(), 0);
+    for(size_t i = 0; i < indices.size(); i++)
+    {
+      uint32_t vertex = indices[i];
+      wedges[canonical[vertex]] += used[vertex] ^ 1;
+      used[vertex] = 1;
+
+      uint32_t from = canonical[vertex];
+      uint32_t to = canonical[indices[NextCorner(i)]];
+      if(CountEdge(indices, canonical, offsets, triangles, from, to) > 1)
+        nonManifold[from] = nonManifold[to] = 1;
+      if(CountEdge(indices, canonical, offsets, triangles, to, from) == 0)
+      {
+        openEdges[i] = 1;
+        borderNext[from] = to;
+        borderPrev[to] = from;
+        openOut[from]++;
+        openIn[to]++;
+      }
+    }
+
+    kinds.assign(vertexCount, VertexKind::Manifold);
+    for(uint32_t i = 0; i < vertexCount; i++)
+    {
+      if(nonManifold[i] || wedges[i] > 1)
+        kinds[i] = VertexKind::Locked;
+      else if(openOut[i] || openIn[i])
+        kinds[i] = openOut[i] == 1 && openIn[i] == 1 ? VertexKind::Border : VertexKind::Locked;
+    }
+  }
+
+  static std::vector<Quadric> BuildQuadrics(const std::vector<uint32_t>& indices, const std::vector<uint32_t>& canonical,
+      const std::vector<Greet::Vec3>& points, const std::vector<uint8_t>& openEdges)
+  {
+    std::vector<Quadric> quadrics(points.size());
+    for(size_t i = 0; i < indices.size(); i += 3)
+    {
+      const Greet::Vec3& p0 = points[indices[i]];
+      Greet::Vec3 normal = (points[indices[i + 1]] - p0).Cross(points[indices[i + 2]] - p0);
+      float length = normal.Length();
+      if(length == 0)
+        continue;
+      normal /= length;
+
+      // Weighted by area, so that small triangles don't hold large flat regions in place
+      Quadric plane(normal, -normal.Dot(p0), length * 0.5f);
+      for(size_t corner = i; corner < i + 3; corner++)
+      {
+        quadrics[canonical[indices[corner]]] += plane;
+        if(!openEdges[corner])
+          continue;
+
+        const Greet::Vec3& from = points[indices[corner]];
+        Greet::Vec3 border = (points[indices[NextCorner(corner)]] - from).Cross(normal);
+        float borderLength = border.Length();
+        if(borderLength == 0)
+          continue;
+        border /= borderLength;
+        Quadric borderPlane(border, -border.Dot(from), borderLength * borderLength * BORDER_WEIGHT);
+        quadrics[canonical[indices[corner]]] += borderPlane;
+        quadrics[canonical[indices[NextCorner(corner)]]] += borderPlane;
+      }
+    }
+    return quadrics;
+  }
+
+  std::vector<uint32_t> Simplify(const uint32_t* indices, size_t indexCount, const Greet::Vec3* positions, uint32_t vertexCount,
+      size_t targetIndexCount, float targetError, float* resultError)
+  {
+    if(resultError)
+      *resultError = 0;
+    if(vertexCount == 0)
+      return {};
+
+    // Simplified within the unit box, which keeps the quadrics well within float precision
+    Greet::AABB bounds = Greet::AABB::FromPoints(positions, vertexCount);
+    Greet::Vec3 size = bounds.max - bounds.min;
+    float scale = std::max(size.x, std::max(size.y, size.z));
+    std::vector<Greet::Vec3> points(vertexCount);
+    for(uint32_t i = 0; i < vertexCount; i++)
+      points[i] = scale > 0 ? (positions[i] - bounds.min) / scale : Greet::Vec3(0, 0, 0);
+    std::vector<uint32_t> canonical = FindCanonicalVertices(points.data(), vertexCount);
+
+    // Degenerate triangles and trailing indices that don't form a triangle are dropped
+    std::vector<uint32_t> result;
+    result.reserve(indexCount / 3 * 3);
+    for(size_t i = 0; i + 2 < indexCount; i += 3)
+    {
+      uint32_t a = canonical[indices[i]];
+      uint32_t b = canonical[indices[i + 1]];
+      uint32_t c = canonical[indices[i + 2]];
+      if(a != b && b != c && c != a)
+        result.insert(result.end(), indices + i, indices + i + 3);
+    }
+
+    std::vector<VertexKind> kinds;
+    std::vector<uint32_t> borderNext;
+    std::vector<uint32_t> borderPrev;
+    std::vector<uint8_t> openEdges;
+    std::vector<uint32_t> offsets;
+    std::vector<uint32_t> triangles;
+    BuildAdjacency(result, canonical, vertexCount, offsets, triangles);
+    ClassifyVertices(result, canonical, vertexCount, offsets, triangles, kinds, borderNext, borderPrev, openEdges);
+    std::vector<Quadric> quadrics = BuildQuadrics(result, canonical, points, openEdges);
+
+    float maxError = scale > 0 ? targetError / scale : 0;
+    maxError *= maxError;
+    float error = 0;
+    std::vector<uint32_t> remap(vertexCount);
+    std::iota(remap.begin(), remap.end(), 0);
+    std::vector<Collapse> collapses;
+    std::vector<uint8_t> locked;
+    std::vector<uint32_t> fromNeighbours;
+    std::vector<uint32_t> toNeighbours;
+
+    // A border vertex moves along the border, but doesn't close a hole of three edges
+    auto isBorderCollapse = [&](uint32_t from, uint32_t target)
+    {
+      return (borderNext[from] == target || borderPrev[from] == target) && borderNext[borderNext[from]] != borderPrev[from];
+    };
+
+    // The error of collapsing from into to, infinite if from can't move there
+    auto getCollapseError = [&](uint32_t from, uint32_t to)
+    {
+      // Vertices on seams are locked, so every vertex that moves is canonical
+      uint32_t target = canonical[to];
+      if(canonical[from] != from || kinds[from] == VertexKind::Locked)
+        return INFINITY;
+      if(kinds[from] == VertexKind::Border && !isBorderCollapse(from, target))
+        return INFINITY;
+      Quadric quadric = quadrics[from];
+      quadric += quadrics[target];
+      return quadric.GetError(points[to]);
+    };
+
+    // Only the cheaper direction of every edge is a candidate
+    auto addCollapse = [&](uint32_t a, uint32_t b)
+    {
+      float errorAB = getCollapseError(a, b);
+      float errorBA = getCollapseError(b, a);
+      if(errorAB <= errorBA && errorAB <= maxError)
+        collapses.push_back({a, b, errorAB});
+      else if(errorBA < errorAB && errorBA <= maxError)
+        collapses.push_back({b, a, errorBA});
+    };
+
+    // The collapses of the current pass aren't applied to the indices until the pass is done, so
+    // the corners are looked up through the remap. Only the ends of a collapse are locked for
+    // the rest of the pass, so a single lookup is enough.
+    auto getCorners = [&](uint32_t triangle, uint32_t* corners)
+    {
+      for(uint32_t corner = 0; corner < 3; corner++)
+        corners[corner] = remap[result[triangle * 3 + corner]];
+      return canonical[corners[0]] != canonical[corners[1]] && canonical[corners[1]] != canonical[corners[2]] && canonical[corners[2]] != canonical[corners[0]];
+    };
+
+    auto gatherNeighbours = [&](uint32_t vertex, std::vector<uint32_t>& neighbours)
+    {
+      neighbours.clear();
+      for(uint32_t i = offsets[vertex]; i < offsets[vertex + 1]; i++)
+      {
+        uint32_t corners[3];
+        if(!getCorners(triangles[i], corners))
+          continue;
+        for(uint32_t corner = 0; corner < 3; corner++)
+        {
+          if(canonical[corners[corner]] != vertex)
+            neighbours.push_back(canonical[corners[corner]]);
+        }
+      }
+      std::sort(neighbours.begin(), neighbours.end());
+      neighbours.erase(std::unique(neighbours.begin(), neighbours.end()), neighbours.end());
+    };
+
+    auto canCollapse = [&](uint32_t from, uint32_t to)
+    {
+      // The vertices next to both ends of the edge have to be the ones opposite of it, otherwise
+      // the collapse would fold the surface onto itself
+      uint32_t target = canonical[to];
+      if(kinds[from] == VertexKind::Border && !isBorderCollapse(from, target))
+        return false;
+      gatherNeighbours(from, fromNeighbours);
+      gatherNeighbours(target, toNeighbours);
+      size_t shared = 0;
+      for(size_t i = 0, j = 0; i < fromNeighbours.size() && j < toNeighbours.size();)
+      {
+        if(fromNeighbours[i] == toNeighbours[j])
+          shared++;
+        if(fromNeighbours[i] <= toNeighbours[j])
+          i++;
+        else
+          j++;
+      }
+      if(shared > (kinds[from] == VertexKind::Border ? 1u : 2u))
+        return false;
+
+      // No remaining triangle may turn by more than about 75 degrees, which also keeps slivers
+      // that are about to turn around from being created
+      for(uint32_t i = offsets[from]; i < offsets[from + 1]; i++)
+      {
+        uint32_t triangle[3];
+        if(!getCorners(triangles[i], triangle))
+          continue;
+        if(canonical[triangle[0]] == target || canonical[triangle[1]] == target || canonical[triangle[2]] == target)
+          continue;
+        Greet::Vec3 before[3];
+        Greet::Vec3 after[3];
+        for(int corner = 0; corner < 3; corner++)
+        {
+          before[corner] = points[triangle[corner]];
+          after[corner] = triangle[corner] == from ? points[to] : before[corner];
+        }
+        Greet::Vec3 normalBefore = (before[1] - before[0]).Cross(before[2] - before[0]);
+        Greet::Vec3 normalAfter = (after[1] - after[0]).Cross(after[2] - after[0]);
+        if(normalBefore.Dot(normalAfter) <= 0.25f * normalBefore.Length() * normalAfter.Length())
+          return false;
+      }
+      return true;
+    };
+
+    // Every pass collapses the cheapest edges whose ends weren't touched by another collapse of
+    // the pass
+    while(result.size() > targetIndexCount)
+    {
+      collapses.clear();
+      for(size_t i = 0; i < result.size(); i++)
+      {
+        // Edges inside the mesh are in two triangles, open edges in one
+        uint32_t a = canonical[result[i]];
+        uint32_t b = canonical[result[NextCorner(i)]];
+        if(a < b || borderNext[a] == b || borderPrev[b] == a)
+          addCollapse(result[i], result[NextCorner(i)]);
+      }
+      std::sort(collapses.begin(), collapses.end(), [](const Collapse& a, const Collapse& b) { return a.error < b.error; });
+
+      size_t trianglesToRemove = (result.size() - targetIndexCount + 2) / 3;
+      size_t removed = 0;
+      locked.assign(vertexCount, 0);
+      for(const Collapse& collapse : collapses)
+      {
+        uint32_t target = canonical[collapse.to];
+        if(locked[collapse.from] || locked[target] || !canCollapse(collapse.from, collapse.to))
+          continue;
+
+        locked[collapse.from] = 1;
+        locked[target] = 1;
+        remap[collapse.from] = collapse.to;
+        quadrics[target] += quadrics[collapse.from];
+        error = std::max(error, collapse.error);
+        if(kinds[collapse.from] == VertexKind::Border)
+        {
+          uint32_t prev = borderPrev[collapse.from];
+          uint32_t next = borderNext[collapse.from];
+          borderNext[prev] = next;
+          borderPrev[next] = prev;
+          removed += 1;
+        }
+        else
+          removed += 2;
+        if(removed >= trianglesToRemove)
+          break;
+      }
+      if(removed == 0)
+        break;
+
+      size_t count = 0;
+      for(size_t i = 0; i < result.size(); i += 3)
+      {
+        uint32_t a = remap[result[i]];
+        uint32_t b = remap[result[i + 1]];
+        uint32_t c = remap[result[i + 2]];
+        if(canonical[a] == canonical[b] || canonical[b] == canonical[c] || canonical[c] == canonical[a])
+          continue;
+        result[count++] = a;
+        result[count++] = b;
+        result[count++] = c;
+      }
+      result.resize(count);
+      BuildAdjacency(result, canonical, vertexCount, offsets, triangles);
+    }
+
+    if(resultError)
+      *resultError = std::sqrt(error) * scale;
+    return result;
+  }
+
+  std::vector<Lod> GenerateLods(std::vector<uint32_t>& indices, const Greet::Vec3* positions, uint32_t vertexCount, const std::vector<float>& errorTargets)
+  {
+    std::vector<Lod> lods = {{0, (uint32_t)indices.size(), 0.0f}};
+    if(vertexCount == 0)
+      return lods;
+
+    Greet::AABB bounds = Greet::AABB::FromPoints(positions, vertexCount);
+    Greet::Vec3 size = bounds.max - bounds.min;
+    float scale = std::max(size.x, std::max(size.y, size.z));
+    for(float target : errorTargets)
+    {
+      // The errors of the levels add up, as each is only measured against the level before it
+      Lod previous = lods.back();
+      float targetError = target * scale;
+      if(targetError <= previous.error)
+        continue;
+
+      float error;
+      std::vector<uint32_t> level = Simplify(indices.data() + previous.firstIndex, previous.indexCount, positions, vertexCount,
+          0, targetError - previous.error, &error);
+      if(level.empty() || level.size() >= previous.indexCount)
+        continue;
+      if(indices.size() + level.size() > UINT32_MAX)
+        throw std::runtime_error("Levels of detail have more than 2^32 indices");
+
+      lods.push_back({(uint32_t)indices.size(), (uint32_t)level.size(), previous.error + error});
+      indices.insert(indices.end(), level.begin(), level.end());
+    }
+    return lods;
+  }
+
+  void GenerateLods(MeshData& mesh, const std::vector<float>& errorTargets)
+  {
+    const Lod& full = mesh.lods.front();
+    std::vector<uint32_t> indices(mesh.indices.get() + full.firstIndex, mesh.indices.get() + full.firstIndex + full.indexCount);
+    mesh.lods = GenerateLods(indices, mesh.vertices.get(), mesh.vertexCount, errorTargets);
+    mesh.indices.reset(new uint32_t[indices.size()]);
+    std::copy(indices.begin(), indices.end(), mesh.indices.get());
+    mesh.indexCount = indices.size();
+  }
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "Mesh.h"
+
+#include <math/Maths.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Quadric error metric simplification after Garland and Heckbert, "Surface Simplification Using
+// Quadric Error Metrics". Edges are collapsed into one of their vertices, so a simplified mesh
+// only needs new indices and shares the vertices of the full one. That is what lets all levels
+// of detail of a MESH file live in one index section.
+namespace Mesh
+{
+  // Collapses the edges with the smallest error until there are at most targetIndexCount indices
+  // left or the next collapse would move the surface by more than targetError mesh units, and
+  // returns the remaining indices. resultError is set to the error of the simplified mesh.
+  // Vertices on the border of the mesh only move along it. Vertices that share their position
+  // with others, like those on texture seams, don't move at all. All indices have to be less
+  // than vertexCount.
+  std::vector<uint32_t> Simplify(const uint32_t* indices, size_t indexCount, const Greet::Vec3* positions, uint32_t vertexCount,
+      size_t targetIndexCount, float targetError, float* resultError = nullptr);
+
+  // Appends a level of detail for every error target to indices, which hold the full mesh, and
+  // returns the levels including the full mesh. The targets are fractions of the largest size of
+  // the mesh bounds in increasing order. Every level is simplified from the one before it, and
+  // levels that don't remove any triangles are left out.
+  std::vector<Lod> GenerateLods(std::vector<uint32_t>& indices, const Greet::Vec3* positions, uint32_t vertexCount, const std::vector<float>& errorTargets);
+
+  // Replaces the levels of the mesh with ones generated from its first level
+  void GenerateLods(MeshData& mesh, const std::vector<float>& errorTargets);
+}
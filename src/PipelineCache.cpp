@@ -0,0 +1,108 @@
+#include "PipelineCache.h"
+
+#include "Device.h"
+
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+
+PipelineCache::PipelineCache(Device* device, const std::string& filename)
+  : device{device}, filename{filename}
+{
+  std::vector<char> data = Load();
+  warm = !data.empty();
+
+  VkPipelineCacheCreateInfo createInfo = {};
+  createInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+  createInfo.initialDataSize = data.size();
+  createInfo.pInitialData = data.data();
+
+  if(vkCreatePipelineCache(device->GetDevice(), &createInfo, nullptr, &cache) != VK_SUCCESS)
+  {
+    // Some drivers reject data even though the header matches, start over with an empty cache
+    createInfo.initialDataSize = 0;
+    createInfo.pInitialData = nullptr;
+    warm = false;
+    if(vkCreatePipelineCache(device->GetDevice(), &createInfo, nullptr, &cache) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create pipeline cache");
+  }
+}
+
+PipelineCache::~PipelineCache()
+{
+  Save();
+  vkDestroyPipelineCache(device->GetDevice(), cache, nullptr);
+}
+
+void PipelineCache::Save()
+{
+  size_t size;
+  if(vkGetPipelineCacheData(device->GetDevice(), cache, &size, nullptr) != VK_SUCCESS)
+  {
+    std::cout << "WARN: Failed to read pipeline cache data" << std::endl;
+    return;
+  }
+  std::vector<char> data(size);
+  if(vkGetPipelineCacheData(device->GetDevice(), cache, &size, data.data()) != VK_SUCCESS)
+  {
+    std::cout << "WARN: Failed to read pipeline cache data" << std::endl;
+    return;
+  }
+
+  std::string tempFilename = filename + ".tmp";
+  {
+    std::ofstream file(tempFilename, std::ios::binary | std::ios::trunc);
+    if(!file.is_open() || !file.write(data.data(), size))
+    {
+      std::cout << "WARN: Failed to write pipeline cache " << tempFilename << std::endl;
+      return;
+    }
+  }
+
+  // rename doesn't replace existing files on Windows
+  if(std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+  {
+    std::remove(filename.c_str());
+    if(std::rename(tempFilename.c_str(), filename.c_str()) != 0)
+    {
+      std::cout << "WARN: Failed to replace pipeline cache " << filename << std::endl;
+      std::remove(tempFilename.c_str());
+    }
+  }
+}
+
+std::vector<char> PipelineCache::Load()
+{
+  std::ifstream file(filename, std::ios::ate | std::ios::binary);
+  if(!file.is_open())
+    return {};
+
+  size_t fileSize = (size_t) file.tellg();
+  std::vector<char> data(fileSize);
+  file.seekg(0);
+  file.read(data.data(), fileSize);
+  if(!file || !IsCompatible(data))
+  {
+    std::cout << "INFO: Discarding incompatible pipeline cache " << filename << std::endl;
+    return {};
+  }
+  return data;
+}
+
+bool PipelineCache::IsCompatible(const std::vector<char>& data)
+{
+  VkPipelineCacheHeaderVersionOne header;
+  if(data.size() < sizeof(header))
+    return false;
+  memcpy(&header, data.data(), sizeof(header));
+
+  const VkPhysicalDeviceProperties& properties = device->GetProperties();
+  return header.headerSize >= sizeof(header) &&
+    header.headerSize <= data.size() &&
+    header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+    header.vendorID == properties.vendorID &&
+    header.deviceID == properties.deviceID &&
+    memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <string>
+#include <vector>
+
+class Device;
+
+// VkPipelineCache which is loaded from disk on creation and written back on destruction.
+// Cache data from another GPU or driver is discarded instead of being handed to the driver.
+class PipelineCache
+{
+  private:
+    Device* device;
+    std::string filename;
+    VkPipelineCache cache;
+    bool warm = false;
+
+  public:
+    PipelineCache(Device* device, const std::string& filename);
+    ~PipelineCache();
+
+    // Writes to a temporary file which then replaces the old cache, so a crash never leaves a truncated cache behind
+    void Save();
+
+    VkPipelineCache GetCache() const { return cache; }
+    // True if the cache was created from valid data on disk
+    bool IsWarm() const { return warm; }
+
+  private:
+    std::vector<char> Load();
+    bool IsCompatible(const std::vector<char>& data);
+};
@@ -2,10 +2,12 @@
 
 #include "Device.h"
 
-SwapChainHandler::SwapChainHandler(GLFWwindow* window, VkSurfaceKHR surface, Device* device)
-  : window{window}, surface{surface}, device{device}
+#include <algorithm>
+
+SwapChainHandler::SwapChainHandler(GLFWwindow* window, VkSurfaceKHR surface, Device* device, const SwapChainSettings& settings)
+  : settings{settings}, window{window}, device{device}, surface{surface}
 {
-  CreateSwapChain();
+  CreateSwapChain(VK_NULL_HANDLE);
   CreateImageViews();
   CreateRenderPass();
   CreateCommandPool();
@@ -15,22 +17,53 @@ SwapChainHandler::SwapChainHandler(GLFWwindow* window, VkSurfaceKHR surface, Dev
 
 SwapChainHandler::~SwapChainHandler()
 {
-  CleanupSwapChain();
+  // The device is idle at this point so nothing has to wait for the fences
+  retiredSwapChains.push_back({swapChain, imageViews, framebuffers, depthImage, depthImageView, depthImageMemory, {}});
+  for(auto&& retired : retiredSwapChains)
+    DestroyRetired(retired);
+
+  for(size_t i = 0; i < offscreenMemory.size(); i++)
+  {
+    vkDestroyImage(device->GetDevice(), images[i], nullptr);
+    device->GetAllocator()->Free(offscreenMemory[i]);
+  }
+
+  vkDestroyCommandPool(device->GetDevice(), commandPool, nullptr);
+  vkDestroyRenderPass(device->GetDevice(), renderPass, nullptr);
 }
 
-void SwapChainHandler::CreateSwapChain()
+void SwapChainHandler::Recreate()
 {
+  retiredSwapChains.push_back({swapChain, imageViews, framebuffers, depthImage, depthImageView, depthImageMemory, frameWaits});
+  imageViews.clear();
+  framebuffers.clear();
+  depthImageMemory = {};
+
+  VkFormat oldFormat = imageFormat;
+  // Passing the old swap chain lets the driver reuse its resources and keep presenting its images
+  CreateSwapChain(swapChain);
+  // The render pass and every pipeline using it depend on the format
+  if(imageFormat != oldFormat)
+    throw std::runtime_error("Swap chain image format changed");
+  CreateImageViews();
+  CreateDepthResource();
+  CreateFrameBuffers();
+}
+
+void SwapChainHandler::CreateSwapChain(VkSwapchainKHR oldSwapChain)
+{
+  if(IsHeadless())
+  {
+    CreateOffscreenImages();
+    return;
+  }
+
   SwapChainSupportDetails swapChainSupport = QuerySwapChainSupport(surface, device->GetPhysicalDevice());
 
   VkSurfaceFormatKHR surfaceFormat = ChooseSwapSurfaceFormat(swapChainSupport.formats);
-  VkPresentModeKHR presentMode = ChooseSwapPresentMode(swapChainSupport.presentModes);
+  presentMode = ChooseSwapPresentMode(swapChainSupport.presentModes);
   extent = ChooseSwapExtent(swapChainSupport.capabilities);
-
-  uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
-  if(swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount)
-  {
-    imageCount = swapChainSupport.capabilities.maxImageCount;
-  }
+  uint32_t imageCount = ChooseImageCount(swapChainSupport.capabilities);
 
   VkSwapchainCreateInfoKHR createInfo = {};
   createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
@@ -61,7 +94,7 @@ void SwapChainHandler::CreateSwapChain()
   createInfo.compositeAlpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
   createInfo.presentMode = presentMode;
   createInfo.clipped = VK_TRUE;
-  createInfo.oldSwapchain = VK_NULL_HANDLE;
+  createInfo.oldSwapchain = oldSwapChain;
 
   if(vkCreateSwapchainKHR(device->GetDevice(), &createInfo, nullptr, &swapChain) != VK_SUCCESS)
     throw std::runtime_error("Failed to create swap chain");
@@ -72,6 +105,20 @@ void SwapChainHandler::CreateSwapChain()
   imageFormat = surfaceFormat.format;
 }
 
+void SwapChainHandler::CreateOffscreenImages()
+{
+  // Supported as a color attachment by every implementation
+  imageFormat = VK_FORMAT_R8G8B8A8_UNORM;
+  extent = {settings.width, settings.height};
+  presentMode = VK_PRESENT_MODE_FIFO_KHR;
+
+  uint32_t imageCount = settings.imageCount == 0 ? 2 : settings.imageCount;
+  images.resize(imageCount);
+  offscreenMemory.resize(imageCount);
+  for(uint32_t i = 0; i < imageCount; i++)
+    ImageView::CreateImage(device, extent.width, extent.height, imageFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, images[i], offscreenMemory[i]);
+}
+
 void SwapChainHandler::CreateImageViews()
 {
   imageViews.resize(images.size());
@@ -91,7 +138,7 @@ void SwapChainHandler::CreateRenderPass()
   colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
   colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
   colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-  colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+  colorAttachment.finalLayout = IsHeadless() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
   VkAttachmentReference colorAttachmentRef = {};
   colorAttachmentRef.attachment = 0;
@@ -142,11 +189,10 @@ void SwapChainHandler::CreateRenderPass()
 
 void SwapChainHandler::CreateCommandPool()
 {
-  QueueFamilyIndices queueFamilyIndices = VulkanHandle::FindQueueFamilies(device, surface);
   VkCommandPoolCreateInfo poolInfo = {};
   poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
-  poolInfo.queueFamilyIndex = queueFamilyIndices.graphicsFamily.value();
-  poolInfo.flags = 0;
+  poolInfo.queueFamilyIndex = device->GetGraphicsFamily();
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
   if(vkCreateCommandPool(device->GetDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
     throw std::runtime_error("Failed to create command pool");
 }
@@ -157,8 +203,7 @@ void SwapChainHandler::CreateDepthResource()
 
   ImageView::CreateImage(device, extent.width, extent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL, VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImage, depthImageMemory);
   depthImageView = ImageView::CreateImageView(device, depthImage, depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
-
-  ImageView::TransitionImageLayout(device, commandPool, device->GetGraphicsQueue(), depthImage, depthFormat, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL);
+  // No layout transition is needed, the render pass starts the depth attachment from VK_IMAGE_LAYOUT_UNDEFINED
 }
 
 void SwapChainHandler::CreateFrameBuffers()
@@ -201,16 +246,49 @@ VkSurfaceFormatKHR SwapChainHandler::ChooseSwapSurfaceFormat(const std::vector<V
 
 VkPresentModeKHR SwapChainHandler::ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes)
 {
-  VkPresentModeKHR bestMode = VK_PRESENT_MODE_FIFO_KHR;
-  for(auto&& availablePresentMode : availablePresentModes)
+  // Unbounded modes fall back to each other before giving up on low latency
+  std::vector<VkPresentModeKHR> candidates;
+  switch(settings.presentMode)
   {
-    if(availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR)
-      return availablePresentMode;
-    else if(availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR)
-      bestMode = availablePresentMode;
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+      candidates = {VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR};
+      break;
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+      candidates = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+      break;
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+      candidates = {VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+      break;
+    default:
+      break;
   }
-  // Guaranteed to be available
-  return bestMode;
+
+  VkPresentModeKHR chosenMode = VK_PRESENT_MODE_FIFO_KHR; // Guaranteed to be available
+  for(auto&& candidate : candidates)
+  {
+    if(std::find(availablePresentModes.begin(), availablePresentModes.end(), candidate) != availablePresentModes.end())
+    {
+      chosenMode = candidate;
+      break;
+    }
+  }
+
+  if(chosenMode != settings.presentMode)
+    std::cout << "INFO: Present mode " << GetPresentModeName(settings.presentMode) << " is unsupported, using " << GetPresentModeName(chosenMode) << std::endl;
+  return chosenMode;
+}
+
+uint32_t SwapChainHandler::ChooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities)
+{
+  uint32_t imageCount = settings.imageCount == 0 ? capabilities.minImageCount + 1 : settings.imageCount;
+  imageCount = std::max(imageCount, capabilities.minImageCount);
+  // maxImageCount of 0 means there is no limit
+  if(capabilities.maxImageCount > 0)
+    imageCount = std::min(imageCount, capabilities.maxImageCount);
+
+  if(settings.imageCount != 0 && imageCount != settings.imageCount)
+    std::cout << "INFO: Swap chain image count " << settings.imageCount << " is unsupported, using " << imageCount << std::endl;
+  return imageCount;
 }
 
 VkExtent2D SwapChainHandler::ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities)
@@ -274,25 +352,60 @@ VkImageView SwapChainHandler::GetImageView(uint32_t index)
   return imageViews[index];
 }
 
+VkImage SwapChainHandler::GetImage(uint32_t index)
+{
+  return images[index];
+}
+
+bool SwapChainHandler::IsHeadless()
+{
+  return surface == VK_NULL_HANDLE;
+}
+
+VkPresentModeKHR SwapChainHandler::GetPresentMode()
+{
+  return presentMode;
+}
+
 VkSwapchainKHR SwapChainHandler::GetSwapChain()
 {
   return swapChain;
 }
 
-void SwapChainHandler::CleanupSwapChain()
+void SwapChainHandler::CollectRetired(uint32_t frame)
 {
-  vkDestroyCommandPool(device->GetDevice(), commandPool, nullptr);
-  vkDestroyImageView(device->GetDevice(), depthImageView, nullptr);
-  vkDestroyImage(device->GetDevice(), depthImage, nullptr);
-  vkFreeMemory(device->GetDevice(), depthImageMemory, nullptr);
+  if(frame >= frameWaits.size())
+    frameWaits.resize(frame + 1, 0);
+  frameWaits[frame]++;
 
-  for(auto&& framebuffer : framebuffers)
+  // Retired in order, so the oldest has to complete first. Slots that hadn't been waited on
+  // when it was retired had never been submitted, so they can't be using it.
+  while(!retiredSwapChains.empty())
+  {
+    const std::vector<uint64_t>& retiredWaits = retiredSwapChains.front().frameWaits;
+    for(size_t i = 0; i < retiredWaits.size(); i++)
+    {
+      if(frameWaits[i] <= retiredWaits[i])
+        return;
+    }
+    DestroyRetired(retiredSwapChains.front());
+    retiredSwapChains.pop_front();
+  }
+}
+
+void SwapChainHandler::DestroyRetired(RetiredSwapChain& retired)
+{
+  vkDestroyImageView(device->GetDevice(), retired.depthImageView, nullptr);
+  vkDestroyImage(device->GetDevice(), retired.depthImage, nullptr);
+  device->GetAllocator()->Free(retired.depthImageMemory);
+
+  for(auto&& framebuffer : retired.framebuffers)
     vkDestroyFramebuffer(device->GetDevice(), framebuffer, nullptr);
-  for(auto&& imageView : imageViews)
+  for(auto&& imageView : retired.imageViews)
     vkDestroyImageView(device->GetDevice(), imageView, nullptr);
 
-  vkDestroyRenderPass(device->GetDevice(), renderPass, nullptr);
-  vkDestroySwapchainKHR(device->GetDevice(), swapChain,nullptr);
+  if(retired.swapChain != VK_NULL_HANDLE)
+    vkDestroySwapchainKHR(device->GetDevice(), retired.swapChain, nullptr);
 }
 
 SwapChainSupportDetails SwapChainHandler::QuerySwapChainSupport(VkSurfaceKHR surface, VkPhysicalDevice physicalDevice)
@@ -337,3 +450,35 @@ VkFormat SwapChainHandler::FindSupportedFormat(const std::vector<VkFormat>& cand
   }
   throw std::runtime_error("Failed to fund supported format");
 }
+
+std::string SwapChainHandler::GetPresentModeName(VkPresentModeKHR presentMode)
+{
+  switch(presentMode)
+  {
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:
+      return "immediate";
+    case VK_PRESENT_MODE_MAILBOX_KHR:
+      return "mailbox";
+    case VK_PRESENT_MODE_FIFO_KHR:
+      return "fifo";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR:
+      return "fifo_relaxed";
+    default:
+      return "unknown";
+  }
+}
+
+bool SwapChainHandler::ParsePresentMode(const std::string& name, VkPresentModeKHR& presentMode)
+{
+  std::string lower = name;
+  std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+  for(VkPresentModeKHR mode : {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR})
+  {
+    if(lower == GetPresentModeName(mode))
+    {
+      presentMode = mode;
+      return true;
+    }
+  }
+  return false;
+}
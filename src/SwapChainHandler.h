@@ -6,6 +6,8 @@
 
 #include <vector>
 #include <array>
+#include <deque>
+#include <string>
 
 class Device;
 
@@ -16,6 +18,18 @@ struct SwapChainSupportDetails
   std::vector<VkPresentModeKHR> presentModes;
 };
 
+struct SwapChainSettings
+{
+  // Falls back to the closest supported mode, FIFO is always available
+  VkPresentModeKHR presentMode = VK_PRESENT_MODE_MAILBOX_KHR;
+  // 0 uses one more than the minimum, otherwise clamped to what the surface supports
+  uint32_t imageCount = 0;
+
+  // Size of the offscreen images when there is no surface
+  uint32_t width = 1280;
+  uint32_t height = 720;
+};
+
 struct SwapChainContainer
 {
   VkImage image;
@@ -23,33 +37,66 @@ struct SwapChainContainer
   VkFramebuffer framebuffer;
 };
 
+// Size dependent resources of a replaced swap chain, destroyed once the frames using them have completed
+struct RetiredSwapChain
+{
+  VkSwapchainKHR swapChain;
+  std::vector<VkImageView> imageViews;
+  std::vector<VkFramebuffer> framebuffers;
+  VkImage depthImage;
+  VkImageView depthImageView;
+  MemoryAllocation depthImageMemory;
+
+  // How often the fence of every frame slot had been waited on when the swap chain was retired.
+  // The fences are reused every frame, so it is safe to destroy once each slot has been waited
+  // on again, as that covers the last submission that could have used it.
+  std::vector<uint64_t> frameWaits;
+};
+
 class SwapChainHandler
 {
   private:
-    VkSwapchainKHR swapChain;
+    VkSwapchainKHR swapChain = VK_NULL_HANDLE;
     VkQueue graphicsQueue;
     VkFormat imageFormat;
     VkExtent2D extent;
+    VkPresentModeKHR presentMode;
+    SwapChainSettings settings;
     VkCommandPool commandPool;
     VkRenderPass renderPass;
 
     VkImage depthImage;
-    VkDeviceMemory depthImageMemory;
+    MemoryAllocation depthImageMemory;
     VkImageView depthImageView;
 
     std::vector<VkImage> images;
     std::vector<VkImageView> imageViews;
     std::vector<VkFramebuffer> framebuffers;
+    // Only used in headless mode, where the images are owned by the handler
+    std::vector<MemoryAllocation> offscreenMemory;
+
+    std::deque<RetiredSwapChain> retiredSwapChains;
+    // Number of waits on the fence of every frame slot, reported through CollectRetired
+    std::vector<uint64_t> frameWaits;
 
     GLFWwindow* window;
     Device* device;
     VkSurfaceKHR surface;
 
   public:
-    SwapChainHandler(GLFWwindow* window, VkSurfaceKHR surface, Device* device);
+    // Without a surface the handler renders into offscreen images instead, which are left in
+    // VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL after the render pass
+    SwapChainHandler(GLFWwindow* window, VkSurfaceKHR surface, Device* device, const SwapChainSettings& settings);
 
     ~SwapChainHandler();
 
+    // Rebuilds the swap chain and the resources depending on its size, the render pass and
+    // command pool are kept. The old resources are destroyed by CollectRetired once every frame
+    // in flight has completed since, so the device doesn't have to be idle.
+    void Recreate();
+    // Has to be called after every wait on the in flight fence of the frame slot
+    void CollectRetired(uint32_t frame);
+
     // Getters
     VkExtent2D GetExtent();
     uint32_t GetCount();
@@ -61,24 +108,32 @@ class SwapChainHandler
     VkFramebuffer GetFrameBuffer(uint32_t index);
     VkImageView GetImageView(uint32_t index);
     VkSwapchainKHR GetSwapChain();
+    VkPresentModeKHR GetPresentMode();
+    VkImage GetImage(uint32_t index);
+    bool IsHeadless();
 
   private:
-    void CreateSwapChain();
+    void CreateSwapChain(VkSwapchainKHR oldSwapChain);
+    void CreateOffscreenImages();
     void CreateImageViews();
     void CreateRenderPass();
     void CreateCommandPool();
     void CreateDepthResource();
     void CreateFrameBuffers();
 
-    void CleanupSwapChain();
+    void DestroyRetired(RetiredSwapChain& retired);
 
     // Helper functions
     VkSurfaceFormatKHR ChooseSwapSurfaceFormat(const std::vector<VkSurfaceFormatKHR>& availableFormats);
     VkPresentModeKHR ChooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes);
     VkExtent2D ChooseSwapExtent(const VkSurfaceCapabilitiesKHR& capabilities);
+    uint32_t ChooseImageCount(const VkSurfaceCapabilitiesKHR& capabilities);
     VkFormat FindDepthFormat();
     VkFormat FindSupportedFormat(const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
   public:
     static SwapChainSupportDetails QuerySwapChainSupport(VkSurfaceKHR surface, VkPhysicalDevice physicalDevice);
+    static std::string GetPresentModeName(VkPresentModeKHR presentMode);
+    // Accepts the names returned by GetPresentModeName, case insensitive
+    static bool ParsePresentMode(const std::string& name, VkPresentModeKHR& presentMode);
 };
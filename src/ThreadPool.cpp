@@ -0,0 +1,87 @@
+#include "ThreadPool.h"
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(uint32_t threadCount)
+{
+  if(threadCount == 0)
+    threadCount = std::max(std::thread::hardware_concurrency(), 1u);
+
+  for(uint32_t i = 1; i < threadCount; i++)
+    workers.emplace_back(&ThreadPool::WorkerLoop, this);
+}
+
+ThreadPool::~ThreadPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  workAvailable.notify_all();
+  for(auto&& worker : workers)
+    worker.join();
+}
+
+void ThreadPool::ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)>& function)
+{
+  if(count == 0)
+    return;
+  batchSize = std::max(batchSize, (size_t)1);
+
+  // Not worth waking the workers for a single batch
+  if(workers.empty() || count <= batchSize)
+  {
+    for(size_t begin = 0; begin < count; begin += batchSize)
+      function(begin, std::min(begin + batchSize, count));
+    return;
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->function = &function;
+    this->count = count;
+    this->batchSize = batchSize;
+    nextIndex.store(0, std::memory_order_relaxed);
+    busyWorkers = workers.size();
+    generation++;
+  }
+  workAvailable.notify_all();
+
+  RunBatches();
+
+  std::unique_lock<std::mutex> lock(mutex);
+  workDone.wait(lock, [this]{ return busyWorkers == 0; });
+  this->function = nullptr;
+}
+
+void ThreadPool::WorkerLoop()
+{
+  uint64_t seenGeneration = 0;
+  while(true)
+  {
+    {
+      std::unique_lock<std::mutex> lock(mutex);
+      workAvailable.wait(lock, [&]{ return stopping || generation != seenGeneration; });
+      if(stopping)
+        return;
+      seenGeneration = generation;
+    }
+
+    RunBatches();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if(--busyWorkers == 0)
+      workDone.notify_one();
+  }
+}
+
+void ThreadPool::RunBatches()
+{
+  while(true)
+  {
+    size_t begin = nextIndex.fetch_add(batchSize, std::memory_order_relaxed);
+    if(begin >= count)
+      return;
+    (*function)(begin, std::min(begin + batchSize, count));
+  }
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data parallel loops. The calling thread works on the loop as
+// well, so a pool of one thread runs everything inline. Only one ParallelFor may run at a time.
+class ThreadPool
+{
+  private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable workAvailable;
+    std::condition_variable workDone;
+
+    const std::function<void(size_t, size_t)>* function = nullptr;
+    size_t count = 0;
+    size_t batchSize = 0;
+    std::atomic<size_t> nextIndex{0};
+    uint32_t busyWorkers = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+
+  public:
+    // A thread count of 0 uses one thread per hardware thread
+    ThreadPool(uint32_t threadCount = 0);
+    ~ThreadPool();
+
+    // Includes the calling thread
+    uint32_t GetThreadCount() const { return workers.size() + 1; }
+
+    // Calls function with consecutive [begin, end) ranges of at most batchSize elements covering
+    // [0, count) and returns once all of them have finished
+    void ParallelFor(size_t count, size_t batchSize, const std::function<void(size_t begin, size_t end)>& function);
+
+  private:
+    void WorkerLoop();
+    void RunBatches();
+};
@@ -0,0 +1,145 @@
+#include "TransformHierarchy.h"
+
+#include "ThreadPool.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+// Nodes per batch of the parallel update, small enough to balance the threads
+static const size_t PARALLEL_BATCH_SIZE = 1 << 12;
+
+uint32_t TransformHierarchy::AddNode(uint32_t parent)
+{
+  if(parent != NO_PARENT && parent >= parents.size())
+    throw std::runtime_error("Parent transform node does not exist");
+
+  parents.push_back(parent);
+  positions.push_back(Greet::Vec3(0, 0, 0));
+  rotations.push_back(Greet::Quaternion());
+  scales.push_back(Greet::Vec3(1, 1, 1));
+  worldMatrices.push_back(Greet::Mat4::Identity());
+  dirty.push_back(1);
+  scheduleValid = false;
+  return parents.size() - 1;
+}
+
+void TransformHierarchy::Update(ThreadPool* pool)
+{
+  size_t count = parents.size();
+
+  // Parents come first, so a single pass moves the flags all the way down and finds every
+  // parent already updated
+  if(!pool || count < PARALLEL_THRESHOLD)
+  {
+    for(size_t i = 0; i < count; i++)
+    {
+      if(parents[i] != NO_PARENT)
+        dirty[i] |= dirty[parents[i]];
+      if(dirty[i])
+        UpdateNode(i);
+    }
+  }
+  else
+  {
+    if(!scheduleValid)
+      BuildSchedule();
+
+    for(size_t i = 0; i < count; i++)
+    {
+      if(parents[i] != NO_PARENT)
+        dirty[i] |= dirty[parents[i]];
+    }
+
+    pool->ParallelFor(roots.size(), PARALLEL_BATCH_SIZE, [&](size_t begin, size_t end)
+    {
+      for(size_t i = begin; i < end; i++)
+      {
+        if(dirty[roots[i]])
+          UpdateNode(roots[i]);
+      }
+    });
+    pool->ParallelFor(chunkStarts.size() - 1, 1, [&](size_t begin, size_t end)
+    {
+      for(size_t i = chunkStarts[begin]; i < chunkStarts[end]; i++)
+      {
+        if(dirty[groupNodes[i]])
+          UpdateNode(groupNodes[i]);
+      }
+    });
+  }
+
+  std::fill(dirty.begin(), dirty.end(), 0);
+}
+
+Greet::Mat4 TransformHierarchy::GetLocalMatrix(uint32_t node) const
+{
+  // Translate * Rotate * Scale, the scale only affects the rotation's columns
+  Greet::Mat3 rotation = rotations[node].ToMat3();
+  const Greet::Vec3& scale = scales[node];
+  const float scaleElements[3] = {scale.x, scale.y, scale.z};
+
+  Greet::Mat4 result(1.0f);
+  for(int col = 0; col < 3; col++)
+  {
+    for(int row = 0; row < 3; row++)
+      result.elements[col * 4 + row] = rotation.elements[col * 3 + row] * scaleElements[col];
+  }
+  result.elements[12] = positions[node].x;
+  result.elements[13] = positions[node].y;
+  result.elements[14] = positions[node].z;
+  return result;
+}
+
+void TransformHierarchy::UpdateNode(uint32_t node)
+{
+  if(parents[node] == NO_PARENT)
+    worldMatrices[node] = GetLocalMatrix(node);
+  else
+    worldMatrices[node] = worldMatrices[parents[node]] * GetLocalMatrix(node);
+}
+
+void TransformHierarchy::BuildSchedule()
+{
+  size_t count = parents.size();
+
+  // Every node below a root belongs to the group of the root's child it descends from, the
+  // groups only read the roots' world matrices and can be updated independently
+  std::vector<uint32_t> groups(count, NO_PARENT);
+  std::vector<size_t> groupStarts(count + 1, 0);
+  roots.clear();
+  for(size_t i = 0; i < count; i++)
+  {
+    uint32_t parent = parents[i];
+    if(parent == NO_PARENT)
+      roots.push_back(i);
+    else
+    {
+      groups[i] = parents[parent] == NO_PARENT ? i : groups[parent];
+      groupStarts[groups[i] + 1]++;
+    }
+  }
+  for(size_t i = 0; i < count; i++)
+    groupStarts[i + 1] += groupStarts[i];
+
+  // Sorted by group and within each group by index, so parents still come first
+  groupNodes.resize(groupStarts[count]);
+  std::vector<size_t> groupEnds(groupStarts.begin(), groupStarts.end() - 1);
+  for(size_t i = 0; i < count; i++)
+  {
+    if(groups[i] != NO_PARENT)
+      groupNodes[groupEnds[groups[i]]++] = i;
+  }
+
+  // Whole groups are packed into chunks of at least PARALLEL_BATCH_SIZE nodes
+  chunkStarts.clear();
+  chunkStarts.push_back(0);
+  for(size_t group = 0; group < count; group++)
+  {
+    if(groupEnds[group] - chunkStarts.back() >= PARALLEL_BATCH_SIZE)
+      chunkStarts.push_back(groupEnds[group]);
+  }
+  if(chunkStarts.back() != groupNodes.size())
+    chunkStarts.push_back(groupNodes.size());
+
+  scheduleValid = true;
+}
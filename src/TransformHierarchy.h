@@ -0,0 +1,62 @@
+#pragma once
+
+#include <math/Maths.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+class ThreadPool;
+
+// Scene transforms stored as flat arrays indexed by node. Nodes are only ever appended and a
+// parent must exist before its children, so every parent index is smaller than its children's
+// and the world matrices can be updated front to back in one linear pass.
+// Changing a local transform marks the node dirty, Update then recomputes the world matrices
+// of the dirty nodes and everything below them.
+class TransformHierarchy
+{
+  public:
+    static constexpr uint32_t NO_PARENT = UINT32_MAX;
+    static constexpr size_t PARALLEL_THRESHOLD = 1 << 14;
+
+  private:
+    std::vector<uint32_t> parents;
+    std::vector<Greet::Vec3> positions;
+    std::vector<Greet::Quaternion> rotations;
+    std::vector<Greet::Vec3> scales;
+    std::vector<Greet::Mat4> worldMatrices;
+    std::vector<uint8_t> dirty;
+
+    // Schedule for the parallel update, rebuilt when nodes have been added. Roots are updated
+    // first, then every subtree below a root's child is an independent group. The groups are
+    // laid out one after another in groupNodes and packed into chunks of similar size.
+    bool scheduleValid = false;
+    std::vector<uint32_t> roots;
+    std::vector<uint32_t> groupNodes;
+    std::vector<size_t> chunkStarts;
+
+  public:
+    uint32_t AddNode(uint32_t parent = NO_PARENT);
+    uint32_t GetNodeCount() const { return parents.size(); }
+    uint32_t GetParent(uint32_t node) const { return parents[node]; }
+
+    void SetPosition(uint32_t node, const Greet::Vec3& position) { positions[node] = position; dirty[node] = 1; }
+    void SetRotation(uint32_t node, const Greet::Quaternion& rotation) { rotations[node] = rotation; dirty[node] = 1; }
+    void SetScale(uint32_t node, const Greet::Vec3& scale) { scales[node] = scale; dirty[node] = 1; }
+    const Greet::Vec3& GetPosition(uint32_t node) const { return positions[node]; }
+    const Greet::Quaternion& GetRotation(uint32_t node) const { return rotations[node]; }
+    const Greet::Vec3& GetScale(uint32_t node) const { return scales[node]; }
+
+    // Only up to date after Update
+    const Greet::Mat4& GetWorldMatrix(uint32_t node) const { return worldMatrices[node]; }
+    const Greet::Mat4* GetWorldMatrices() const { return worldMatrices.data(); }
+
+    // With a pool, hierarchies of at least PARALLEL_THRESHOLD nodes update their independent
+    // subtrees on its threads
+    void Update(ThreadPool* pool = nullptr);
+
+  private:
+    Greet::Mat4 GetLocalMatrix(uint32_t node) const;
+    void UpdateNode(uint32_t node);
+    void BuildSchedule();
+};
@@ -0,0 +1,50 @@
+#include "UniformRingBuffer.h"
+
+#include "Device.h"
+
+#include <cstring>
+#include <stdexcept>
+
+UniformRingBuffer::UniformRingBuffer(Device* device, VkDeviceSize elementSize, uint32_t elementsPerFrame, uint32_t frameCount)
+  : device{device}
+{
+  alignment = device->GetProperties().limits.minUniformBufferOffsetAlignment;
+  if(alignment == 0)
+    alignment = 1;
+  // Every element is padded so that the next dynamic offset is aligned
+  frameSize = (elementSize + alignment - 1) / alignment * alignment * elementsPerFrame;
+
+  VkBufferCreateInfo bufferInfo = {};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = frameSize * frameCount;
+  bufferInfo.usage = VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  if(vkCreateBuffer(device->GetDevice(), &bufferInfo, nullptr, &buffer) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create uniform buffer");
+
+  memory = device->GetAllocator()->AllocateBuffer(buffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+UniformRingBuffer::~UniformRingBuffer()
+{
+  vkDestroyBuffer(device->GetDevice(), buffer, nullptr);
+  device->GetAllocator()->Free(memory);
+}
+
+void UniformRingBuffer::BeginFrame(uint32_t frame)
+{
+  head = frame * frameSize;
+  frameEnd = head + frameSize;
+}
+
+uint32_t UniformRingBuffer::Push(const void* data, VkDeviceSize size)
+{
+  if(head + size > frameEnd)
+    throw std::runtime_error("Uniform ring buffer is full, increase its frame size");
+
+  VkDeviceSize offset = head;
+  memcpy(static_cast<char*>(memory.mapped) + offset, data, size);
+  head = (offset + size + alignment - 1) / alignment * alignment;
+  return static_cast<uint32_t>(offset);
+}
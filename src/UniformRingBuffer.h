@@ -0,0 +1,43 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+
+#include <vulkan/vulkan.h>
+
+class Device;
+
+// Single persistently mapped uniform buffer split into one region per frame in flight.
+// Writes are bump allocated inside the current frame's region and bound with
+// VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC offsets.
+class UniformRingBuffer
+{
+  private:
+    Device* device;
+
+    VkBuffer buffer;
+    MemoryAllocation memory;
+
+    VkDeviceSize alignment;
+    VkDeviceSize frameSize;
+
+    VkDeviceSize head = 0;
+    VkDeviceSize frameEnd = 0;
+
+  public:
+    UniformRingBuffer(Device* device, VkDeviceSize elementSize, uint32_t elementsPerFrame, uint32_t frameCount);
+    ~UniformRingBuffer();
+
+    // Must only be called once the fence of the frame has been waited on
+    void BeginFrame(uint32_t frame);
+
+    // Copies the data into the ring and returns its dynamic offset
+    uint32_t Push(const void* data, VkDeviceSize size);
+
+    template <typename T>
+    uint32_t Push(const T& data)
+    {
+      return Push(&data, sizeof(T));
+    }
+
+    VkBuffer GetBuffer() const { return buffer; }
+};
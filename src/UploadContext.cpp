@@ -0,0 +1,400 @@
+#include "UploadContext.h"
+
+#include "Device.h"
+#include "ImageView.h"
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+// Everything that can read uploaded data in the graphics pipeline
+static const VkPipelineStageFlags CONSUMER_STAGES = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT | VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+static const VkAccessFlags CONSUMER_ACCESS = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_INDEX_READ_BIT | VK_ACCESS_UNIFORM_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+
+UploadContext::UploadContext(Device* device, VkDeviceSize stagingSize)
+  : device{device}, queue{device->GetTransferQueue()}, queueFamily{device->GetTransferFamily()}, graphicsFamily{device->GetGraphicsFamily()},
+  granularity{device->GetTransferGranularity()}, stagingSize{stagingSize}
+{
+  stagingAlignment = std::max<VkDeviceSize>(device->GetProperties().limits.optimalBufferCopyOffsetAlignment, 16);
+
+  VkCommandPoolCreateInfo poolInfo = {};
+  poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+  poolInfo.queueFamilyIndex = queueFamily;
+  poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+  if(vkCreateCommandPool(device->GetDevice(), &poolInfo, nullptr, &commandPool) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create upload command pool");
+
+  VkBufferCreateInfo bufferInfo = {};
+  bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+  bufferInfo.size = stagingSize;
+  bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+  bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+  if(vkCreateBuffer(device->GetDevice(), &bufferInfo, nullptr, &stagingBuffer) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create staging buffer");
+
+  stagingMemory = device->GetAllocator()->AllocateBuffer(stagingBuffer, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+}
+
+UploadContext::~UploadContext()
+{
+  WaitIdle();
+  for(auto&& batch : freeBatches)
+    vkDestroyFence(device->GetDevice(), batch.fence, nullptr);
+  vkDestroyCommandPool(device->GetDevice(), commandPool, nullptr);
+
+  // The graphics queue is expected to be idle here
+  for(auto&& frameSemaphores : acquiredSemaphores)
+    freeSemaphores.insert(freeSemaphores.end(), frameSemaphores.begin(), frameSemaphores.end());
+  freeSemaphores.insert(freeSemaphores.end(), pendingSemaphores.begin(), pendingSemaphores.end());
+  for(auto&& semaphore : freeSemaphores)
+    vkDestroySemaphore(device->GetDevice(), semaphore, nullptr);
+
+  vkDestroyBuffer(device->GetDevice(), stagingBuffer, nullptr);
+  device->GetAllocator()->Free(stagingMemory);
+}
+
+void UploadContext::UploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size, VkDeviceSize offset)
+{
+  // Split large uploads so that the ring can keep recycling while the copies are in flight
+  VkDeviceSize maxChunkSize = stagingSize / 4;
+  for(VkDeviceSize done = 0; done < size;)
+  {
+    VkDeviceSize chunkSize = std::min(size - done, maxChunkSize);
+    VkDeviceSize stagingOffset = AllocateStaging(chunkSize);
+    memcpy(static_cast<char*>(stagingMemory.mapped) + stagingOffset, static_cast<const char*>(data) + done, chunkSize);
+
+    VkBufferCopy copyRegion = {};
+    copyRegion.srcOffset = stagingOffset;
+    copyRegion.dstOffset = offset + done;
+    copyRegion.size = chunkSize;
+    vkCmdCopyBuffer(GetCommandBuffer(), stagingBuffer, buffer, 1, &copyRegion);
+
+    if(UsesOwnershipTransfer())
+    {
+      VkBufferMemoryBarrier release = {};
+      release.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+      release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+      release.dstAccessMask = 0;
+      release.srcQueueFamilyIndex = queueFamily;
+      release.dstQueueFamilyIndex = graphicsFamily;
+      release.buffer = buffer;
+      release.offset = copyRegion.dstOffset;
+      release.size = chunkSize;
+      bufferReleases.push_back(release);
+    }
+    else
+    {
+      pendingBufferCopies = true;
+    }
+
+    done += chunkSize;
+  }
+}
+
+void UploadContext::UploadImage(VkImage image, VkFormat format, const void* data, uint32_t width, uint32_t height, uint32_t bytesPerPixel)
+{
+  // Chunks always cover whole rows, but have to start on a multiple of the queue's granularity.
+  // A granularity of zero only allows copying the whole image at once.
+  uint32_t rowGranularity = granularity.height == 0 ? height : std::min(granularity.height, height);
+  VkDeviceSize rowSize = width * bytesPerPixel;
+  if(rowSize * rowGranularity > stagingSize)
+    throw std::runtime_error("Staging buffer is too small to contain a single chunk of the image");
+  uint32_t maxRows = std::max<VkDeviceSize>(stagingSize / 4 / rowSize / rowGranularity, 1) * rowGranularity;
+
+  ImageView::RecordTransitionImageLayout(GetCommandBuffer(), image, format, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
+
+  for(uint32_t y = 0; y < height;)
+  {
+    uint32_t rows = std::min(height - y, maxRows);
+    VkDeviceSize stagingOffset = AllocateStaging(rows * rowSize);
+    memcpy(static_cast<char*>(stagingMemory.mapped) + stagingOffset, static_cast<const char*>(data) + y * rowSize, rows * rowSize);
+
+    VkBufferImageCopy region = {};
+    region.bufferOffset = stagingOffset;
+    region.bufferRowLength = 0;
+    region.bufferImageHeight = 0;
+    region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    region.imageSubresource.mipLevel = 0;
+    region.imageSubresource.baseArrayLayer = 0;
+    region.imageSubresource.layerCount = 1;
+
+    region.imageOffset = {0, static_cast<int32_t>(y), 0};
+    region.imageExtent = {width, rows, 1};
+
+    vkCmdCopyBufferToImage(GetCommandBuffer(), stagingBuffer, image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+    y += rows;
+  }
+
+  if(UsesOwnershipTransfer())
+  {
+    // The transfer queue can't use the fragment shader stage, the layout change happens as part of the ownership transfer
+    VkImageMemoryBarrier release = {};
+    release.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    release.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    release.dstAccessMask = 0;
+    release.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    release.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    release.srcQueueFamilyIndex = queueFamily;
+    release.dstQueueFamilyIndex = graphicsFamily;
+    release.image = image;
+    release.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+    release.subresourceRange.baseMipLevel = 0;
+    release.subresourceRange.levelCount = 1;
+    release.subresourceRange.baseArrayLayer = 0;
+    release.subresourceRange.layerCount = 1;
+    imageReleases.push_back(release);
+  }
+  else
+  {
+    ImageView::RecordTransitionImageLayout(GetCommandBuffer(), image, format, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+  }
+}
+
+void UploadContext::Flush()
+{
+  if(!recording)
+    return;
+
+  if(pendingBufferCopies)
+  {
+    VkMemoryBarrier barrier = {};
+    barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barrier.dstAccessMask = CONSUMER_ACCESS;
+    vkCmdPipelineBarrier(current.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, CONSUMER_STAGES, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+    pendingBufferCopies = false;
+  }
+
+  VkSemaphore semaphore = VK_NULL_HANDLE;
+  if(!bufferReleases.empty() || !imageReleases.empty())
+  {
+    vkCmdPipelineBarrier(current.commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, 0,
+        0, nullptr,
+        static_cast<uint32_t>(bufferReleases.size()), bufferReleases.data(),
+        static_cast<uint32_t>(imageReleases.size()), imageReleases.data());
+
+    // The acquire has to match the release, except for the access masks which are ignored on the other queue
+    for(auto&& barrier : bufferReleases)
+    {
+      barrier.srcAccessMask = 0;
+      barrier.dstAccessMask = CONSUMER_ACCESS;
+      bufferAcquires.push_back(barrier);
+    }
+    for(auto&& barrier : imageReleases)
+    {
+      barrier.srcAccessMask = 0;
+      barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+      imageAcquires.push_back(barrier);
+    }
+    bufferReleases.clear();
+    imageReleases.clear();
+    semaphore = GetSemaphore();
+  }
+
+  if(vkEndCommandBuffer(current.commandBuffer) != VK_SUCCESS)
+    throw std::runtime_error("Failed to record upload command buffer");
+
+  VkSubmitInfo submitInfo = {};
+  submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+  submitInfo.commandBufferCount = 1;
+  submitInfo.pCommandBuffers = &current.commandBuffer;
+  if(semaphore != VK_NULL_HANDLE)
+  {
+    submitInfo.signalSemaphoreCount = 1;
+    submitInfo.pSignalSemaphores = &semaphore;
+  }
+
+  if(vkQueueSubmit(queue, 1, &submitInfo, current.fence) != VK_SUCCESS)
+    throw std::runtime_error("Failed to submit upload command buffer");
+
+  if(semaphore != VK_NULL_HANDLE)
+    pendingSemaphores.push_back(semaphore);
+
+  inFlight.push_back(current);
+  recording = false;
+}
+
+void UploadContext::WaitIdle()
+{
+  Flush();
+  while(!inFlight.empty())
+    RetireOldest();
+}
+
+void UploadContext::AcquireUploads(uint32_t frame, VkCommandBuffer commandBuffer, std::vector<VkSemaphore>& waitSemaphores, std::vector<VkPipelineStageFlags>& waitStages)
+{
+  if(acquiredSemaphores.size() <= frame)
+    acquiredSemaphores.resize(frame + 1);
+
+  // The previous submission of this frame has completed, so its waits have as well
+  freeSemaphores.insert(freeSemaphores.end(), acquiredSemaphores[frame].begin(), acquiredSemaphores[frame].end());
+  acquiredSemaphores[frame].clear();
+
+  if(pendingSemaphores.empty())
+    return;
+
+  // The semaphores are waited on at the consumer stages, so the barrier has to start there to chain with them
+  vkCmdPipelineBarrier(commandBuffer, CONSUMER_STAGES, CONSUMER_STAGES, 0,
+      0, nullptr,
+      static_cast<uint32_t>(bufferAcquires.size()), bufferAcquires.data(),
+      static_cast<uint32_t>(imageAcquires.size()), imageAcquires.data());
+  bufferAcquires.clear();
+  imageAcquires.clear();
+
+  for(auto&& semaphore : pendingSemaphores)
+  {
+    waitSemaphores.push_back(semaphore);
+    waitStages.push_back(CONSUMER_STAGES);
+    acquiredSemaphores[frame].push_back(semaphore);
+  }
+  pendingSemaphores.clear();
+}
+
+VkCommandBuffer UploadContext::GetCommandBuffer()
+{
+  if(recording)
+    return current.commandBuffer;
+
+  RetireCompleted();
+  if(freeBatches.empty())
+  {
+    VkCommandBufferAllocateInfo allocInfo = {};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandPool = commandPool;
+    allocInfo.commandBufferCount = 1;
+    if(vkAllocateCommandBuffers(device->GetDevice(), &allocInfo, &current.commandBuffer) != VK_SUCCESS)
+      throw std::runtime_error("Failed to allocate upload command buffer");
+
+    VkFenceCreateInfo fenceInfo = {};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    if(vkCreateFence(device->GetDevice(), &fenceInfo, nullptr, &current.fence) != VK_SUCCESS)
+      throw std::runtime_error("Failed to create upload fence");
+  }
+  else
+  {
+    current = freeBatches.back();
+    freeBatches.pop_back();
+  }
+  current.stagingBytes = 0;
+  current.stagingEnd = stagingHead;
+
+  VkCommandBufferBeginInfo beginInfo = {};
+  beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+  beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+  if(vkBeginCommandBuffer(current.commandBuffer, &beginInfo) != VK_SUCCESS)
+    throw std::runtime_error("Failed to begin recording upload command buffer");
+
+  recording = true;
+  return current.commandBuffer;
+}
+
+VkDeviceSize UploadContext::AllocateStaging(VkDeviceSize size)
+{
+  size = (size + stagingAlignment - 1) / stagingAlignment * stagingAlignment;
+  if(size > stagingSize)
+    throw std::runtime_error("Upload is larger than the staging buffer");
+
+  while(true)
+  {
+    if(stagingUsed == 0)
+    {
+      stagingHead = 0;
+      stagingTail = 0;
+    }
+
+    VkDeviceSize offset;
+    VkDeviceSize consumed;
+    if(stagingUsed == 0 || stagingHead > stagingTail)
+    {
+      // Free space is [head, size) followed by [0, tail)
+      if(stagingHead + size <= stagingSize)
+      {
+        offset = stagingHead;
+        consumed = size;
+      }
+      else if(size <= stagingTail)
+      {
+        offset = 0;
+        consumed = stagingSize - stagingHead + size;
+      }
+      else
+      {
+        RetireOldest();
+        continue;
+      }
+    }
+    else if(stagingHead < stagingTail && stagingHead + size <= stagingTail)
+    {
+      offset = stagingHead;
+      consumed = size;
+    }
+    else
+    {
+      RetireOldest();
+      continue;
+    }
+
+    GetCommandBuffer();
+    stagingHead = offset + size;
+    stagingUsed += consumed;
+    current.stagingBytes += consumed;
+    current.stagingEnd = stagingHead;
+    return offset;
+  }
+}
+
+void UploadContext::RetireCompleted()
+{
+  while(!inFlight.empty() && vkGetFenceStatus(device->GetDevice(), inFlight.front().fence) == VK_SUCCESS)
+    RetireFront();
+}
+
+void UploadContext::RetireOldest()
+{
+  // The batch being recorded holds the rest of the ring, it has to be submitted before it can be waited on
+  if(inFlight.empty())
+    Flush();
+  if(inFlight.empty())
+    throw std::runtime_error("Staging buffer has no uploads to wait for");
+
+  vkWaitForFences(device->GetDevice(), 1, &inFlight.front().fence, VK_TRUE, std::numeric_limits<uint64_t>::max());
+  RetireFront();
+}
+
+void UploadContext::RetireFront()
+{
+  UploadBatch batch = inFlight.front();
+  inFlight.pop_front();
+
+  // Batches without staging data don't own a part of the ring
+  if(batch.stagingBytes > 0)
+  {
+    stagingTail = batch.stagingEnd;
+    stagingUsed -= batch.stagingBytes;
+  }
+
+  vkResetFences(device->GetDevice(), 1, &batch.fence);
+  vkResetCommandBuffer(batch.commandBuffer, 0);
+  freeBatches.push_back(batch);
+}
+
+VkSemaphore UploadContext::GetSemaphore()
+{
+  if(!freeSemaphores.empty())
+  {
+    VkSemaphore semaphore = freeSemaphores.back();
+    freeSemaphores.pop_back();
+    return semaphore;
+  }
+
+  VkSemaphoreCreateInfo semaphoreInfo = {};
+  semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+
+  VkSemaphore semaphore;
+  if(vkCreateSemaphore(device->GetDevice(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS)
+    throw std::runtime_error("Failed to create upload semaphore");
+  return semaphore;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "MemoryAllocator.h"
+
+#include <vulkan/vulkan.h>
+#include <deque>
+#include <vector>
+
+class Device;
+
+struct UploadBatch
+{
+  VkCommandBuffer commandBuffer;
+  VkFence fence;
+  // Staging ring bytes consumed by the batch, including padding skipped when wrapping
+  VkDeviceSize stagingBytes;
+  VkDeviceSize stagingEnd;
+};
+
+// Records buffer and image uploads into a single command buffer which is submitted once
+// and tracked with a fence. The data is staged in a persistently mapped ring buffer which
+// is reclaimed as batches complete, so the queue is never idled.
+//
+// When the device has a dedicated transfer queue the copies run there. Ownership of the
+// uploaded resources is released to the graphics family when a batch is submitted and a
+// semaphore is signaled, the graphics side acquires them with AcquireUploads.
+class UploadContext
+{
+  private:
+    Device* device;
+    VkQueue queue;
+    uint32_t queueFamily;
+    uint32_t graphicsFamily;
+    VkExtent3D granularity;
+    VkCommandPool commandPool;
+
+    VkBuffer stagingBuffer;
+    MemoryAllocation stagingMemory;
+    VkDeviceSize stagingSize;
+    VkDeviceSize stagingAlignment;
+    VkDeviceSize stagingHead = 0;
+    VkDeviceSize stagingTail = 0;
+    VkDeviceSize stagingUsed = 0;
+
+    UploadBatch current;
+    bool recording = false;
+    // Buffer copies need a memory barrier before they can be read by later submissions
+    bool pendingBufferCopies = false;
+
+    std::deque<UploadBatch> inFlight;
+    std::vector<UploadBatch> freeBatches;
+
+    // Queue family ownership transfers, only used with a dedicated transfer queue
+    std::vector<VkBufferMemoryBarrier> bufferReleases;
+    std::vector<VkImageMemoryBarrier> imageReleases;
+    std::vector<VkBufferMemoryBarrier> bufferAcquires;
+    std::vector<VkImageMemoryBarrier> imageAcquires;
+    std::vector<VkSemaphore> pendingSemaphores;
+    std::vector<std::vector<VkSemaphore>> acquiredSemaphores;
+    std::vector<VkSemaphore> freeSemaphores;
+
+  public:
+    UploadContext(Device* device, VkDeviceSize stagingSize);
+    ~UploadContext();
+
+    void UploadBuffer(VkBuffer buffer, const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+    // Leaves the image in VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
+    void UploadImage(VkImage image, VkFormat format, const void* data, uint32_t width, uint32_t height, uint32_t bytesPerPixel);
+
+    // Submits everything recorded so far, the uploads are visible to later graphics submissions
+    void Flush();
+    // Flushes and blocks until every upload has completed
+    void WaitIdle();
+
+    // Records the acquire barriers of all submitted uploads into a graphics command buffer and
+    // adds the semaphores it has to wait on. Must only be called once the fence of the frame
+    // has been waited on, since that is when the semaphores of its last acquire can be reused.
+    void AcquireUploads(uint32_t frame, VkCommandBuffer commandBuffer, std::vector<VkSemaphore>& waitSemaphores, std::vector<VkPipelineStageFlags>& waitStages);
+
+    bool UsesOwnershipTransfer() const { return queueFamily != graphicsFamily; }
+
+  private:
+    VkCommandBuffer GetCommandBuffer();
+    VkDeviceSize AllocateStaging(VkDeviceSize size);
+    void RetireCompleted();
+    void RetireOldest();
+    void RetireFront();
+    VkSemaphore GetSemaphore();
+};
@@ -11,67 +11,25 @@ struct QueueFamilyIndices
 {
   std::optional<uint32_t> graphicsFamily;
   std::optional<uint32_t> presentFamily;
+  // Falls back to the graphics family when the GPU has no dedicated transfer queue
+  std::optional<uint32_t> transferFamily;
+  // Headless rendering has no surface to present to
+  bool presentRequired = true;
 
   bool IsComplete()
   {
-    return graphicsFamily.has_value() && presentFamily.has_value();
+    return graphicsFamily.has_value() && (presentFamily.has_value() || !presentRequired);
   }
 };
 
 struct VulkanHandle
 {
   friend class Device;
-  static uint32_t FindMemoryType(Device* device, uint32_t typeFilter, VkMemoryPropertyFlags properties)
-  {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vkGetPhysicalDeviceMemoryProperties(device->GetPhysicalDevice(), &memProperties);
-    for(uint32_t i = 0;i<memProperties.memoryTypeCount; i++)
-    {
-      if(typeFilter & (1  << i) && (memProperties.memoryTypes[i].propertyFlags & properties) == properties)
-        return i;
-    }
-    throw std::runtime_error("Failed to find suitable memory type");
-  }
-
   static QueueFamilyIndices FindQueueFamilies(Device* device, VkSurfaceKHR surface)
   {
     return FindQueueFamilies(device->GetPhysicalDevice(), surface);
   }
 
-  static VkCommandBuffer BeginSingleTimeCommand(Device* device, VkCommandPool commandPool)
-  {
-    VkCommandBufferAllocateInfo allocInfo = {};
-    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = commandPool;
-    allocInfo.commandBufferCount = 1;
-
-    VkCommandBuffer commandBuffer;
-    vkAllocateCommandBuffers(device->GetDevice(), &allocInfo, &commandBuffer);
-
-    VkCommandBufferBeginInfo beginInfo = {};
-    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
-    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
-
-    vkBeginCommandBuffer(commandBuffer, &beginInfo);
-    return commandBuffer;
-  }
-
-  static void EndSingleTimeCommand(Device* device, VkCommandPool commandPool, VkQueue graphicsQueue, VkCommandBuffer commandBuffer)
-  {
-    vkEndCommandBuffer(commandBuffer);
-
-    VkSubmitInfo submitInfo = {};
-    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-    submitInfo.commandBufferCount = 1;
-    submitInfo.pCommandBuffers = &commandBuffer;
-
-    vkQueueSubmit(graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE);
-    vkQueueWaitIdle(graphicsQueue);
-    vkFreeCommandBuffers(device->GetDevice(), commandPool, 1, &commandBuffer);
-  }
-
-
   static void VkSubmitDebugUtilsMessageEXT(
       VkInstance instance,
       VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,
@@ -116,26 +74,40 @@ struct VulkanHandle
     static QueueFamilyIndices FindQueueFamilies(VkPhysicalDevice device, VkSurfaceKHR surface)
     {
       QueueFamilyIndices indices;
+      indices.presentRequired = surface != VK_NULL_HANDLE;
       uint32_t queueFamilyCount;
       vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
       std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
       vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
+      bool transferOnly = false;
       int i = 0;
       for(auto&& queueFamily : queueFamilies)
       {
-        if(queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
+        if(!indices.graphicsFamily.has_value() && queueFamily.queueCount > 0 && queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT)
           indices.graphicsFamily = i;
 
         VkBool32 presentSupport = false;
-        vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
-        if(queueFamily.queueCount > 0 && presentSupport)
+        if(indices.presentRequired)
+          vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface, &presentSupport);
+        if(!indices.presentFamily.has_value() && queueFamily.queueCount > 0 && presentSupport)
           indices.presentFamily = i;
 
-        if(indices.IsComplete())
-          break;
+        // Prefer a pure transfer family (DMA engine) over an async compute family
+        if(queueFamily.queueCount > 0 && !(queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT) && !transferOnly)
+        {
+          if(!(queueFamily.queueFlags & VK_QUEUE_COMPUTE_BIT) && queueFamily.queueFlags & VK_QUEUE_TRANSFER_BIT)
+          {
+            indices.transferFamily = i;
+            transferOnly = true;
+          }
+          else if(!indices.transferFamily.has_value() && queueFamily.queueFlags & (VK_QUEUE_COMPUTE_BIT | VK_QUEUE_TRANSFER_BIT))
+            indices.transferFamily = i;
+        }
 
         i++;
       }
+      if(!indices.transferFamily.has_value())
+        indices.transferFamily = indices.graphicsFamily;
       return indices;
     }
 
@@ -1,14 +1,118 @@
+#include <algorithm>
 #include <iostream>
 
 #include <math/Vec4.h>
 #include <math/Mat4.h>
 #include <Application.h>
+#include <MeshOptimizer.h>
+#include <ThreadPool.h>
 
-int main()
+void PrintUsage(const char* program)
 {
+  std::cout << "Usage: " << program << " [options]" << std::endl;
+  std::cout << "  --present-mode <fifo|fifo_relaxed|mailbox|immediate>" << std::endl;
+  std::cout << "  --frames-in-flight <count>" << std::endl;
+  std::cout << "  --image-count <count>" << std::endl;
+  std::cout << "  --report-interval <frames>" << std::endl;
+  std::cout << "  --headless <frames>   render offscreen without a window and exit" << std::endl;
+  std::cout << "  --gpu-trace <file>    write GPU timings as a Chrome trace" << std::endl;
+  std::cout << "  --cpu-trace <file>    write CPU timings as a Chrome trace on exit or F12" << std::endl;
+  std::cout << "  --mesh <file>         draw a quantized MESH file instead of the built-in quads" << std::endl;
+  std::cout << "  --optimize-mesh <file>  reorder a MESH file for the vertex cache and exit" << std::endl;
+  std::cout << "  --mesh-output <file>    write the optimized mesh here instead of replacing it" << std::endl;
+  std::cout << "  --reduce-overdraw <0|1> also reorder the optimized mesh to reduce overdraw" << std::endl;
+  std::cout << "  --lod-errors <e1,e2,...> generate levels of detail for the optimized mesh at these errors" << std::endl;
+  std::cout << "  --pipeline-bench <count> time pipeline creation with an empty and the loaded cache and exit" << std::endl;
+}
+
+ApplicationSettings ParseArguments(int argc, char** argv)
+{
+  ApplicationSettings settings;
+  for(int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if(i + 1 >= argc)
+      throw std::runtime_error("Missing value for " + arg);
+    std::string value = argv[++i];
+
+    if(arg == "--present-mode")
+    {
+      if(!SwapChainHandler::ParsePresentMode(value, settings.swapChain.presentMode))
+        throw std::runtime_error("Unknown present mode " + value);
+    }
+    else if(arg == "--frames-in-flight")
+      settings.framesInFlight = std::stoul(value);
+    else if(arg == "--image-count")
+      settings.swapChain.imageCount = std::stoul(value);
+    else if(arg == "--report-interval")
+      settings.reportInterval = std::stoul(value);
+    else if(arg == "--headless")
+      settings.headlessFrames = std::stoul(value);
+    else if(arg == "--gpu-trace")
+      settings.gpuTraceFile = value;
+    else if(arg == "--cpu-trace")
+      settings.cpuTraceFile = value;
+    else if(arg == "--mesh")
+      settings.meshFile = value;
+    else if(arg == "--optimize-mesh")
+      settings.optimizeMeshFile = value;
+    else if(arg == "--mesh-output")
+      settings.meshOutputFile = value;
+    else if(arg == "--reduce-overdraw")
+      settings.reduceOverdraw = std::stoul(value) != 0;
+    else if(arg == "--lod-errors")
+    {
+      settings.lodErrors.clear();
+      for(size_t start = 0; start < value.size();)
+      {
+        size_t end = std::min(value.find(',', start), value.size());
+        settings.lodErrors.push_back(std::stof(value.substr(start, end - start)));
+        start = end + 1;
+      }
+    }
+    else if(arg == "--pipeline-bench")
+      settings.pipelineBenchIterations = std::stoul(value);
+    else
+      throw std::runtime_error("Unknown argument " + arg);
+  }
+  return settings;
+}
+
+int OptimizeMesh(const ApplicationSettings& settings)
+{
+  try
+  {
+    ThreadPool pool;
+    std::string output = settings.meshOutputFile.empty() ? settings.optimizeMeshFile : settings.meshOutputFile;
+    Mesh::OptimizeFile(settings.optimizeMeshFile, output, settings.reduceOverdraw, settings.lodErrors, &pool);
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    return EXIT_FAILURE;
+  }
+  return EXIT_SUCCESS;
+}
+
+int main(int argc, char** argv)
+{
+  ApplicationSettings settings;
+  try
+  {
+    settings = ParseArguments(argc, argv);
+  }
+  catch(const std::exception& e)
+  {
+    std::cerr << "ERROR: " << e.what() << std::endl;
+    PrintUsage(argv[0]);
+    return EXIT_FAILURE;
+  }
+
+  if(!settings.optimizeMeshFile.empty())
+    return OptimizeMesh(settings);
 
-  Application app;
-    app.run();
+  Application app(settings);
+  app.run();
   try
   {
   }
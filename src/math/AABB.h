@@ -0,0 +1,94 @@
+#pragma once
+
+#include <math/Mat4.h>
+#include <math/Vec3.h>
+
+#include <cstddef>
+
+namespace Greet {
+
+  // Axis aligned bounding box
+  struct AABB
+  {
+    Vec3 min;
+    Vec3 max;
+
+    constexpr AABB()
+      : min{0, 0, 0}, max{0, 0, 0}
+    {}
+
+    constexpr AABB(const Vec3& min, const Vec3& max)
+      : min{min}, max{max}
+    {}
+
+    // Smallest box containing all the points, count must not be zero
+    static constexpr AABB FromPoints(const Vec3* points, size_t count)
+    {
+      AABB result(points[0], points[0]);
+      for (size_t i = 1; i < count; i++)
+        result.Expand(points[i]);
+      return result;
+    }
+
+    constexpr Vec3 GetCenter() const
+    {
+      return Vec3((min.x + max.x) * 0.5f, (min.y + max.y) * 0.5f, (min.z + max.z) * 0.5f);
+    }
+
+    // Half of the size along each axis
+    constexpr Vec3 GetExtents() const
+    {
+      return Vec3((max.x - min.x) * 0.5f, (max.y - min.y) * 0.5f, (max.z - min.z) * 0.5f);
+    }
+
+    constexpr AABB& Expand(const Vec3& point)
+    {
+      min = Vec3(point.x < min.x ? point.x : min.x, point.y < min.y ? point.y : min.y, point.z < min.z ? point.z : min.z);
+      max = Vec3(point.x > max.x ? point.x : max.x, point.y > max.y ? point.y : max.y, point.z > max.z ? point.z : max.z);
+      return *this;
+    }
+
+    constexpr AABB& Merge(const AABB& other)
+    {
+      Expand(other.min);
+      return Expand(other.max);
+    }
+
+    constexpr bool Contains(const Vec3& point) const
+    {
+      return point.x >= min.x && point.x <= max.x &&
+        point.y >= min.y && point.y <= max.y &&
+        point.z >= min.z && point.z <= max.z;
+    }
+
+    constexpr bool Intersects(const AABB& other) const
+    {
+      return min.x <= other.max.x && max.x >= other.min.x &&
+        min.y <= other.max.y && max.y >= other.min.y &&
+        min.z <= other.max.z && max.z >= other.min.z;
+    }
+
+    // Box around the transformed box, the extents are moved through the absolute values of the
+    // matrix instead of transforming all eight corners, see Arvo, Graphics Gems 1990
+    constexpr AABB Transform(const Mat4& matrix) const
+    {
+      Vec3 center = GetCenter();
+      Vec3 extents = GetExtents();
+      float c[3] = {};
+      float e[3] = {};
+      for (int row = 0; row < 3; row++)
+      {
+        const float* m = matrix.elements;
+        c[row] = m[row] * center.x + m[4 + row] * center.y + m[8 + row] * center.z + m[12 + row];
+        e[row] = Abs(m[row]) * extents.x + Abs(m[4 + row]) * extents.y + Abs(m[8 + row]) * extents.z;
+      }
+      return AABB(Vec3(c[0] - e[0], c[1] - e[1], c[2] - e[2]), Vec3(c[0] + e[0], c[1] + e[1], c[2] + e[2]));
+    }
+
+    private:
+    static constexpr float Abs(float f)
+    {
+      return f < 0 ? -f : f;
+    }
+  };
+}
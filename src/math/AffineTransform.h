@@ -0,0 +1,189 @@
+#pragma once
+
+#include <math/Mat4.h>
+#include <math/Simd.h>
+#include <math/Vec3.h>
+
+namespace Greet {
+
+  // Affine transform as the upper 3 rows of a Mat4, the bottom row is implicitly (0, 0, 0, 1).
+  // Composition and inversion skip the projective row entirely, which is enough for model and
+  // view matrices. Unlike Mat4 the rows are stored, so that every row fills one SIMD register.
+  struct AffineTransform
+  {
+    // Row-major, elements[row * 4 + 3] is the translation
+    float elements[3 * 4];
+
+    constexpr AffineTransform()
+      : elements{1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0}
+    {}
+
+    // Drops the bottom row, only exact for matrices where it is (0, 0, 0, 1)
+    constexpr explicit AffineTransform(const Mat4& mat)
+      : elements{}
+    {
+      for (int row = 0; row < 3; row++)
+        for (int col = 0; col < 4; col++)
+          elements[row * 4 + col] = mat.elements[col * 4 + row];
+    }
+
+    constexpr Mat4 ToMat4() const
+    {
+      Mat4 result(1.0f);
+      for (int row = 0; row < 3; row++)
+        for (int col = 0; col < 4; col++)
+          result.elements[col * 4 + row] = elements[row * 4 + col];
+      return result;
+    }
+
+    constexpr Vec3 GetTranslation() const
+    {
+      return Vec3(elements[3], elements[7], elements[11]);
+    }
+
+    static constexpr AffineTransform Translate(const Vec3& translation)
+    {
+      AffineTransform result;
+      result.elements[3] = translation.x;
+      result.elements[7] = translation.y;
+      result.elements[11] = translation.z;
+      return result;
+    }
+
+    static constexpr AffineTransform Scale(const Vec3& scaling)
+    {
+      AffineTransform result;
+      result.elements[0] = scaling.x;
+      result.elements[5] = scaling.y;
+      result.elements[10] = scaling.z;
+      return result;
+    }
+
+    static constexpr AffineTransform TransformationMatrix(const Vec3& position, const Vec3& rotation, const Vec3& scale)
+    {
+      return AffineTransform(Mat4::TransformationMatrix(position, rotation, scale));
+    }
+
+    // General affine inverse, the 3x3 part is inverted and the translation is moved back
+    // through it. Singular transforms are returned unchanged, the same as Mat4::Inverse.
+    static constexpr AffineTransform Inverse(const AffineTransform& transform)
+    {
+      const float* e = transform.elements;
+      Vec3 a(e[0], e[4], e[8]);
+      Vec3 b(e[1], e[5], e[9]);
+      Vec3 c(e[2], e[6], e[10]);
+
+      // Rows of the inverse are the cross products of the columns divided by the determinant
+      Vec3 r0 = b.Cross(c);
+      Vec3 r1 = c.Cross(a);
+      Vec3 r2 = a.Cross(b);
+      float det = a.Dot(r0);
+      if (det == 0)
+        return transform;
+
+      float invDet = 1.0f / det;
+      r0 *= invDet;
+      r1 *= invDet;
+      r2 *= invDet;
+      return FromRows(r0, r1, r2, transform.GetTranslation());
+    }
+
+    // Inverse of a rotation and translation, the rotation must be orthonormal so that its
+    // inverse is its transpose
+    static constexpr AffineTransform RigidInverse(const AffineTransform& transform)
+    {
+      const float* e = transform.elements;
+      return FromRows(Vec3(e[0], e[4], e[8]), Vec3(e[1], e[5], e[9]), Vec3(e[2], e[6], e[10]), transform.GetTranslation());
+    }
+
+    constexpr Vec3 TransformPoint(const Vec3& point) const
+    {
+      return Vec3(
+          elements[0] * point.x + elements[1] * point.y + elements[2] * point.z + elements[3],
+          elements[4] * point.x + elements[5] * point.y + elements[6] * point.z + elements[7],
+          elements[8] * point.x + elements[9] * point.y + elements[10] * point.z + elements[11]);
+    }
+
+    constexpr Vec3 TransformVector(const Vec3& vector) const
+    {
+      return Vec3(
+          elements[0] * vector.x + elements[1] * vector.y + elements[2] * vector.z,
+          elements[4] * vector.x + elements[5] * vector.y + elements[6] * vector.z,
+          elements[8] * vector.x + elements[9] * vector.y + elements[10] * vector.z);
+    }
+
+    // Each row of the result is a combination of the other's rows, plus this row's translation
+    constexpr AffineTransform& Multiply(const AffineTransform& other)
+    {
+      if(!GREET_IS_CONSTANT_EVALUATED())
+        return MultiplySimd(other);
+
+      float data[12] = {};
+      for (int row = 0; row < 3; row++)
+      {
+        const float* a = elements + row * 4;
+        for (int col = 0; col < 4; col++)
+          data[row * 4 + col] = a[0] * other.elements[col] + a[1] * other.elements[4 + col] + a[2] * other.elements[8 + col];
+        data[row * 4 + 3] += a[3];
+      }
+      for (int i = 0; i < 12; i++)
+        elements[i] = data[i];
+      return *this;
+    }
+
+    friend constexpr AffineTransform operator*(AffineTransform first, const AffineTransform& second)
+    {
+      return first.Multiply(second);
+    }
+
+    constexpr AffineTransform& operator*=(const AffineTransform& other)
+    {
+      return Multiply(other);
+    }
+
+    friend constexpr Vec3 operator*(const AffineTransform& first, const Vec3& second)
+    {
+      return first.TransformPoint(second);
+    }
+
+    friend constexpr AffineTransform operator~(const AffineTransform& first)
+    {
+      return AffineTransform::Inverse(first);
+    }
+
+    private:
+    // The inverse with the given rows as linear part, its translation is -inverse * translation
+    static constexpr AffineTransform FromRows(const Vec3& r0, const Vec3& r1, const Vec3& r2, const Vec3& translation)
+    {
+      AffineTransform result;
+      const Vec3* rows[3] = {&r0, &r1, &r2};
+      for (int row = 0; row < 3; row++)
+      {
+        result.elements[row * 4] = rows[row]->x;
+        result.elements[row * 4 + 1] = rows[row]->y;
+        result.elements[row * 4 + 2] = rows[row]->z;
+        result.elements[row * 4 + 3] = -rows[row]->Dot(translation);
+      }
+      return result;
+    }
+
+    AffineTransform& MultiplySimd(const AffineTransform& other)
+    {
+      using namespace Simd;
+      Float4 b0 = Load(other.elements + 0);
+      Float4 b1 = Load(other.elements + 4);
+      Float4 b2 = Load(other.elements + 8);
+      // Only the translation lane survives the mask
+      Float4 translationMask = Set(0.0f, 0.0f, 0.0f, 1.0f);
+      for (int row = 0; row < 3; row++)
+      {
+        Float4 a = Load(elements + row * 4);
+        Float4 sum = Mul(Broadcast<0>(a), b0);
+        sum = MulAdd(Broadcast<1>(a), b1, sum);
+        sum = MulAdd(Broadcast<2>(a), b2, sum);
+        Store(elements + row * 4, MulAdd(a, translationMask, sum));
+      }
+      return *this;
+    }
+  };
+}
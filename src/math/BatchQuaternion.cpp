@@ -0,0 +1,89 @@
+#include "BatchQuaternion.h"
+
+#include <math/Simd.h>
+#include <ThreadPool.h>
+
+namespace Greet { namespace BatchQuaternion {
+
+  using namespace Simd;
+
+  static_assert(sizeof(Quaternion) == 4 * sizeof(float), "Quaternion arrays are loaded as plain floats");
+
+  static const size_t PARALLEL_BATCH_SIZE = 1 << 12;
+
+  template <typename Function>
+  static void Dispatch(size_t count, ThreadPool* pool, const Function& function)
+  {
+    if(pool && count >= PARALLEL_THRESHOLD)
+      pool->ParallelFor(count, PARALLEL_BATCH_SIZE, function);
+    else
+      function(0, count);
+  }
+
+  static void NlerpRange(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t begin, size_t end)
+  {
+    size_t i = begin;
+    // Transposed so that each register holds one component of four quaternions
+    for(; i + 4 <= end; i += 4)
+    {
+      Float4 ax = Load(&from[i].x), ay = Load(&from[i + 1].x), az = Load(&from[i + 2].x), aw = Load(&from[i + 3].x);
+      Float4 bx = Load(&to[i].x), by = Load(&to[i + 1].x), bz = Load(&to[i + 2].x), bw = Load(&to[i + 3].x);
+      Transpose(ax, ay, az, aw);
+      Transpose(bx, by, bz, bw);
+
+      // Shortest path, to is negated where the dot product is negative
+      Float4 dot = MulAdd(ax, bx, MulAdd(ay, by, MulAdd(az, bz, Mul(aw, bw))));
+      Float4 tt = Load(t + i);
+      Float4 rx = MulAdd(Sub(FlipSign(bx, dot), ax), tt, ax);
+      Float4 ry = MulAdd(Sub(FlipSign(by, dot), ay), tt, ay);
+      Float4 rz = MulAdd(Sub(FlipSign(bz, dot), az), tt, az);
+      Float4 rw = MulAdd(Sub(FlipSign(bw, dot), aw), tt, aw);
+
+      Float4 invLength = Div(Splat(1.0f), Sqrt(MulAdd(rx, rx, MulAdd(ry, ry, MulAdd(rz, rz, Mul(rw, rw))))));
+      rx = Mul(rx, invLength);
+      ry = Mul(ry, invLength);
+      rz = Mul(rz, invLength);
+      rw = Mul(rw, invLength);
+
+      Transpose(rx, ry, rz, rw);
+      Store(&out[i].x, rx);
+      Store(&out[i + 1].x, ry);
+      Store(&out[i + 2].x, rz);
+      Store(&out[i + 3].x, rw);
+    }
+    for(; i < end; i++)
+      out[i] = Quaternion::Nlerp(from[i], to[i], t[i]);
+  }
+
+  void Nlerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end) { NlerpRange(from, to, t, out, begin, end); });
+  }
+
+  void Slerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end)
+    {
+      for(size_t i = begin; i < end; i++)
+        out[i] = Quaternion::Slerp(from[i], to[i], t[i]);
+    });
+  }
+
+  void Rotate(const Quaternion* rotations, const Vec3* in, Vec3* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end)
+    {
+      for(size_t i = begin; i < end; i++)
+        out[i] = rotations[i].Rotate(in[i]);
+    });
+  }
+
+  void ToMat4(const Quaternion* rotations, Mat4* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end)
+    {
+      for(size_t i = begin; i < end; i++)
+        out[i] = rotations[i].ToMat4();
+    });
+  }
+}}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <math/Quaternion.h>
+#include <cstddef>
+
+class ThreadPool;
+
+namespace Greet {
+
+  // Interpolates and converts whole arrays of quaternions, for example every animation track of
+  // a frame at once. Element i of the outputs is computed from element i of every input, the
+  // output may be the same array as one of the inputs. With a pool, arrays of at least
+  // PARALLEL_THRESHOLD elements are split across its threads.
+  namespace BatchQuaternion {
+    const size_t PARALLEL_THRESHOLD = 1 << 14;
+
+    // Four quaternions at a time with SIMD, see Quaternion::Nlerp
+    void Nlerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count, ThreadPool* pool = nullptr);
+    // See Quaternion::Slerp, one element at a time and over 10 times the cost of Nlerp
+    // because of acos and sin
+    void Slerp(const Quaternion* from, const Quaternion* to, const float* t, Quaternion* out, size_t count, ThreadPool* pool = nullptr);
+
+    void Rotate(const Quaternion* rotations, const Vec3* in, Vec3* out, size_t count, ThreadPool* pool = nullptr);
+    void ToMat4(const Quaternion* rotations, Mat4* out, size_t count, ThreadPool* pool = nullptr);
+  }
+}
@@ -0,0 +1,174 @@
+#include "BatchTransform.h"
+
+#include <math/Simd.h>
+#include <ThreadPool.h>
+
+namespace Greet { namespace BatchTransform {
+
+  using namespace Simd;
+
+  static_assert(sizeof(Vec3) == 3 * sizeof(float), "Packed transforms load Vec3 arrays as plain floats");
+
+  // Small enough that the threads balance well, large enough to amortize the scheduling
+  static const size_t PARALLEL_BATCH_SIZE = 1 << 14;
+
+  // Rows of the upper 3x4 part of a matrix with each element splatted, used on 4 elements at a time
+  struct SplatRows
+  {
+    Float4 m[3][4];
+
+    SplatRows(const Mat4& matrix, float w)
+    {
+      for(int row = 0; row < 3; row++)
+      {
+        for(int col = 0; col < 3; col++)
+          m[row][col] = Splat(matrix.elements[col * 4 + row]);
+        m[row][3] = Splat(matrix.elements[12 + row] * w);
+      }
+    }
+
+    void Transform(Float4 x, Float4 y, Float4 z, Float4& outX, Float4& outY, Float4& outZ) const
+    {
+      outX = MulAdd(m[0][0], x, MulAdd(m[0][1], y, MulAdd(m[0][2], z, m[0][3])));
+      outY = MulAdd(m[1][0], x, MulAdd(m[1][1], y, MulAdd(m[1][2], z, m[1][3])));
+      outZ = MulAdd(m[2][0], x, MulAdd(m[2][1], y, MulAdd(m[2][2], z, m[2][3])));
+    }
+  };
+
+  template <typename Function>
+  static void Dispatch(size_t count, ThreadPool* pool, const Function& function)
+  {
+    if(pool && count >= PARALLEL_THRESHOLD)
+      pool->ParallelFor(count, PARALLEL_BATCH_SIZE, function);
+    else
+      function(0, count);
+  }
+
+  static void TransformPacked(const Mat4& matrix, float w, const Vec3* in, Vec3* out, size_t begin, size_t end)
+  {
+    SplatRows rows(matrix, w);
+    size_t i = begin;
+    // Four Vec3 are three Float4, they are deinterleaved into x, y and z lanes and back
+    for(; i + 4 <= end; i += 4)
+    {
+      const float* src = in[i].vals;
+      Float4 l0 = Load(src + 0);
+      Float4 l1 = Load(src + 4);
+      Float4 l2 = Load(src + 8);
+      Float4 x = Shuffle<0, 3, 0, 2>(l0, Shuffle<2, 2, 1, 1>(l1, l2));
+      Float4 y = Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 0, 0>(l0, l1), Shuffle<3, 3, 2, 2>(l1, l2));
+      Float4 z = Shuffle<0, 2, 0, 3>(Shuffle<2, 2, 1, 1>(l0, l1), l2);
+
+      Float4 rx, ry, rz;
+      rows.Transform(x, y, z, rx, ry, rz);
+
+      float* dst = out[i].vals;
+      Store(dst + 0, Shuffle<0, 2, 0, 2>(Shuffle<0, 0, 0, 0>(rx, ry), Shuffle<0, 0, 1, 1>(rz, rx)));
+      Store(dst + 4, Shuffle<0, 2, 0, 2>(Shuffle<1, 1, 1, 1>(ry, rz), Shuffle<2, 2, 2, 2>(rx, ry)));
+      Store(dst + 8, Shuffle<0, 2, 0, 2>(Shuffle<2, 2, 3, 3>(rz, rx), Shuffle<3, 3, 3, 3>(ry, rz)));
+    }
+    for(; i < end; i++)
+    {
+      Vec4 result = matrix.Multiply(Vec4(in[i].x, in[i].y, in[i].z, w));
+      out[i] = Vec3(result.x, result.y, result.z);
+    }
+  }
+
+  static void TransformStrided(const Mat4& matrix, float w, const Vec3* in, size_t inStride, Vec3* out, size_t outStride, size_t begin, size_t end)
+  {
+    SplatRows rows(matrix, w);
+    const char* src = reinterpret_cast<const char*>(in) + begin * inStride;
+    char* dst = reinterpret_cast<char*>(out) + begin * outStride;
+    size_t i = begin;
+    // Gathered into lanes so that the math is still done 4 elements at a time
+    for(; i + 4 <= end; i += 4)
+    {
+      const float* p0 = reinterpret_cast<const float*>(src);
+      const float* p1 = reinterpret_cast<const float*>(src + inStride);
+      const float* p2 = reinterpret_cast<const float*>(src + 2 * inStride);
+      const float* p3 = reinterpret_cast<const float*>(src + 3 * inStride);
+      Float4 x = Set(p0[0], p1[0], p2[0], p3[0]);
+      Float4 y = Set(p0[1], p1[1], p2[1], p3[1]);
+      Float4 z = Set(p0[2], p1[2], p2[2], p3[2]);
+
+      Float4 r[3];
+      rows.Transform(x, y, z, r[0], r[1], r[2]);
+
+      float lanes[3][4];
+      for(int c = 0; c < 3; c++)
+        Store(lanes[c], r[c]);
+      for(int j = 0; j < 4; j++)
+      {
+        float* d = reinterpret_cast<float*>(dst + j * outStride);
+        d[0] = lanes[0][j];
+        d[1] = lanes[1][j];
+        d[2] = lanes[2][j];
+      }
+      src += 4 * inStride;
+      dst += 4 * outStride;
+    }
+    for(; i < end; i++)
+    {
+      const float* s = reinterpret_cast<const float*>(src);
+      Vec4 result = matrix.Multiply(Vec4(s[0], s[1], s[2], w));
+      float* d = reinterpret_cast<float*>(dst);
+      d[0] = result.x;
+      d[1] = result.y;
+      d[2] = result.z;
+      src += inStride;
+      dst += outStride;
+    }
+  }
+
+  void TransformPoints(const Mat4& matrix, const Vec3* in, Vec3* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end) { TransformPacked(matrix, 1.0f, in, out, begin, end); });
+  }
+
+  void TransformVectors(const Mat4& matrix, const Vec3* in, Vec3* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end) { TransformPacked(matrix, 0.0f, in, out, begin, end); });
+  }
+
+  void TransformPoints(const Mat4& matrix, const Vec3* in, Vec4* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end)
+    {
+      Float4 c0 = Load(matrix.elements + 0);
+      Float4 c1 = Load(matrix.elements + 4);
+      Float4 c2 = Load(matrix.elements + 8);
+      Float4 c3 = Load(matrix.elements + 12);
+      for(size_t i = begin; i < end; i++)
+        Store(out[i].vals, MulAdd(c0, Splat(in[i].x), MulAdd(c1, Splat(in[i].y), MulAdd(c2, Splat(in[i].z), c3))));
+    });
+  }
+
+  void TransformPoints(const Mat4& matrix, const Vec4* in, Vec4* out, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end)
+    {
+      Float4 c0 = Load(matrix.elements + 0);
+      Float4 c1 = Load(matrix.elements + 4);
+      Float4 c2 = Load(matrix.elements + 8);
+      Float4 c3 = Load(matrix.elements + 12);
+      for(size_t i = begin; i < end; i++)
+      {
+        Float4 v = Load(in[i].vals);
+        Float4 sum = Mul(c0, Broadcast<0>(v));
+        sum = MulAdd(c1, Broadcast<1>(v), sum);
+        sum = MulAdd(c2, Broadcast<2>(v), sum);
+        Store(out[i].vals, MulAdd(c3, Broadcast<3>(v), sum));
+      }
+    });
+  }
+
+  void TransformPoints(const Mat4& matrix, const Vec3* in, size_t inStride, Vec3* out, size_t outStride, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end) { TransformStrided(matrix, 1.0f, in, inStride, out, outStride, begin, end); });
+  }
+
+  void TransformVectors(const Mat4& matrix, const Vec3* in, size_t inStride, Vec3* out, size_t outStride, size_t count, ThreadPool* pool)
+  {
+    Dispatch(count, pool, [&](size_t begin, size_t end) { TransformStrided(matrix, 0.0f, in, inStride, out, outStride, begin, end); });
+  }
+}}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <math/Mat4.h>
+#include <cstddef>
+
+class ThreadPool;
+
+namespace Greet {
+
+  // Transforms whole arrays by one matrix. Points are transformed with w = 1 and vectors with
+  // w = 0, the Vec3 outputs drop w so they are only meaningful for affine matrices. Input and
+  // output may be the same array. With a pool, arrays of at least PARALLEL_THRESHOLD elements
+  // are split across its threads.
+  namespace BatchTransform {
+    const size_t PARALLEL_THRESHOLD = 1 << 16;
+
+    void TransformPoints(const Mat4& matrix, const Vec3* in, Vec3* out, size_t count, ThreadPool* pool = nullptr);
+    void TransformVectors(const Mat4& matrix, const Vec3* in, Vec3* out, size_t count, ThreadPool* pool = nullptr);
+    // Keeps w, for example to get clip space positions
+    void TransformPoints(const Mat4& matrix, const Vec3* in, Vec4* out, size_t count, ThreadPool* pool = nullptr);
+    void TransformPoints(const Mat4& matrix, const Vec4* in, Vec4* out, size_t count, ThreadPool* pool = nullptr);
+
+    // Stride aware variants for interleaved data, the strides are in bytes and the pointers
+    // point to the first element's x, for example:
+    //   TransformPoints(m, &vertices[0].position, sizeof(Vertex), &out[0].position, sizeof(Vertex), n)
+    void TransformPoints(const Mat4& matrix, const Vec3* in, size_t inStride, Vec3* out, size_t outStride, size_t count, ThreadPool* pool = nullptr);
+    void TransformVectors(const Mat4& matrix, const Vec3* in, size_t inStride, Vec3* out, size_t outStride, size_t count, ThreadPool* pool = nullptr);
+  }
+}
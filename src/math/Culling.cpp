@@ -0,0 +1,166 @@
+#include "Culling.h"
+
+#include <math/Simd.h>
+#include <ThreadPool.h>
+
+#include <cstring>
+#include <vector>
+
+namespace Greet { namespace Culling {
+
+  using namespace Simd;
+
+  static_assert(sizeof(Sphere) == 4 * sizeof(float), "Sphere arrays are loaded as plain floats");
+
+  static const size_t PARALLEL_BATCH_SIZE = 1 << 13;
+
+  // The frustum planes with each component splatted
+  struct SplatPlanes
+  {
+    Float4 x[6];
+    Float4 y[6];
+    Float4 z[6];
+    Float4 w[6];
+
+    SplatPlanes(const Frustum& frustum)
+    {
+      for(int i = 0; i < 6; i++)
+      {
+        x[i] = Splat(frustum.planes[i].x);
+        y[i] = Splat(frustum.planes[i].y);
+        z[i] = Splat(frustum.planes[i].z);
+        w[i] = Splat(frustum.planes[i].w);
+      }
+    }
+
+    Float4 Distance(int i, Float4 px, Float4 py, Float4 pz) const
+    {
+      return MulAdd(x[i], px, MulAdd(y[i], py, MulAdd(z[i], pz, w[i])));
+    }
+  };
+
+  // Appends index + j for every lane j whose sign bit is clear, without branches
+  static inline size_t Append(int culled, uint32_t index, uint32_t* visible, size_t visibleCount)
+  {
+    for(int j = 0; j < 4; j++)
+    {
+      visible[visibleCount] = index + j;
+      visibleCount += ((culled >> j) & 1) ^ 1;
+    }
+    return visibleCount;
+  }
+
+  static size_t CullSpheresRange(const Frustum& frustum, const Sphere* spheres, size_t begin, size_t end, uint32_t* visible)
+  {
+    SplatPlanes planes(frustum);
+    size_t visibleCount = 0;
+    size_t i = begin;
+    for(; i + 4 <= end; i += 4)
+    {
+      Float4 x = Load(&spheres[i].center.x);
+      Float4 y = Load(&spheres[i + 1].center.x);
+      Float4 z = Load(&spheres[i + 2].center.x);
+      Float4 r = Load(&spheres[i + 3].center.x);
+      Transpose(x, y, z, r);
+
+      // The smallest signed distance of the sphere's surface to any plane, negative if outside
+      Float4 nearest = Add(planes.Distance(0, x, y, z), r);
+      for(int p = 1; p < 6; p++)
+        nearest = Min(nearest, Add(planes.Distance(p, x, y, z), r));
+      visibleCount = Append(SignMask(nearest), (uint32_t)i, visible, visibleCount);
+    }
+    for(; i < end; i++)
+    {
+      if(frustum.Intersects(spheres[i]))
+        visible[visibleCount++] = (uint32_t)i;
+    }
+    return visibleCount;
+  }
+
+  static size_t CullAABBsRange(const Frustum& frustum, const AABB* boxes, size_t begin, size_t end, uint32_t* visible)
+  {
+    SplatPlanes planes(frustum);
+    Float4 absX[6], absY[6], absZ[6];
+    for(int p = 0; p < 6; p++)
+    {
+      absX[p] = Abs(planes.x[p]);
+      absY[p] = Abs(planes.y[p]);
+      absZ[p] = Abs(planes.z[p]);
+    }
+
+    Float4 half = Splat(0.5f);
+    size_t visibleCount = 0;
+    size_t i = begin;
+    for(; i + 4 <= end; i += 4)
+    {
+      const AABB* b = boxes + i;
+      Float4 minX = Set(b[0].min.x, b[1].min.x, b[2].min.x, b[3].min.x);
+      Float4 minY = Set(b[0].min.y, b[1].min.y, b[2].min.y, b[3].min.y);
+      Float4 minZ = Set(b[0].min.z, b[1].min.z, b[2].min.z, b[3].min.z);
+      Float4 maxX = Set(b[0].max.x, b[1].max.x, b[2].max.x, b[3].max.x);
+      Float4 maxY = Set(b[0].max.y, b[1].max.y, b[2].max.y, b[3].max.y);
+      Float4 maxZ = Set(b[0].max.z, b[1].max.z, b[2].max.z, b[3].max.z);
+      Float4 cx = Mul(Add(minX, maxX), half);
+      Float4 cy = Mul(Add(minY, maxY), half);
+      Float4 cz = Mul(Add(minZ, maxZ), half);
+      Float4 ex = Mul(Sub(maxX, minX), half);
+      Float4 ey = Mul(Sub(maxY, minY), half);
+      Float4 ez = Mul(Sub(maxZ, minZ), half);
+
+      // Signed distance of the corner furthest along each plane's normal, negative if outside
+      auto cornerDistance = [&](int p)
+      {
+        Float4 radius = MulAdd(absX[p], ex, MulAdd(absY[p], ey, Mul(absZ[p], ez)));
+        return Add(planes.Distance(p, cx, cy, cz), radius);
+      };
+      Float4 nearest = cornerDistance(0);
+      for(int p = 1; p < 6; p++)
+        nearest = Min(nearest, cornerDistance(p));
+      visibleCount = Append(SignMask(nearest), (uint32_t)i, visible, visibleCount);
+    }
+    for(; i < end; i++)
+    {
+      if(frustum.Intersects(boxes[i]))
+        visible[visibleCount++] = (uint32_t)i;
+    }
+    return visibleCount;
+  }
+
+  // Every batch culls into its own part of visible, the parts are then moved together
+  template <typename Function>
+  static size_t Dispatch(size_t count, uint32_t* visible, ThreadPool* pool, const Function& function)
+  {
+    if(!pool || count < PARALLEL_THRESHOLD)
+      return function(0, count, visible);
+
+    std::vector<size_t> batchCounts((count + PARALLEL_BATCH_SIZE - 1) / PARALLEL_BATCH_SIZE);
+    pool->ParallelFor(count, PARALLEL_BATCH_SIZE, [&](size_t begin, size_t end)
+    {
+      batchCounts[begin / PARALLEL_BATCH_SIZE] = function(begin, end, visible + begin);
+    });
+
+    size_t visibleCount = batchCounts[0];
+    for(size_t batch = 1; batch < batchCounts.size(); batch++)
+    {
+      memmove(visible + visibleCount, visible + batch * PARALLEL_BATCH_SIZE, batchCounts[batch] * sizeof(uint32_t));
+      visibleCount += batchCounts[batch];
+    }
+    return visibleCount;
+  }
+
+  size_t CullSpheres(const Frustum& frustum, const Sphere* spheres, size_t count, uint32_t* visible, ThreadPool* pool)
+  {
+    return Dispatch(count, visible, pool, [&](size_t begin, size_t end, uint32_t* out)
+    {
+      return CullSpheresRange(frustum, spheres, begin, end, out);
+    });
+  }
+
+  size_t CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, uint32_t* visible, ThreadPool* pool)
+  {
+    return Dispatch(count, visible, pool, [&](size_t begin, size_t end, uint32_t* out)
+    {
+      return CullAABBsRange(frustum, boxes, begin, end, out);
+    });
+  }
+}}
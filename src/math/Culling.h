@@ -0,0 +1,25 @@
+#pragma once
+
+#include <math/AABB.h>
+#include <math/Frustum.h>
+#include <math/Sphere.h>
+
+#include <cstddef>
+#include <cstdint>
+
+class ThreadPool;
+
+namespace Greet {
+
+  // Frustum culling of whole arrays of bounds, four at a time against all six planes. The
+  // indices of the bounds that intersect the frustum are written to visible in ascending order
+  // and their number is returned, visible needs room for count indices. The results match
+  // Frustum::Intersects apart from rounding for bounds that touch a plane. With a pool, arrays
+  // of at least PARALLEL_THRESHOLD elements are split across its threads.
+  namespace Culling {
+    const size_t PARALLEL_THRESHOLD = 1 << 15;
+
+    size_t CullSpheres(const Frustum& frustum, const Sphere* spheres, size_t count, uint32_t* visible, ThreadPool* pool = nullptr);
+    size_t CullAABBs(const Frustum& frustum, const AABB* boxes, size_t count, uint32_t* visible, ThreadPool* pool = nullptr);
+  }
+}
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <math/AABB.h>
+#include <math/Mat4.h>
+#include <math/Sphere.h>
+#include <math/Vec3.h>
+#include <math/Vec4.h>
+
+namespace Greet {
+
+  // View frustum as six planes with normalized normals pointing inwards, a point p is on the
+  // inside of a plane when dot(plane.xyz, p) + plane.w >= 0
+  struct Frustum
+  {
+    // Left, right, bottom, top, near and far
+    Vec4 planes[6];
+
+    constexpr Frustum()
+      : planes{}
+    {}
+
+    // Planes from the rows of a view projection matrix, see Gribb and Hartmann, "Fast Extraction
+    // of Viewing Frustum Planes from the World-View-Projection Matrix". Mat4::ProjectionMatrix
+    // maps depth to [-1, 1], projections that map it to [0, 1] need zeroToOneDepth.
+    constexpr explicit Frustum(const Mat4& viewProjection, bool zeroToOneDepth = false)
+      : planes{}
+    {
+      const float* m = viewProjection.elements;
+      Vec4 rows[4];
+      for (int row = 0; row < 4; row++)
+        rows[row] = Vec4(m[row], m[4 + row], m[8 + row], m[12 + row]);
+
+      planes[0] = rows[3] + rows[0];
+      planes[1] = rows[3] - rows[0];
+      planes[2] = rows[3] + rows[1];
+      planes[3] = rows[3] - rows[1];
+      planes[4] = zeroToOneDepth ? rows[2] : rows[3] + rows[2];
+      planes[5] = rows[3] - rows[2];
+
+      for (int i = 0; i < 6; i++)
+      {
+        Vec4& plane = planes[i];
+        float length = Math::Sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+        plane = Vec4(plane.x / length, plane.y / length, plane.z / length, plane.w / length);
+      }
+    }
+
+    constexpr bool Contains(const Vec3& point) const
+    {
+      for (int i = 0; i < 6; i++)
+      {
+        if (Distance(planes[i], point) < 0)
+          return false;
+      }
+      return true;
+    }
+
+    // Conservative, spheres outside of the frustum but near a corner can still intersect
+    constexpr bool Intersects(const Sphere& sphere) const
+    {
+      for (int i = 0; i < 6; i++)
+      {
+        if (Distance(planes[i], sphere.center) + sphere.radius < 0)
+          return false;
+      }
+      return true;
+    }
+
+    // Conservative the same way as for spheres
+    constexpr bool Intersects(const AABB& box) const
+    {
+      Vec3 center = box.GetCenter();
+      Vec3 extents = box.GetExtents();
+      for (int i = 0; i < 6; i++)
+      {
+        const Vec4& plane = planes[i];
+        // Distance from the center to the box corner furthest along the normal
+        float radius =
+          (plane.x < 0 ? -plane.x : plane.x) * extents.x +
+          (plane.y < 0 ? -plane.y : plane.y) * extents.y +
+          (plane.z < 0 ? -plane.z : plane.z) * extents.z;
+        if (Distance(plane, center) + radius < 0)
+          return false;
+      }
+      return true;
+    }
+
+    private:
+    static constexpr float Distance(const Vec4& plane, const Vec3& point)
+    {
+      return plane.x * point.x + plane.y * point.y + plane.z * point.z + plane.w;
+    }
+  };
+}
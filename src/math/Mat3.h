@@ -1,5 +1,6 @@
 #pragma once
 
+#include <math/Scalar.h>
 #include <math/Vec2.h>
 #include <math/Vec3.h>
 
@@ -15,43 +16,218 @@ namespace Greet{
       };
     };
 
-    Mat3();
-    Mat3(float diagonal);
-    Mat3(float* elem);
+    constexpr Mat3()
+      : elements{}
+    {}
+
+    constexpr Mat3(float diagonal)
+      : elements{diagonal, 0, 0, 0, diagonal, 0, 0, 0, diagonal}
+    {}
+
+    constexpr Mat3(const float* elem)
+      : elements{}
+    {
+      for (int i = 0;i < 9;i++)
+        elements[i] = elem[i];
+    }
 
     Vec3 getColumn(int index)
     {
       return columns[index];
     }
 
-    static Mat3 Identity();
-    static Mat3 Orthographic(float left, float right, float top, float bottom);
-    static Mat3 Quad(float x, float y, float width, float height);
-    static Mat3 Quad(const Vec2& pos, const Vec2& size);
+    static constexpr Mat3 Identity()
+    {
+      return Mat3(1.0f);
+    }
+
+    static constexpr Mat3 Orthographic(float left, float right, float top, float bottom)
+    {
+      Mat3 result(1.0f);
+
+      result.elements[0] = 2.0f / (right - left);
+      result.elements[4] = 2.0f / (top - bottom);
+      result.elements[6] = -(right + left) / (right - left);
+      result.elements[7] = -(top + bottom) / (top - bottom);
+
+      return result;
+    }
+
+    static constexpr Mat3 Quad(float x, float y, float width, float height)
+    {
+      Mat3 result(1.0f);
+
+      result.elements[6] = x;
+      result.elements[7] = y;
+      result.elements[0] = width;
+      result.elements[4] = height;
+
+      return result;
+    }
+
+    static constexpr Mat3 Quad(const Vec2& pos, const Vec2& size)
+    {
+      return Quad(pos.x, pos.y, size.x, size.y);
+    }
+
+    static constexpr Mat3 Translate(const Vec2& translation)
+    {
+      return Translate(translation.x, translation.y);
+    }
+
+    static constexpr Mat3 Scale(const Vec2& scaling)
+    {
+      return Scale(scaling.x, scaling.y);
+    }
+
+    static constexpr Mat3 Shear(const Vec2& shearing)
+    {
+      return Shear(shearing.x, shearing.y);
+    }
+
+    static constexpr Mat3 Translate(const float& x, const float& y)
+    {
+      Mat3 result(1.0f);
+
+      result.elements[6] = x;
+      result.elements[7] = y;
+
+      return result;
+    }
+
+    static constexpr Mat3 Scale(const float& x, const float& y)
+    {
+      Mat3 result(1.0f);
+
+      result.elements[0] = x;
+      result.elements[4] = y;
+
+      return result;
+    }
+
+    static constexpr Mat3 Rotate(float deg)
+    {
+      return RotateR(Math::ToRadians(deg));
+    }
+
+    static constexpr Mat3 RotateR(float rad)
+    {
+      Mat3 result(1.0f);
+      float s = Math::Sin(rad);
+      float c = Math::Cos(rad);
+
+      result.elements[0] = c;
+      result.elements[1] = s;
+      result.elements[3] = -s;
+      result.elements[4] = c;
+
+      return result;
+    }
+
+    static constexpr Mat3 Shear(const float& x, const float& y)
+    {
+      Mat3 result(1.0f);
+
+      result.elements[3] = x;
+      result.elements[1] = y;
+
+      return result;
+    }
+
+    static constexpr Mat3 Inverse(const Mat3& mat)
+    {
+      float temp[9] = {};
+
+      temp[0] = mat.elements[4] * mat.elements[8] - mat.elements[7] * mat.elements[5];
+      temp[1] = mat.elements[7] * mat.elements[2] - mat.elements[1] * mat.elements[8];
+      temp[2] = mat.elements[1] * mat.elements[5] - mat.elements[4] * mat.elements[2];
+      temp[3] = mat.elements[6] * mat.elements[5] - mat.elements[3] * mat.elements[8];
+      temp[4] = mat.elements[0] * mat.elements[8] - mat.elements[6] * mat.elements[2];
+      temp[5] = mat.elements[3] * mat.elements[2] - mat.elements[0] * mat.elements[5];
+      temp[6] = mat.elements[3] * mat.elements[7] - mat.elements[6] * mat.elements[4];
+      temp[7] = mat.elements[6] * mat.elements[1] - mat.elements[0] * mat.elements[7];
+      temp[8] = mat.elements[0] * mat.elements[4] - mat.elements[3] * mat.elements[1];
+
+      float det = mat.elements[0] * temp[0] + mat.elements[3] * temp[1] + mat.elements[6] * temp[2];
+
+      if (det == 0)
+        return mat;
+
+      det = 1.0f / det;
+
+      Mat3 res = mat;
+
+      for (int i = 0; i < 9; i++)
+        res.elements[i] = temp[i] * det;
+
+      return res;
+    }
+
+    constexpr Mat3 Cpy() const
+    {
+      return Mat3(elements);
+    }
 
-    static Mat3 Translate(const Vec2& translation);
-    static Mat3 Scale(const Vec2& scaling);
-    static Mat3 Shear(const Vec2& shearing);
+    constexpr Mat3& Multiply(const Mat3 &other)
+    {
+      float data[9] = {};
+      for (int row = 0; row < 3; row++)
+      {
+        for (int col = 0; col < 3; col++)
+        {
+          float sum = 0.0f;
+          for (int e = 0; e < 3; e++)
+          {
+            sum += elements[col + e * 3] * other.elements[e + row * 3];
+          }
+          data[col + row * 3] = sum;
+        }
+      }
+      for (int i = 0; i < 9; i++)
+        elements[i] = data[i];
 
-    static Mat3 Translate(const float& x, const float& y);
-    static Mat3 Scale(const float& x, const float& y);
-    static Mat3 Rotate(float deg);
-    static Mat3 RotateR(float rad);
-    static Mat3 Shear(const float& x, const float& y);
+      return *this;
+    }
 
-    static Mat3 Inverse(const Mat3& mat);
-    Mat3 Cpy();
+    constexpr Vec2 Multiply(const Vec2 &other) const
+    {
+      float x = elements[0] * other.x + elements[3] * other.y + elements[6];
+      float y = elements[1] * other.x + elements[4] * other.y + elements[7];
+      return Vec2(x, y);
+    }
 
-    Mat3& Multiply(const Mat3 &other);
-    Vec2 Multiply(const Vec2 &other) const;
-    Vec3 Multiply(const Vec3 &other) const;
+    constexpr Vec3 Multiply(const Vec3 &other) const
+    {
+      float x = elements[0] * other.x + elements[3] * other.y + elements[6] * other.z;
+      float y = elements[1] * other.x + elements[4] * other.y + elements[7] * other.z;
+      float z = elements[2] * other.x + elements[5] * other.y + elements[8] * other.z;
+      return Vec3(x,y,z);
+    }
 
-    friend Mat3 operator*(Mat3 first, const Mat3 &second);
-    Mat3& operator*=(const Mat3 &other);
+    friend constexpr Mat3 operator*(Mat3 first, const Mat3 &second)
+    {
+      return first.Multiply(second);
+    }
 
-    friend Vec2 operator*(const Mat3& first, const Vec2 &second);
-    friend Vec3 operator*(const Mat3& first, const Vec3 &second);
-    friend Mat3 operator~(const Mat3& first);
+    constexpr Mat3& operator*=(const Mat3 &other)
+    {
+      return Multiply(other);
+    }
+
+    friend constexpr Vec2 operator*(const Mat3& first, const Vec2 &second)
+    {
+      return first.Multiply(second);
+    }
+
+    friend constexpr Vec3 operator*(const Mat3& first, const Vec3 &second)
+    {
+      return first.Multiply(second);
+    }
+
+    friend constexpr Mat3 operator~(const Mat3& first)
+    {
+      return Mat3::Inverse(first);
+    }
 
   };
 }
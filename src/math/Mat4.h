@@ -1,5 +1,7 @@
 #pragma once
 
+#include <math/Scalar.h>
+#include <math/Simd.h>
 #include <math/Vec2.h>
 #include <math/Vec3.h>
 #include <math/Vec4.h>
@@ -16,64 +18,461 @@ namespace Greet {
       };
     };
 
-    Mat4();
-    Mat4(float diagonal);
-    Mat4(float* elem);
+    constexpr Mat4()
+      : elements{}
+    {}
+
+    constexpr Mat4(float diagonal)
+      : elements{diagonal, 0, 0, 0, 0, diagonal, 0, 0, 0, 0, diagonal, 0, 0, 0, 0, diagonal}
+    {}
+
+    constexpr Mat4(const float* elem)
+      : elements{}
+    {
+      for (int i = 0; i < 16; i++)
+        elements[i] = elem[i];
+    }
 
     Vec4 GetColumn(int index)
     {
       return columns[index];
     }
 
-    static Mat4 Identity();
-    static Mat4 Orthographic(float left, float right, float top, float bottom, float near, float far);
-    static Mat4 ProjectionMatrix(float aspect, float fov, float near, float far);
+    static constexpr Mat4 Identity()
+    {
+      return Mat4(1.0f);
+    }
+
+    static constexpr Mat4 Orthographic(float left, float right, float top, float bottom, float near, float far)
+    {
+      Mat4 result(1.0f);
+
+      result.elements[0] = 2.0f / (right - left);
+      result.elements[5] = 2.0f / (top - bottom);
+      result.elements[10] = -2.0f / (far- near);
+      result.elements[12] = -(right + left) / (right - left);
+      result.elements[13] = -(top + bottom) / (top - bottom);
+      result.elements[14] = -(far + near) / (far - near);
+
+      return result;
+    }
+
+    static constexpr Mat4 ProjectionMatrix(float aspect, float fov, float near, float far)
+    {
+      Mat4 result(1.0f);
+      float tan2 = 1.0f / Math::Tan(Math::ToRadians(fov * 0.5f));
+      result.elements[0] = tan2 / aspect;
+      result.elements[5] = tan2;
+      result.elements[10] = (far + near) / (near - far);
+      result.elements[14] = 2 * (far * near) / (near - far);
+      result.elements[11] = -1;
+      result.elements[15] = 0;
+
+      return result;
+    }
+
+    // Translate(position) * RotateX(rotation.x) * RotateY(rotation.y) * RotateZ(rotation.z) * Scale(scale)
+    // written out directly instead of multiplying five matrices
+    static constexpr Mat4 TransformationMatrix(Vec3 position, Vec3 rotation, Vec3 scale)
+    {
+      float rx = Math::ToRadians(rotation.x);
+      float ry = Math::ToRadians(rotation.y);
+      float rz = Math::ToRadians(rotation.z);
+      float cx = Math::Cos(rx), sx = Math::Sin(rx);
+      float cy = Math::Cos(ry), sy = Math::Sin(ry);
+      float cz = Math::Cos(rz), sz = Math::Sin(rz);
+
+      Mat4 result(1.0f);
+      result.elements[0] = cy * cz * scale.x;
+      result.elements[1] = (cx * sz + sx * sy * cz) * scale.x;
+      result.elements[2] = (sx * sz - cx * sy * cz) * scale.x;
+
+      result.elements[4] = -cy * sz * scale.y;
+      result.elements[5] = (cx * cz - sx * sy * sz) * scale.y;
+      result.elements[6] = (sx * cz + cx * sy * sz) * scale.y;
+
+      result.elements[8] = sy * scale.z;
+      result.elements[9] = -sx * cy * scale.z;
+      result.elements[10] = cx * cy * scale.z;
 
-    static Mat4 TransformationMatrix(Vec3 position, Vec3 rotation, Vec3 scale);
-    static Mat4 ViewMatrix(Vec3 position, Vec3 rotation);
+      result.elements[12] = position.x;
+      result.elements[13] = position.y;
+      result.elements[14] = position.z;
+      return result;
+    }
+
+    static constexpr Mat4 ViewMatrix(Vec3 position, Vec3 rotation)
+    {
+      return
+        Mat4::RotateX(rotation.x) *
+        Mat4::RotateY(rotation.y) *
+        Mat4::RotateZ(rotation.z) *
+        Mat4::Translate(-position.x, -position.y, -position.z);
+    }
 
-    /* 
+    /*
        View Matrix of a third person camera around an object.
        position	- Position of the object
        distance	- distance from the object
        height		- height above the object, between -1 and 1
        rotation	- angle around the object
        */
-    static Mat4 TPCamera(Vec3 position, float distance, float height, float rotation);
-    static Mat4 LookAt(const Vec3& from, const Vec3& to, const Vec3& upVector);
+    static constexpr Mat4 TPCamera(Vec3 position, float distance, float height, float rotation)
+    {
+      return
+        RotateRX(Math::Asin(height)) *
+        Mat4::RotateY(90) *
+        Mat4::Translate(Vec3(Math::Sqrt(1 - height*height) * distance, -height * distance, 0)) *
+        Mat4::RotateY(rotation) *
+        Mat4::Translate(-position.x, -position.y, -position.z);
+    }
+
+    static constexpr Mat4 LookAt(const Vec3& from, const Vec3& to, const Vec3& upVector)
+    {
+      Vec3 forward = Vec3{to - from}.Normalize();
+      Vec3 side = forward.Cross(upVector).Normalize();
+      Vec3 up = side.Cross(forward);
+
+      Mat4 result(1);
+      result.elements[0] = side.x;
+      result.elements[4] = side.y;
+      result.elements[8] = side.z;
+      result.elements[1] = up.x;
+      result.elements[5] = up.y;
+      result.elements[9] = up.z;
+      result.elements[2] =-forward.x;
+      result.elements[6] =-forward.y;
+      result.elements[10] =-forward.z;
+      result.elements[12] =-side.Dot(from);
+      result.elements[13] =-up.Dot(from);
+      result.elements[14] = forward.Dot(from);
+      return result;
+    }
+
+    static constexpr Mat4 Translate(const Vec3& translation)
+    {
+      return Translate(translation.x, translation.y, translation.z);
+    }
+
+    static constexpr Mat4 Scale(const Vec3& scaling)
+    {
+      return Scale(scaling.x, scaling.y, scaling.z);
+    }
+
+    static constexpr Mat4 Translate(const float& x, const float& y, const float& z)
+    {
+      Mat4 result(1.0f);
+
+      result.elements[12] = x;
+      result.elements[13] = y;
+      result.elements[14] = z;
+      return result;
+    }
+
+    static constexpr Mat4 Scale(const float& x, const float& y, const float& z)
+    {
+      Mat4 result(1.0f);
+
+      result.elements[0] = x;
+      result.elements[5] = y;
+      result.elements[10] = z;
+
+      return result;
+    }
+
+    static constexpr Mat4 RotateX(float deg)
+    {
+      return RotateRX(Math::ToRadians(deg));
+    }
+
+    static constexpr Mat4 RotateY(float deg)
+    {
+      return RotateRY(Math::ToRadians(deg));
+    }
+
+    static constexpr Mat4 RotateZ(float deg)
+    {
+      return RotateRZ(Math::ToRadians(deg));
+    }
+
+    static constexpr Mat4 RotateRX(float rad)
+    {
+      Mat4 result(1.0f);
+      float c = Math::Cos(rad);
+      float s = Math::Sin(rad);
+      result.elements[5] = c;
+      result.elements[9] = -s;
+      result.elements[6] = s;
+      result.elements[10] = c;
+      return result;
+    }
+
+    static constexpr Mat4 RotateRY(float rad)
+    {
+      Mat4 result(1.0f);
+      float c = Math::Cos(rad);
+      float s = Math::Sin(rad);
+      result.elements[0] = c;
+      result.elements[2] = -s;
+      result.elements[8] = s;
+      result.elements[10] = c;
+      return result;
+    }
+
+    static constexpr Mat4 RotateRZ(float rad)
+    {
+      Mat4 result(1.0f);
+      float c = Math::Cos(rad);
+      float s = Math::Sin(rad);
+      result.elements[0] = c;
+      result.elements[4] = -s;
+      result.elements[1] = s;
+      result.elements[5] = c;
+      return result;
+    }
+
+    static constexpr Mat4 Rotate(float deg, const Vec3& axis)
+    {
+      return RotateR(Math::ToRadians(deg), axis);
+    }
+
+    static constexpr Mat4 RotateR(float rad, const Vec3& axis)
+    {
+      Mat4 result(1.0f);
+
+      float c = Math::Cos(rad);
+      float s = Math::Sin(rad);
+      float omc = 1.0f - c;
+
+      float x = axis.x;
+      float y = axis.y;
+      float z = axis.z;
+
+      result.elements[0] = x * x * omc + c;
+      result.elements[1] = y * x * omc + z * s;
+      result.elements[2] = x * z * omc - y * s;
+
+      result.elements[4] = x * y * omc - z * s;
+      result.elements[5] = y * y * omc + c;
+      result.elements[6] = y * z * omc + x * s;
+
+      result.elements[8] = x * z * omc + y * s;
+      result.elements[9] = y * z * omc - x * s;
+      result.elements[10] = z * z * omc + c;
+
+      return result;
+    }
+
+    // Inverse from the cross products of the columns' xyz parts and the bottom row, see Lengyel,
+    // Foundations of Game Engine Development vol. 1, 1.7.5
+    static constexpr Mat4 Inverse(const Mat4& inv)
+    {
+      if(!GREET_IS_CONSTANT_EVALUATED())
+        return InverseSimd(inv);
+
+      const float* e = inv.elements;
+      Vec3 a(e[0], e[1], e[2]);
+      Vec3 b(e[4], e[5], e[6]);
+      Vec3 c(e[8], e[9], e[10]);
+      Vec3 d(e[12], e[13], e[14]);
+      float x = e[3];
+      float y = e[7];
+      float z = e[11];
+      float w = e[15];
+
+      Vec3 s = a.Cross(b);
+      Vec3 t = c.Cross(d);
+      Vec3 u = a * y - b * x;
+      Vec3 v = c * w - d * z;
+
+      float det = s.Dot(v) + t.Dot(u);
+      if (det == 0)
+        return inv;
+
+      float invDet = 1.0f / det;
+      s *= invDet;
+      t *= invDet;
+      u *= invDet;
+      v *= invDet;
+
+      Vec3 r0 = b.Cross(v) + t * y;
+      Vec3 r1 = v.Cross(a) - t * x;
+      Vec3 r2 = d.Cross(u) + s * w;
+      Vec3 r3 = u.Cross(c) - s * z;
+
+      Mat4 result;
+      Vec3 rows[4] = {r0, r1, r2, r3};
+      for (int row = 0; row < 4; row++)
+      {
+        result.elements[row] = rows[row].x;
+        result.elements[row + 4] = rows[row].y;
+        result.elements[row + 8] = rows[row].z;
+      }
+      result.elements[12] = -b.Dot(t);
+      result.elements[13] = a.Dot(t);
+      result.elements[14] = -d.Dot(s);
+      result.elements[15] = c.Dot(s);
+      return result;
+    }
+
+    constexpr Mat4 Cpy() const
+    {
+      return Mat4(elements);
+    }
+
+    constexpr Mat4& Multiply(const Mat4 &other)
+    {
+      if(!GREET_IS_CONSTANT_EVALUATED())
+        return MultiplySimd(other);
+
+      float data[16] = {};
+      for (int row = 0; row < 4; row++)
+      {
+        for (int col = 0; col < 4; col++)
+        {
+          float sum = 0.0f;
+          for (int e = 0; e < 4; e++)
+          {
+            sum += elements[col + e * 4] * other.elements[e + row * 4];
+          }
+          data[col + row * 4] = sum;
+        }
+      }
+      for (int i = 0; i < 16; i++)
+        elements[i] = data[i];
+
+      return *this;
+    }
+
+    constexpr Vec4 Multiply(const Vec2 &other) const
+    {
+      return Multiply(Vec4(other.x, other.y, 1.0f, 1.0f));
+    }
+
+    constexpr Vec4 Multiply(const Vec3 &other) const
+    {
+      return Multiply(Vec4(other.x, other.y, other.z, 1.0f));
+    }
+
+    constexpr Vec4 Multiply(const Vec4 &other) const
+    {
+      if(!GREET_IS_CONSTANT_EVALUATED())
+        return MultiplySimd(other);
+
+      float x = elements[0] * other.x + elements[4] * other.y + elements[8] * other.z + elements[12] * other.w;
+      float y = elements[1] * other.x + elements[5] * other.y + elements[9] * other.z + elements[13] * other.w;
+      float z = elements[2] * other.x + elements[6] * other.y + elements[10] * other.z + elements[14] * other.w;
+      float w = elements[3] * other.x + elements[7] * other.y + elements[11] * other.z + elements[15] * other.w;
+      return Vec4(x, y, z, w);
+    }
+
+    friend constexpr Mat4 operator*(Mat4 first, const Mat4 &second)
+    {
+      return first.Multiply(second);
+    }
+
+    constexpr Mat4& operator*=(const Mat4 &other)
+    {
+      return Multiply(other);
+    }
+
+    friend constexpr Vec4 operator*(const Mat4& first, const Vec2 &second)
+    {
+      return first.Multiply(second);
+    }
+
+    friend constexpr Vec4 operator*(const Mat4& first, const Vec3 &second)
+    {
+      return first.Multiply(second);
+    }
 
-    static Mat4 Translate(const Vec3& translation);
-    static Mat4 Scale(const Vec3& scaling);
+    friend constexpr Vec4 operator*(const Mat4& first, const Vec4 &second)
+    {
+      return first.Multiply(second);
+    }
+
+    friend constexpr Mat4 operator~(const Mat4& first)
+    {
+      return Mat4::Inverse(first);
+    }
 
-    static Mat4 Translate(const float& x, const float& y, const float& z);
-    static Mat4 Scale(const float& x, const float& y, const float& z);
+    private:
+    // Runtime versions of the above, the same math on the column-major columns
+    static Mat4 InverseSimd(const Mat4& inv)
+    {
+      using namespace Simd;
+      Float4 a = Load(inv.elements + 0);
+      Float4 b = Load(inv.elements + 4);
+      Float4 c = Load(inv.elements + 8);
+      Float4 d = Load(inv.elements + 12);
+      Float4 x = Broadcast<3>(a);
+      Float4 y = Broadcast<3>(b);
+      Float4 z = Broadcast<3>(c);
+      Float4 w = Broadcast<3>(d);
 
-    static Mat4 RotateX(float deg);
-    static Mat4 RotateY(float deg);
-    static Mat4 RotateZ(float deg);
+      // The w lanes of these are all zero
+      Float4 s = Cross3(a, b);
+      Float4 t = Cross3(c, d);
+      Float4 u = Sub(Mul(a, y), Mul(b, x));
+      Float4 v = Sub(Mul(c, w), Mul(d, z));
 
-    static Mat4 RotateRX(float rad);
-    static Mat4 RotateRY(float rad);
-    static Mat4 RotateRZ(float rad);
-    static Mat4 Rotate(float deg, const Vec3& axis);
-    static Mat4 RotateR(float rad, const Vec3& axis);
+      Float4 det = Add(Dot3(s, v), Dot3(t, u));
+      if (GetX(det) == 0)
+        return inv;
 
-    static Mat4 Inverse(const Mat4& inv);
+      Float4 invDet = Div(Splat(1.0f), det);
+      s = Mul(s, invDet);
+      t = Mul(t, invDet);
+      u = Mul(u, invDet);
+      v = Mul(v, invDet);
 
-    Mat4 Cpy();
+      Float4 r0 = MulAdd(t, y, Cross3(b, v));
+      Float4 r1 = Sub(Cross3(v, a), Mul(t, x));
+      Float4 r2 = MulAdd(s, w, Cross3(d, u));
+      Float4 r3 = Sub(Cross3(u, c), Mul(s, z));
+      Transpose(r0, r1, r2, r3);
 
-    Mat4& Multiply(const Mat4 &other);
-    Vec4 Multiply(const Vec2 &other) const;
-    Vec4 Multiply(const Vec3 &other) const;
-    Vec4 Multiply(const Vec4 &other) const;
+      Float4 bt_at = Shuffle<0, 0, 0, 0>(Dot3(b, t), Dot3(a, t));
+      Float4 ds_cs = Shuffle<0, 0, 0, 0>(Dot3(d, s), Dot3(c, s));
+      r3 = Mul(Shuffle<0, 2, 0, 2>(bt_at, ds_cs), Set(-1.0f, 1.0f, -1.0f, 1.0f));
 
-    friend Mat4 operator*(Mat4 first, const Mat4 &second);
-    Mat4& operator*=(const Mat4 &other);
+      Mat4 result;
+      Store(result.elements + 0, r0);
+      Store(result.elements + 4, r1);
+      Store(result.elements + 8, r2);
+      Store(result.elements + 12, r3);
+      return result;
+    }
 
-    friend Vec4 operator*(const Mat4& first, const Vec2 &second);
-    friend Vec4 operator*(const Mat4& first, const Vec3 &second);
-    friend Vec4 operator*(const Mat4& first, const Vec4 &second);
-    friend Mat4 operator~(const Mat4& first);
+    Mat4& MultiplySimd(const Mat4 &other)
+    {
+      using namespace Simd;
+      Float4 c0 = Load(elements + 0);
+      Float4 c1 = Load(elements + 4);
+      Float4 c2 = Load(elements + 8);
+      Float4 c3 = Load(elements + 12);
+      for (int col = 0; col < 4; col++)
+      {
+        const float* e = other.elements + col * 4;
+        Float4 sum = Mul(c0, Splat(e[0]));
+        sum = MulAdd(c1, Splat(e[1]), sum);
+        sum = MulAdd(c2, Splat(e[2]), sum);
+        sum = MulAdd(c3, Splat(e[3]), sum);
+        Store(elements + col * 4, sum);
+      }
+      return *this;
+    }
 
+    Vec4 MultiplySimd(const Vec4 &other) const
+    {
+      using namespace Simd;
+      Float4 sum = Mul(Load(elements + 0), Splat(other.x));
+      sum = MulAdd(Load(elements + 4), Splat(other.y), sum);
+      sum = MulAdd(Load(elements + 8), Splat(other.z), sum);
+      sum = MulAdd(Load(elements + 12), Splat(other.w), sum);
+      Vec4 result;
+      Store(result.vals, sum);
+      return result;
+    }
   };
 }
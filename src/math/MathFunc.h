@@ -1,6 +1,7 @@
 #pragma once
 
 #include <math.h>
+#include <math/Scalar.h>
 #include <math/Vec4.h>
 #include <math/Vec2.h>
 #include <iostream>
@@ -9,25 +10,25 @@
 namespace Greet{ namespace Math {
 
   template <typename T>
-  inline T Max(const T& t1, const T& t2)
+  constexpr T Max(const T& t1, const T& t2)
   {
     return t1 > t2 ? t1 : t2;
   }
 
   template <typename T>
-  inline T Min(const T& t1, const T& t2)
+  constexpr T Min(const T& t1, const T& t2)
   {
     return t1 < t2 ? t1 : t2;
   }
 
-  inline float RoundDown(float numToRound, float multiple)
+  constexpr float RoundDown(float numToRound, float multiple)
   {
     if (multiple == 0)
       return 0;
     return ((int)(numToRound / multiple))*multiple;
   }
 
-  inline float RoundUp(float numToRound, float multiple)
+  constexpr float RoundUp(float numToRound, float multiple)
   {
     if (multiple == 0)
       return 0;
@@ -35,7 +36,7 @@ namespace Greet{ namespace Math {
     return ans < numToRound ? ans + multiple : ans;
   }
 
-  inline float RoundClose(float numToRound, float multiple)
+  constexpr float RoundClose(float numToRound, float multiple)
   {
     if (multiple == 0)
       return numToRound;
@@ -44,14 +45,14 @@ namespace Greet{ namespace Math {
     return (numToRound - down) < (up - numToRound) ? down : up;
   }
 
-  inline bool IsPositive(float val)
+  constexpr bool IsPositive(float val)
   {
     return -val < val;
   }
 
   //struct Vec2;
   template<typename T>
-  inline void Clamp(T* value, const T& min, const T& max)
+  constexpr void Clamp(T* value, const T& min, const T& max)
   {
     if(min < max)
       *value = *value < min ? min : (*value > max ? max : *value);
@@ -60,19 +61,9 @@ namespace Greet{ namespace Math {
   }
 
   // Returns half the value, add one to value if it is odd.
-  inline int Half(int value)
+  constexpr int Half(int value)
   {
     return (value + (value % 2)) / 2;
   }
 
-
-  inline float ToRadians(float degrees)
-  {
-    return (float)(degrees * M_PI * 0.005555555f);
-  }
-
-  inline float ToDegrees(float radians)
-  {
-    return (float)(radians * 180.0f / M_PI);
-  }
 }}
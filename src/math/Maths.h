@@ -7,3 +7,7 @@
 #include <math/Vec4.h>
 #include <math/Mat3.h>
 #include <math/Mat4.h>
+#include <math/AffineTransform.h>
+#include <math/AABB.h>
+#include <math/Sphere.h>
+#include <math/Frustum.h>
@@ -1,6 +1,11 @@
 #pragma once
 
+#include <math/Scalar.h>
 #include <math/Vec3.h>
+#include <math/Mat3.h>
+#include <math/Mat4.h>
+
+#include <cmath>
 
 namespace Greet {
 
@@ -13,20 +18,181 @@ namespace Greet {
       float w;
 
     public:
-      Quaternion(float x, float y, float z, float w);
+      constexpr Quaternion()
+        : x(0), y(0), z(0), w(1)
+      {}
 
-      float Length();
-      Quaternion& Normalize();
-      Quaternion& Conjugate();
+      constexpr Quaternion(float x, float y, float z, float w)
+        : x(x), y(y), z(z), w(w)
+      {}
 
-      Quaternion& Multiply(const Quaternion& other);
-      Quaternion& Multiply(const Vec3& other);
+      // Rotation around a normalized axis, the same rotation as Mat4::Rotate(deg, axis)
+      static constexpr Quaternion Rotation(float deg, const Vec3& axis)
+      {
+        return RotationR(Math::ToRadians(deg), axis);
+      }
 
-      friend Quaternion operator*(const Quaternion& first, const Quaternion &second);
-      friend Quaternion operator*(const Quaternion& first, const Vec3 &second);
+      static constexpr Quaternion RotationR(float rad, const Vec3& axis)
+      {
+        float s = Math::Sin(rad / 2.0f);
+        return Quaternion(axis.x * s, axis.y * s, axis.z * s, Math::Cos(rad / 2.0f));
+      }
 
-      Quaternion& operator*=(const Quaternion &other);
-      Quaternion& operator*=(const Vec3 &other);
-  };
+      constexpr float Length() const
+      {
+        return Math::Sqrt(x*x + y*y + z*z + w*w);
+      }
+
+      constexpr float Dot(const Quaternion& other) const
+      {
+        return x * other.x + y * other.y + z * other.z + w * other.w;
+      }
+
+      constexpr Quaternion& Normalize()
+      {
+        float len = Length();
+        x /= len;
+        y /= len;
+        z /= len;
+        w /= len;
+        return *this;
+      }
+
+      constexpr Quaternion& Conjugate()
+      {
+        x = -x;
+        y = -y;
+        z = -z;
+        return *this;
+      }
+
+      constexpr Quaternion& Multiply(const Quaternion& other)
+      {
+        float w_ = w  * other.w - x  * other.x - y  * other.y - z  * other.z;
+        float x_ = x  * other.w + w  * other.x + y  * other.z - z  * other.y;
+        float y_ = y  * other.w + w  * other.y + z  * other.x - x  * other.z;
+        float z_ = z  * other.w + w  * other.z + x  * other.y - y  * other.x;
+        x = x_;
+        y = y_;
+        z = z_;
+        w = w_;
+        return *this;
+      }
+
+      constexpr Quaternion& Multiply(const Vec3& other)
+      {
+        float w_ = -x * other.x - y * other.y - z * other.z;
+        float x_ =  w * other.x + y * other.z - z * other.y;
+        float y_ =  w * other.y + z * other.x - x * other.z;
+        float z_ =  w * other.z + x * other.y - y * other.x;
+        x = x_;
+        y = y_;
+        z = z_;
+        w = w_;
+        return *this;
+      }
+
+      // q * v * q^-1 for a unit quaternion without forming either product,
+      // v' = v + w * t + q x t where t = 2 * (q x v)
+      constexpr Vec3 Rotate(const Vec3& vec) const
+      {
+        float tx = 2.0f * (y * vec.z - z * vec.y);
+        float ty = 2.0f * (z * vec.x - x * vec.z);
+        float tz = 2.0f * (x * vec.y - y * vec.x);
+        return Vec3(
+            vec.x + w * tx + y * tz - z * ty,
+            vec.y + w * ty + z * tx - x * tz,
+            vec.z + w * tz + x * ty - y * tx);
+      }
+
+      // Rotation matrices of a unit quaternion
+      constexpr Mat3 ToMat3() const
+      {
+        Mat3 result(1.0f);
+        float xx = x * x, yy = y * y, zz = z * z;
+        float xy = x * y, xz = x * z, yz = y * z;
+        float wx = w * x, wy = w * y, wz = w * z;
+
+        result.elements[0] = 1.0f - 2.0f * (yy + zz);
+        result.elements[1] = 2.0f * (xy + wz);
+        result.elements[2] = 2.0f * (xz - wy);
 
+        result.elements[3] = 2.0f * (xy - wz);
+        result.elements[4] = 1.0f - 2.0f * (xx + zz);
+        result.elements[5] = 2.0f * (yz + wx);
+
+        result.elements[6] = 2.0f * (xz + wy);
+        result.elements[7] = 2.0f * (yz - wx);
+        result.elements[8] = 1.0f - 2.0f * (xx + yy);
+        return result;
+      }
+
+      constexpr Mat4 ToMat4() const
+      {
+        Mat3 rotation = ToMat3();
+        Mat4 result(1.0f);
+        for (int col = 0; col < 3; col++)
+          for (int row = 0; row < 3; row++)
+            result.elements[col * 4 + row] = rotation.elements[col * 3 + row];
+        return result;
+      }
+
+      // Normalized linear interpolation along the shortest path. Not constant speed, but
+      // monotonic and much cheaper than Slerp, good enough for closely spaced keyframes.
+      static constexpr Quaternion Nlerp(const Quaternion& from, const Quaternion& to, float t)
+      {
+        float sign = from.Dot(to) < 0.0f ? -1.0f : 1.0f;
+        Quaternion result(
+            from.x + (sign * to.x - from.x) * t,
+            from.y + (sign * to.y - from.y) * t,
+            from.z + (sign * to.z - from.z) * t,
+            from.w + (sign * to.w - from.w) * t);
+        return result.Normalize();
+      }
+
+      // Constant speed spherical interpolation along the shortest path, nearly parallel
+      // quaternions fall back to Nlerp where sin(theta) would lose its precision
+      static Quaternion Slerp(const Quaternion& from, const Quaternion& to, float t)
+      {
+        float cosTheta = from.Dot(to);
+        float sign = 1.0f;
+        if (cosTheta < 0.0f)
+        {
+          cosTheta = -cosTheta;
+          sign = -1.0f;
+        }
+        if (cosTheta > 0.9995f)
+          return Nlerp(from, to, t);
+
+        float theta = std::acos(cosTheta);
+        float invSin = 1.0f / Math::Sin(theta);
+        float a = Math::Sin((1.0f - t) * theta) * invSin;
+        float b = sign * Math::Sin(t * theta) * invSin;
+        return Quaternion(
+            a * from.x + b * to.x,
+            a * from.y + b * to.y,
+            a * from.z + b * to.z,
+            a * from.w + b * to.w);
+      }
+
+      friend constexpr Quaternion operator*(const Quaternion& first, const Quaternion &second)
+      {
+        return Quaternion(first.x, first.y, first.z, first.w).Multiply(second);
+      }
+
+      friend constexpr Quaternion operator*(const Quaternion& first, const Vec3 &second)
+      {
+        return Quaternion(first.x, first.y, first.z, first.w).Multiply(second);
+      }
+
+      constexpr Quaternion& operator*=(const Quaternion &other)
+      {
+        return Multiply(other);
+      }
+
+      constexpr Quaternion& operator*=(const Vec3 &other)
+      {
+        return Multiply(other);
+      }
+  };
 }
@@ -0,0 +1,176 @@
+#pragma once
+
+#ifndef _USE_MATH_DEFINES
+#define _USE_MATH_DEFINES
+#endif
+
+#include <math/FastMath.h>
+
+#include <cmath>
+
+// True while the compiler evaluates a constant expression. The constexpr math uses it to swap
+// libm calls and SIMD intrinsics, which can't be evaluated at compile time, for plain C++.
+// Compilers without the builtin can still use the library at runtime, GREET_CONSTEXPR_MATH is
+// only defined when the math can be evaluated at compile time.
+#if defined(__has_builtin)
+#if __has_builtin(__builtin_is_constant_evaluated)
+#define GREET_CONSTEXPR_MATH
+#endif
+#endif
+#if !defined(GREET_CONSTEXPR_MATH)
+#if (defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 9) || (defined(_MSC_VER) && _MSC_VER >= 1925)
+#define GREET_CONSTEXPR_MATH
+#endif
+#endif
+#if defined(GREET_CONSTEXPR_MATH)
+#define GREET_IS_CONSTANT_EVALUATED() __builtin_is_constant_evaluated()
+#else
+#define GREET_IS_CONSTANT_EVALUATED() false
+#endif
+
+namespace Greet{ namespace Math {
+
+  namespace Constexpr {
+    // Evaluated in double precision so the float results are correctly rounded in most cases.
+    // Only meant for compile time, the loops are far slower than libm.
+    constexpr double PI = 3.14159265358979323846;
+
+    constexpr double Sqrt(double x)
+    {
+      if(!(x > 0))
+        return x == 0 ? 0 : NAN;
+      double guess = x > 1 ? x : 1;
+      for(int i = 0; i < 64; i++)
+      {
+        double next = 0.5 * (guess + x / guess);
+        if(next == guess)
+          break;
+        guess = next;
+      }
+      return guess;
+    }
+
+    constexpr double Sin(double x)
+    {
+      // Reduce to [-pi, pi] where the series converges quickly
+      double turns = x / (2 * PI);
+      x -= 2 * PI * (double)(long long)(turns + (turns < 0 ? -0.5 : 0.5));
+      double term = x;
+      double sum = x;
+      for(int n = 1; n < 12; n++)
+      {
+        term *= -x * x / ((2 * n) * (2 * n + 1));
+        sum += term;
+      }
+      return sum;
+    }
+
+    constexpr double Cos(double x)
+    {
+      return Sin(x + PI / 2);
+    }
+
+    constexpr double Atan(double x)
+    {
+      if(x < 0)
+        return -Atan(-x);
+      if(x > 1)
+        return PI / 2 - Atan(1 / x);
+      // Below tan(pi/8) the series converges quickly
+      if(x > 0.41421356237309503)
+        return PI / 4 + Atan((x - 1) / (x + 1));
+      double term = x;
+      double sum = x;
+      for(int n = 1; n < 24; n++)
+      {
+        term *= -x * x;
+        sum += term / (2 * n + 1);
+      }
+      return sum;
+    }
+
+    constexpr double Atan2(double y, double x)
+    {
+      if(x > 0)
+        return Atan(y / x);
+      if(x < 0)
+        return y < 0 ? Atan(y / x) - PI : Atan(y / x) + PI;
+      return y > 0 ? PI / 2 : (y < 0 ? -PI / 2 : 0);
+    }
+  }
+
+  // The runtime paths call libm, or the approximations in FastMath.h when GREET_FAST_MATH is
+  // defined, see there for their error bounds. Compile time evaluation is exact in both modes.
+#if defined(GREET_FAST_MATH)
+  namespace Runtime = Fast;
+#else
+  namespace Runtime {
+    inline float Sin(float x) { return std::sin(x); }
+    inline float Cos(float x) { return std::cos(x); }
+    inline float Tan(float x) { return std::tan(x); }
+    inline float Rsqrt(float x) { return 1.0f / std::sqrt(x); }
+    inline float Atan2(float y, float x) { return std::atan2(y, x); }
+    inline float Asin(float x) { return std::asin(x); }
+  }
+#endif
+
+  // sqrt is a single instruction on every target, so it is exact in both modes
+  constexpr float Sqrt(float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)Constexpr::Sqrt(x);
+    return std::sqrt(x);
+  }
+
+  constexpr float Rsqrt(float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)(1 / Constexpr::Sqrt(x));
+    return Runtime::Rsqrt(x);
+  }
+
+  constexpr float Sin(float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)Constexpr::Sin(x);
+    return Runtime::Sin(x);
+  }
+
+  constexpr float Cos(float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)Constexpr::Cos(x);
+    return Runtime::Cos(x);
+  }
+
+  constexpr float Tan(float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)(Constexpr::Sin(x) / Constexpr::Cos(x));
+    return Runtime::Tan(x);
+  }
+
+  constexpr float Atan2(float y, float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)Constexpr::Atan2(y, x);
+    return Runtime::Atan2(y, x);
+  }
+
+  constexpr float Asin(float x)
+  {
+    if(GREET_IS_CONSTANT_EVALUATED())
+      return (float)Constexpr::Atan2(x, Constexpr::Sqrt((1.0 - x) * (1.0 + x)));
+    return Runtime::Asin(x);
+  }
+
+  constexpr float ToRadians(float degrees)
+  {
+    return (float)(degrees * M_PI * 0.005555555f);
+  }
+
+  constexpr float ToDegrees(float radians)
+  {
+    return (float)(radians * 180.0f / M_PI);
+  }
+}}
@@ -0,0 +1,238 @@
+#pragma once
+
+// Thin wrapper around 128-bit float vectors. The backend is chosen at compile time, SSE on x86,
+// NEON on ARM and plain arrays otherwise. Define GREET_NO_SIMD to force the scalar backend.
+#if defined(GREET_NO_SIMD)
+#define GREET_SIMD_SCALAR
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define GREET_SIMD_SSE
+#include <immintrin.h>
+#elif defined(__ARM_NEON)
+#define GREET_SIMD_NEON
+#include <arm_neon.h>
+#else
+#define GREET_SIMD_SCALAR
+#endif
+
+#if defined(GREET_SIMD_SCALAR)
+#include <cmath>
+#endif
+
+namespace Greet{ namespace Simd {
+
+#if defined(GREET_SIMD_SSE)
+  typedef __m128 Float4;
+
+  inline Float4 Load(const float* p) { return _mm_loadu_ps(p); }
+  inline void Store(float* p, Float4 a) { _mm_storeu_ps(p, a); }
+  inline Float4 Splat(float f) { return _mm_set1_ps(f); }
+  inline Float4 Set(float x, float y, float z, float w) { return _mm_setr_ps(x, y, z, w); }
+  inline Float4 Zero() { return _mm_setzero_ps(); }
+  inline float GetX(Float4 a) { return _mm_cvtss_f32(a); }
+
+  inline Float4 Add(Float4 a, Float4 b) { return _mm_add_ps(a, b); }
+  inline Float4 Sub(Float4 a, Float4 b) { return _mm_sub_ps(a, b); }
+  inline Float4 Mul(Float4 a, Float4 b) { return _mm_mul_ps(a, b); }
+  inline Float4 Div(Float4 a, Float4 b) { return _mm_div_ps(a, b); }
+  inline Float4 Min(Float4 a, Float4 b) { return _mm_min_ps(a, b); }
+  inline Float4 Max(Float4 a, Float4 b) { return _mm_max_ps(a, b); }
+  inline Float4 Sqrt(Float4 a) { return _mm_sqrt_ps(a); }
+#if defined(__FMA__)
+  inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return _mm_fmadd_ps(a, b, c); }
+#else
+  inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+#endif
+  inline Float4 Abs(Float4 a) { return _mm_andnot_ps(_mm_set1_ps(-0.0f), a); }
+  // Round to nearest even, only valid while |a| < 2^31
+  inline Float4 Round(Float4 a) { return _mm_cvtepi32_ps(_mm_cvtps_epi32(a)); }
+  // Low precision 1 / sqrt(a), around 12 bits on SSE and 8 bits on NEON
+  inline Float4 RsqrtEstimate(Float4 a) { return _mm_rsqrt_ps(a); }
+
+  // Masks are only meant to be passed to Select, which picks a where the mask is set
+  inline Float4 Less(Float4 a, Float4 b) { return _mm_cmplt_ps(a, b); }
+  inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+  // The sign bits of the lanes as bits 0 to 3
+  inline int SignMask(Float4 a) { return _mm_movemask_ps(a); }
+
+  // Lanes x and y are taken from a, z and w from b
+  template <int x, int y, int z, int w>
+  inline Float4 Shuffle(Float4 a, Float4 b) { return _mm_shuffle_ps(a, b, _MM_SHUFFLE(w, z, y, x)); }
+
+  // Negates the lanes of a where the lane in sign has its sign bit set
+  inline Float4 FlipSign(Float4 a, Float4 sign) { return _mm_xor_ps(a, _mm_and_ps(sign, _mm_set1_ps(-0.0f))); }
+
+  inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3) { _MM_TRANSPOSE4_PS(r0, r1, r2, r3); }
+
+#elif defined(GREET_SIMD_NEON)
+  typedef float32x4_t Float4;
+
+  inline Float4 Load(const float* p) { return vld1q_f32(p); }
+  inline void Store(float* p, Float4 a) { vst1q_f32(p, a); }
+  inline Float4 Splat(float f) { return vdupq_n_f32(f); }
+  inline Float4 Set(float x, float y, float z, float w) { float v[4] = {x, y, z, w}; return vld1q_f32(v); }
+  inline Float4 Zero() { return vdupq_n_f32(0.0f); }
+  inline float GetX(Float4 a) { return vgetq_lane_f32(a, 0); }
+
+  inline Float4 Add(Float4 a, Float4 b) { return vaddq_f32(a, b); }
+  inline Float4 Sub(Float4 a, Float4 b) { return vsubq_f32(a, b); }
+  inline Float4 Mul(Float4 a, Float4 b) { return vmulq_f32(a, b); }
+  inline Float4 Min(Float4 a, Float4 b) { return vminq_f32(a, b); }
+  inline Float4 Max(Float4 a, Float4 b) { return vmaxq_f32(a, b); }
+  inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return vmlaq_f32(c, a, b); }
+  inline Float4 Abs(Float4 a) { return vabsq_f32(a); }
+#if defined(__aarch64__)
+  inline Float4 Div(Float4 a, Float4 b) { return vdivq_f32(a, b); }
+  inline Float4 Sqrt(Float4 a) { return vsqrtq_f32(a); }
+  inline Float4 Round(Float4 a) { return vrndnq_f32(a); }
+#else
+  // ARMv7 has no vector divide or square root, the estimates are refined by two Newton steps
+  // which leaves them within a couple of ulp
+  inline Float4 Div(Float4 a, Float4 b)
+  {
+    float32x4_t r = vrecpeq_f32(b);
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    r = vmulq_f32(r, vrecpsq_f32(b, r));
+    return vmulq_f32(a, r);
+  }
+  inline Float4 Sqrt(Float4 a)
+  {
+    float32x4_t r = vrsqrteq_f32(a);
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+    r = vmulq_f32(r, vrsqrtsq_f32(vmulq_f32(a, r), r));
+    // 1 / sqrt(0) is infinite, the zero lanes are kept as they are instead of 0 * inf
+    return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0.0f)), a, vmulq_f32(a, r));
+  }
+  // Adding 1.5 * 2^23 pushes the fraction out of the mantissa, valid while |a| < 2^22
+  inline Float4 Round(Float4 a) { return vsubq_f32(vaddq_f32(a, vdupq_n_f32(12582912.0f)), vdupq_n_f32(12582912.0f)); }
+#endif
+  inline Float4 RsqrtEstimate(Float4 a) { return vrsqrteq_f32(a); }
+
+  inline Float4 Less(Float4 a, Float4 b) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+  inline Float4 Select(Float4 mask, Float4 a, Float4 b) { return vbslq_f32(vreinterpretq_u32_f32(mask), a, b); }
+  inline int SignMask(Float4 a)
+  {
+    uint32x4_t bits = vshrq_n_u32(vreinterpretq_u32_f32(a), 31);
+    return (int)(vgetq_lane_u32(bits, 0) | (vgetq_lane_u32(bits, 1) << 1) | (vgetq_lane_u32(bits, 2) << 2) | (vgetq_lane_u32(bits, 3) << 3));
+  }
+
+  template <int x, int y, int z, int w>
+  inline Float4 Shuffle(Float4 a, Float4 b) { return __builtin_shufflevector(a, b, x, y, z + 4, w + 4); }
+
+  inline Float4 FlipSign(Float4 a, Float4 sign)
+  {
+    uint32x4_t signBits = vandq_u32(vreinterpretq_u32_f32(sign), vdupq_n_u32(0x80000000));
+    return vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(a), signBits));
+  }
+
+  inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+  {
+    float32x4x2_t t01 = vtrnq_f32(r0, r1);
+    float32x4x2_t t23 = vtrnq_f32(r2, r3);
+    r0 = vcombine_f32(vget_low_f32(t01.val[0]), vget_low_f32(t23.val[0]));
+    r1 = vcombine_f32(vget_low_f32(t01.val[1]), vget_low_f32(t23.val[1]));
+    r2 = vcombine_f32(vget_high_f32(t01.val[0]), vget_high_f32(t23.val[0]));
+    r3 = vcombine_f32(vget_high_f32(t01.val[1]), vget_high_f32(t23.val[1]));
+  }
+
+#else
+  struct Float4
+  {
+    float v[4];
+  };
+
+  inline Float4 Load(const float* p) { return {{p[0], p[1], p[2], p[3]}}; }
+  inline void Store(float* p, Float4 a) { p[0] = a.v[0]; p[1] = a.v[1]; p[2] = a.v[2]; p[3] = a.v[3]; }
+  inline Float4 Splat(float f) { return {{f, f, f, f}}; }
+  inline Float4 Set(float x, float y, float z, float w) { return {{x, y, z, w}}; }
+  inline Float4 Zero() { return {{0.0f, 0.0f, 0.0f, 0.0f}}; }
+  inline float GetX(Float4 a) { return a.v[0]; }
+
+  inline Float4 Add(Float4 a, Float4 b) { return {{a.v[0] + b.v[0], a.v[1] + b.v[1], a.v[2] + b.v[2], a.v[3] + b.v[3]}}; }
+  inline Float4 Sub(Float4 a, Float4 b) { return {{a.v[0] - b.v[0], a.v[1] - b.v[1], a.v[2] - b.v[2], a.v[3] - b.v[3]}}; }
+  inline Float4 Mul(Float4 a, Float4 b) { return {{a.v[0] * b.v[0], a.v[1] * b.v[1], a.v[2] * b.v[2], a.v[3] * b.v[3]}}; }
+  inline Float4 Div(Float4 a, Float4 b) { return {{a.v[0] / b.v[0], a.v[1] / b.v[1], a.v[2] / b.v[2], a.v[3] / b.v[3]}}; }
+  inline Float4 Min(Float4 a, Float4 b)
+  {
+    return {{a.v[0] < b.v[0] ? a.v[0] : b.v[0], a.v[1] < b.v[1] ? a.v[1] : b.v[1],
+             a.v[2] < b.v[2] ? a.v[2] : b.v[2], a.v[3] < b.v[3] ? a.v[3] : b.v[3]}};
+  }
+  inline Float4 Max(Float4 a, Float4 b)
+  {
+    return {{a.v[0] > b.v[0] ? a.v[0] : b.v[0], a.v[1] > b.v[1] ? a.v[1] : b.v[1],
+             a.v[2] > b.v[2] ? a.v[2] : b.v[2], a.v[3] > b.v[3] ? a.v[3] : b.v[3]}};
+  }
+  inline Float4 Sqrt(Float4 a) { return {{std::sqrt(a.v[0]), std::sqrt(a.v[1]), std::sqrt(a.v[2]), std::sqrt(a.v[3])}}; }
+  inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+  inline Float4 Abs(Float4 a) { return {{std::fabs(a.v[0]), std::fabs(a.v[1]), std::fabs(a.v[2]), std::fabs(a.v[3])}}; }
+  // Adding 2^23 pushes the fraction out of the mantissa, much faster than std::nearbyint
+  inline float RoundLane(float a)
+  {
+    float magic = std::copysign(8388608.0f, a);
+    return std::fabs(a) < 8388608.0f ? (a + magic) - magic : a;
+  }
+  inline Float4 Round(Float4 a) { return {{RoundLane(a.v[0]), RoundLane(a.v[1]), RoundLane(a.v[2]), RoundLane(a.v[3])}}; }
+  inline Float4 RsqrtEstimate(Float4 a) { return Div(Splat(1.0f), Sqrt(a)); }
+
+  // Mask lanes are 1 or 0 instead of all bits set or cleared
+  inline Float4 Less(Float4 a, Float4 b)
+  {
+    return {{a.v[0] < b.v[0] ? 1.0f : 0.0f, a.v[1] < b.v[1] ? 1.0f : 0.0f,
+             a.v[2] < b.v[2] ? 1.0f : 0.0f, a.v[3] < b.v[3] ? 1.0f : 0.0f}};
+  }
+  inline Float4 Select(Float4 mask, Float4 a, Float4 b)
+  {
+    return {{mask.v[0] != 0 ? a.v[0] : b.v[0], mask.v[1] != 0 ? a.v[1] : b.v[1],
+             mask.v[2] != 0 ? a.v[2] : b.v[2], mask.v[3] != 0 ? a.v[3] : b.v[3]}};
+  }
+  inline int SignMask(Float4 a)
+  {
+    return (std::signbit(a.v[0]) ? 1 : 0) | (std::signbit(a.v[1]) ? 2 : 0) | (std::signbit(a.v[2]) ? 4 : 0) | (std::signbit(a.v[3]) ? 8 : 0);
+  }
+
+  template <int x, int y, int z, int w>
+  inline Float4 Shuffle(Float4 a, Float4 b) { return {{a.v[x], a.v[y], b.v[z], b.v[w]}}; }
+
+  inline Float4 FlipSign(Float4 a, Float4 sign)
+  {
+    return {{std::signbit(sign.v[0]) ? -a.v[0] : a.v[0], std::signbit(sign.v[1]) ? -a.v[1] : a.v[1],
+             std::signbit(sign.v[2]) ? -a.v[2] : a.v[2], std::signbit(sign.v[3]) ? -a.v[3] : a.v[3]}};
+  }
+
+  inline void Transpose(Float4& r0, Float4& r1, Float4& r2, Float4& r3)
+  {
+    Float4 t0 = r0, t1 = r1, t2 = r2, t3 = r3;
+    r0 = {{t0.v[0], t1.v[0], t2.v[0], t3.v[0]}};
+    r1 = {{t0.v[1], t1.v[1], t2.v[1], t3.v[1]}};
+    r2 = {{t0.v[2], t1.v[2], t2.v[2], t3.v[2]}};
+    r3 = {{t0.v[3], t1.v[3], t2.v[3], t3.v[3]}};
+  }
+#endif
+
+  template <int x, int y, int z, int w>
+  inline Float4 Swizzle(Float4 a) { return Shuffle<x, y, z, w>(a, a); }
+
+  template <int lane>
+  inline Float4 Broadcast(Float4 a) { return Shuffle<lane, lane, lane, lane>(a, a); }
+
+  // Cross product of the xyz lanes, w is zero if both inputs have equal w
+  inline Float4 Cross3(Float4 a, Float4 b)
+  {
+    Float4 c = Sub(Mul(a, Swizzle<1, 2, 0, 3>(b)), Mul(Swizzle<1, 2, 0, 3>(a), b));
+    return Swizzle<1, 2, 0, 3>(c);
+  }
+
+  // Dot product of the xyz lanes, splatted to all lanes
+  inline Float4 Dot3(Float4 a, Float4 b)
+  {
+    Float4 m = Mul(a, b);
+    return Add(Add(Broadcast<0>(m), Broadcast<1>(m)), Broadcast<2>(m));
+  }
+
+  // Dot product of all lanes, splatted to all lanes
+  inline Float4 Dot4(Float4 a, Float4 b)
+  {
+    Float4 m = Mul(a, b);
+    m = Add(m, Swizzle<1, 0, 3, 2>(m));
+    return Add(m, Swizzle<2, 3, 0, 1>(m));
+  }
+}}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <math/AABB.h>
+#include <math/Mat4.h>
+#include <math/Vec3.h>
+
+namespace Greet {
+
+  // Bounding sphere, laid out as four floats so that arrays of them load straight into SIMD registers
+  struct Sphere
+  {
+    Vec3 center;
+    float radius;
+
+    constexpr Sphere()
+      : center{0, 0, 0}, radius{0}
+    {}
+
+    constexpr Sphere(const Vec3& center, float radius)
+      : center{center}, radius{radius}
+    {}
+
+    // Sphere through the corners of the box
+    static constexpr Sphere FromAABB(const AABB& box)
+    {
+      return Sphere(box.GetCenter(), box.GetExtents().Length());
+    }
+
+    constexpr bool Contains(const Vec3& point) const
+    {
+      Vec3 delta = point - center;
+      return delta.Dot(delta) <= radius * radius;
+    }
+
+    constexpr bool Intersects(const Sphere& other) const
+    {
+      Vec3 delta = other.center - center;
+      float radii = radius + other.radius;
+      return delta.Dot(delta) <= radii * radii;
+    }
+
+    // The radius is scaled by the longest axis, so the result still bounds non-uniformly
+    // scaled contents
+    constexpr Sphere Transform(const Mat4& matrix) const
+    {
+      const float* m = matrix.elements;
+      float scale = 0;
+      for (int col = 0; col < 3; col++)
+      {
+        float lengthSquared = m[col * 4] * m[col * 4] + m[col * 4 + 1] * m[col * 4 + 1] + m[col * 4 + 2] * m[col * 4 + 2];
+        scale = lengthSquared > scale ? lengthSquared : scale;
+      }
+      Vec4 transformed = matrix * center;
+      return Sphere(Vec3(transformed), radius * Math::Sqrt(scale));
+    }
+  };
+}
@@ -1,10 +1,12 @@
 #pragma once
 
-#include <cmath>
-#include <iostream>
+#include <math/Scalar.h>
 #include <math/Vec3.h>
 #include <math/Vec4.h>
 
+#include <cassert>
+#include <iostream>
+
 namespace Greet{
 
   struct Vec2
@@ -25,68 +27,276 @@ namespace Greet{
           float s, t;
         };
       };
-      Vec2();
-      Vec2(float x, float y);
-      Vec2(const Vec3& vec3);
-      Vec2(const Vec4& vec4);
-
-      float Length();
-      float LengthSQ();
-      float Dot(const Vec2& vec) const;
-      float Cross(const Vec2& vec) const;
-      Vec2& Abs();
-      Vec2& Projected(const Vec2& vec);
-      Vec2& Normalize();
-      Vec2& Rotate(const float deg);
-      Vec2& RotateR(const float rad);
-
-      Vec2& Add(const Vec2& other);
-      Vec2& Subtract(const Vec2& other);
-      Vec2& Multiply(const Vec2& other);
-      Vec2& Divide(const Vec2& other);
-
-      Vec2& Add(const float other);
-      Vec2& Subtract(const float other);
-      Vec2& Multiply(const float other);
-      Vec2& Divide(const float other);
-
-      bool Compare(const Vec2& other);
-
-      friend Vec2 operator+(const Vec2& first, const Vec2 &second);
-      friend Vec2 operator-(const Vec2& first, const Vec2 &second);
-      friend Vec2 operator*(const Vec2& first, const Vec2 &second);
-      friend Vec2 operator/(const Vec2& first, const Vec2 &second);
-
-      friend Vec2 operator+(const Vec2& first, const float c);
-      friend Vec2 operator-(const Vec2& first, const float c);
-      friend Vec2 operator-(const Vec2& first);
-      friend Vec2 operator*(const Vec2& first, const float c);
-      friend Vec2 operator/(const Vec2& first, const float c);
-
-      float operator[](uint i);
-
-      Vec2& operator+=(const Vec2 &other);
-      Vec2& operator-=(const Vec2 &other);
-      Vec2& operator*=(const Vec2 &other);
-      Vec2& operator/=(const Vec2 &other);
-
-      Vec2& operator+=(const float c);
-      Vec2& operator-=(const float c);
-      Vec2& operator*=(const float c);
-      Vec2& operator/=(const float c);
-
-
-      bool operator!=(const Vec2 &other);
-      bool operator==(const Vec2 &other);
-
-      bool operator<(const Vec2& other);
-      bool operator>(const Vec2& other);
-      bool operator<=(const Vec2& other);
-      bool operator>=(const Vec2& other);
-
-      friend std::ostream& operator<<(std::ostream& stream, const Vec2& vec);
-
-      inline float toRadians(float degrees)
+      constexpr Vec2()
+        : x{0}, y{0}
+      {}
+
+      constexpr Vec2(float x, float y)
+        : x{x}, y{y}
+      {}
+
+      constexpr Vec2(const Vec3& vec3)
+        : x{vec3.x}, y{vec3.y}
+      {}
+
+      constexpr Vec2(const Vec4& vec4)
+        : x{vec4.x}, y{vec4.y}
+      {}
+
+      constexpr float Length() const
+      {
+        return Math::Sqrt(x*x + y*y);
+      }
+
+      constexpr float LengthSQ() const
+      {
+        return x*x + y*y;
+      }
+
+      constexpr float Dot(const Vec2& vec) const
+      {
+        return x*vec.x + y*vec.y;
+      }
+
+      constexpr float Cross(const Vec2& vec) const
+      {
+        return x * vec.y - y * vec.x;
+      }
+
+      constexpr Vec2& Abs()
+      {
+        x = x < 0 ? -x : x;
+        y = y < 0 ? -y : y;
+        return *this;
+      }
+
+      constexpr Vec2& Projected(const Vec2& vec)
+      {
+        return Multiply(Dot(vec) / LengthSQ());
+      }
+
+      constexpr Vec2& Normalize()
+      {
+        float len = Length();
+        x /= len;
+        y /= len;
+        return *this;
+      }
+
+      constexpr Vec2& Rotate(const float deg)
+      {
+        return RotateR(toRadians(deg));
+      }
+
+      constexpr Vec2& RotateR(const float rad)
+      {
+        float c = Math::Cos(rad);
+        float s = Math::Sin(rad);
+
+        float tempX = x*c - y*s;
+        float tempY = x*s + y*c;
+        x = tempX;
+        y = tempY;
+
+        return *this;
+      }
+
+      constexpr Vec2& Add(const Vec2& other)
+      {
+        x += other.x;
+        y += other.y;
+        return *this;
+      }
+
+      constexpr Vec2& Subtract(const Vec2& other)
+      {
+        x -= other.x;
+        y -= other.y;
+        return *this;
+      }
+
+      constexpr Vec2& Multiply(const Vec2& other)
+      {
+        x *= other.x;
+        y *= other.y;
+        return *this;
+      }
+
+      constexpr Vec2& Divide(const Vec2& other)
+      {
+        x /= other.x;
+        y /= other.y;
+        return *this;
+      }
+
+      constexpr Vec2& Add(const float c)
+      {
+        x += c;
+        y += c;
+        return *this;
+      }
+
+      constexpr Vec2& Subtract(const float c)
+      {
+        x -= c;
+        y -= c;
+        return *this;
+      }
+
+      constexpr Vec2& Multiply(const float c)
+      {
+        x *= c;
+        y *= c;
+        return *this;
+      }
+
+      constexpr Vec2& Divide(const float c)
+      {
+        x /= c;
+        y /= c;
+        return *this;
+      }
+
+      constexpr bool Compare(const Vec2& other) const
+      {
+        return x == other.x && y == other.y;
+      }
+
+      friend constexpr Vec2 operator+(const Vec2& first, const Vec2 &second)
+      {
+        return Vec2(first.x, first.y).Add(second);
+      }
+
+      friend constexpr Vec2 operator-(const Vec2& first, const Vec2 &second)
+      {
+        return Vec2(first.x, first.y).Subtract(second);
+      }
+
+      friend constexpr Vec2 operator*(const Vec2& first, const Vec2 &second)
+      {
+        return Vec2(first.x, first.y).Multiply(second);
+      }
+
+      friend constexpr Vec2 operator/(const Vec2& first, const Vec2 &second)
+      {
+        return Vec2(first.x, first.y).Divide(second);
+      }
+
+      friend constexpr Vec2 operator+(const Vec2& first, const float c)
+      {
+        return Vec2(first.x, first.y).Add(c);
+      }
+
+      friend constexpr Vec2 operator-(const Vec2& first, const float c)
+      {
+        return Vec2(first.x, first.y).Subtract(c);
+      }
+
+      friend constexpr Vec2 operator-(const Vec2& first)
+      {
+        return Vec2(-first.x, -first.y);
+      }
+
+      friend constexpr Vec2 operator*(const Vec2& first, const float c)
+      {
+        return Vec2(first.x, first.y).Multiply(c);
+      }
+
+      friend constexpr Vec2 operator/(const Vec2& first, const float c)
+      {
+        return Vec2(first.x, first.y).Divide(c);
+      }
+
+      float operator[](uint i)
+      {
+        assert(i < 2);
+        return *((&x)+i);
+      }
+
+      constexpr Vec2& operator+=(const Vec2 &other)
+      {
+        return Add(other);
+      }
+
+      constexpr Vec2& operator-=(const Vec2 &other)
+      {
+        return Subtract(other);
+      }
+
+      constexpr Vec2& operator*=(const Vec2 &other)
+      {
+        return Multiply(other);
+      }
+
+      constexpr Vec2& operator/=(const Vec2 &other)
+      {
+        return Divide(other);
+      }
+
+      constexpr Vec2& operator+=(const float c)
+      {
+        return Add(c);
+      }
+
+      constexpr Vec2& operator-=(const float c)
+      {
+        return Subtract(c);
+      }
+
+      constexpr Vec2& operator*=(const float c)
+      {
+        return Multiply(c);
+      }
+
+      constexpr Vec2& operator/=(const float c)
+      {
+        return Divide(c);
+      }
+
+      constexpr bool operator!=(const Vec2 &other) const
+      {
+        return !Compare(other);
+      }
+
+      constexpr bool operator==(const Vec2 &other) const
+      {
+        return Compare(other);
+      }
+
+      constexpr bool operator<(const Vec2& other) const
+      {
+        if(x == other.x)
+          return y < other.y;
+        return x < other.x;
+      }
+
+      constexpr bool operator>(const Vec2& other) const
+      {
+        if(x == other.x)
+          return y > other.y;
+        return x > other.x;
+      }
+
+      constexpr bool operator<=(const Vec2& other) const
+      {
+        if(x == other.x)
+          return y <= other.y;
+        return x <= other.x;
+      }
+
+      constexpr bool operator>=(const Vec2& other) const
+      {
+        if(x == other.x)
+          return y >= other.y;
+        return x >= other.x;
+      }
+
+      friend std::ostream& operator<<(std::ostream& stream, const Vec2& vec)
+      {
+        return stream << "(" << vec.x << ", " << vec.y << ")";
+      }
+
+      constexpr float toRadians(float degrees)
       {
         return degrees * ((float)M_PI / 180.0f);
       }
@@ -4,9 +4,12 @@
 #define _USE_MATH_DEFINES
 #endif
 
-#include <iostream>
+#include <math/Scalar.h>
 #include <math/Vec4.h>
 
+#include <cassert>
+#include <iostream>
+
 namespace Greet{
 
   struct Vec3
@@ -25,54 +28,231 @@ namespace Greet{
       };
     };
     Vec3() = default;
-    Vec3(float x, float y, float z);
-    Vec3(const Vec4& vec4);
 
-    float Length() const;
-    float Dot(const Vec3& vec) const;
-    Vec3 Cross(const Vec3& vec) const;
+    constexpr Vec3(float x, float y, float z)
+      : x{x}, y{y}, z{z}
+    {}
+
+    constexpr Vec3(const Vec4& vec4)
+      : x{vec4.x}, y{vec4.y}, z{vec4.z}
+    {}
+
+    constexpr float Length() const
+    {
+      return Math::Sqrt(x*x + y*y + z*z);
+    }
+
+    constexpr float Dot(const Vec3& vec) const
+    {
+      return x * vec.x + y * vec.y + z * vec.z;
+    }
+
+    constexpr Vec3 Cross(const Vec3& vec) const
+    {
+      float x_ = y * vec.z - z * vec.y;
+      float y_ = z * vec.x - x * vec.z;
+      float z_ = x * vec.y - y * vec.x;
+      return Vec3(x_, y_, z_);
+    }
 
     // All These modifies the current vec3
-    Vec3& Normalize();
-    Vec3& Rotate(const float& angle, const Vec3& axis);
-    Vec3& Add(const Vec3& other);
-    Vec3& Subtract(const Vec3& other);
-    Vec3& Multiply(const Vec3& other);
-    Vec3& Divide(const Vec3& other);
+    constexpr Vec3& Normalize()
+    {
+      float len = Length();
+      x /= len;
+      y /= len;
+      z /= len;
+      return *this;
+    }
+
+    // Rotates by the quaternion (axis * sin(angle / 2), cos(angle / 2)) without forming it,
+    // v' = v + 2w(q x v) + 2q x (q x v)
+    constexpr Vec3& Rotate(const float& angle, const Vec3& axis)
+    {
+      float halfAngle = Math::ToRadians(angle / 2.0f);
+      float sh = Math::Sin(halfAngle);
+      float ch = Math::Cos(halfAngle);
+
+      Vec3 q(axis.x * sh, axis.y * sh, axis.z * sh);
+      Vec3 t = q.Cross(*this);
+      t.Multiply(2.0f);
+      Vec3 u = q.Cross(t);
+
+      x += ch * t.x + u.x;
+      y += ch * t.y + u.y;
+      z += ch * t.z + u.z;
+
+      return *this;
+    }
+
+    constexpr Vec3& Add(const Vec3& other)
+    {
+      x += other.x;
+      y += other.y;
+      z += other.z;
+      return *this;
+    }
+
+    constexpr Vec3& Subtract(const Vec3& other)
+    {
+      x -= other.x;
+      y -= other.y;
+      z -= other.z;
+      return *this;
+    }
+
+    constexpr Vec3& Multiply(const Vec3& other)
+    {
+      x *= other.x;
+      y *= other.y;
+      z *= other.z;
+      return *this;
+    }
+
+    constexpr Vec3& Divide(const Vec3& other)
+    {
+      x /= other.x;
+      y /= other.y;
+      z /= other.z;
+      return *this;
+    }
+
+    constexpr Vec3& Add(const float c)
+    {
+      x += c;
+      y += c;
+      z += c;
+      return *this;
+    }
+
+    constexpr Vec3& Subtract(const float c)
+    {
+      x -= c;
+      y -= c;
+      z -= c;
+      return *this;
+    }
+
+    constexpr Vec3& Multiply(const float c)
+    {
+      x *= c;
+      y *= c;
+      z *= c;
+      return *this;
+    }
+
+    constexpr Vec3& Divide(const float c)
+    {
+      x /= c;
+      y /= c;
+      z /= c;
+      return *this;
+    }
 
-    Vec3& Add(const float other);
-    Vec3& Subtract(const float other);
-    Vec3& Multiply(const float other);
-    Vec3& Divide(const float other);
+    constexpr bool Compare(const Vec3& other) const
+    {
+      return x == other.x && y == other.y && z == other.z;
+    }
+
+    friend constexpr Vec3 operator+(const Vec3& first, const Vec3 &second)
+    {
+      return Vec3(first.x, first.y, first.z).Add(second);
+    }
+
+    friend constexpr Vec3 operator-(const Vec3& first, const Vec3 &second)
+    {
+      return Vec3(first.x, first.y, first.z).Subtract(second);
+    }
+
+    friend constexpr Vec3 operator*(const Vec3& first, const Vec3 &second)
+    {
+      return Vec3(first.x, first.y, first.z).Multiply(second);
+    }
+
+    friend constexpr Vec3 operator/(const Vec3& first, const Vec3 &second)
+    {
+      return Vec3(first.x, first.y, first.z).Divide(second);
+    }
+
+    friend constexpr Vec3 operator+(const Vec3& first, const float c)
+    {
+      return Vec3(first.x, first.y, first.z).Add(c);
+    }
+
+    friend constexpr Vec3 operator-(const Vec3& first, const float c)
+    {
+      return Vec3(first.x, first.y, first.z).Subtract(c);
+    }
+
+    friend constexpr Vec3 operator*(const Vec3& first, const float c)
+    {
+      return Vec3(first.x, first.y, first.z).Multiply(c);
+    }
+
+    friend constexpr Vec3 operator/(const Vec3& first, const float c)
+    {
+      return Vec3(first.x, first.y, first.z).Divide(c);
+    }
+
+    float operator[](uint i)
+    {
+      assert(i < 3);
+      return vals[i];
+    }
+
+    constexpr Vec3& operator+=(const Vec3 &other)
+    {
+      return Add(other);
+    }
+
+    constexpr Vec3& operator-=(const Vec3 &other)
+    {
+      return Subtract(other);
+    }
 
-    bool Compare(const Vec3& other);
+    constexpr Vec3& operator*=(const Vec3 &other)
+    {
+      return Multiply(other);
+    }
 
-    friend Vec3 operator+(const Vec3& first, const Vec3 &second);
-    friend Vec3 operator-(const Vec3& first, const Vec3 &second);
-    friend Vec3 operator*(const Vec3& first, const Vec3 &second);
-    friend Vec3 operator/(const Vec3& first, const Vec3 &second);
+    constexpr Vec3& operator/=(const Vec3 &other)
+    {
+      return Divide(other);
+    }
 
-    friend Vec3 operator+(const Vec3& first, const float c);
-    friend Vec3 operator-(const Vec3& first, const float c);
-    friend Vec3 operator*(const Vec3& first, const float c);
-    friend Vec3 operator/(const Vec3& first, const float c);
+    constexpr Vec3& operator+=(const float c)
+    {
+      return Add(c);
+    }
 
-    float operator[](uint i);
+    constexpr Vec3& operator-=(const float c)
+    {
+      return Subtract(c);
+    }
 
-    Vec3& operator+=(const Vec3 &other);
-    Vec3& operator-=(const Vec3 &other);
-    Vec3& operator*=(const Vec3 &other);
-    Vec3& operator/=(const Vec3 &other);
+    constexpr Vec3& operator*=(const float c)
+    {
+      return Multiply(c);
+    }
 
+    constexpr Vec3& operator/=(const float c)
+    {
+      return Divide(c);
+    }
 
-    Vec3& operator+=(const float c);
-    Vec3& operator-=(const float c);
-    Vec3& operator*=(const float c);
-    Vec3& operator/=(const float c);
+    constexpr bool operator!=(const Vec3 &second) const
+    {
+      return !Compare(second);
+    }
 
-    bool operator!=(const Vec3 &second);
-    bool operator==(const Vec3 &second);
+    constexpr bool operator==(const Vec3 &second) const
+    {
+      return Compare(second);
+    }
 
-    friend std::ostream& operator<<(std::ostream& stream, const Vec3& vec);
+    friend std::ostream& operator<<(std::ostream& stream, const Vec3& vec)
+    {
+      return stream << "(" << vec.x << ", " << vec.y << ", " << vec.z << ")";
+    }
   };
 }
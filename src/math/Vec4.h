@@ -4,6 +4,9 @@
 #define _USE_MATH_DEFINES
 #endif
 
+#include <math/Scalar.h>
+
+#include <cassert>
 #include <iostream>
 
 namespace Greet{
@@ -26,45 +29,175 @@ namespace Greet{
         float top, left, bottom, right;
       };
     };
-    Vec4();
-    //Vec4(const Vec4& copy);
-    Vec4(float x, float y, float z, float w);
+    constexpr Vec4()
+      : x{0}, y{0}, z{0}, w{0}
+    {}
+
+    constexpr Vec4(float x, float y, float z, float w)
+      : x{x}, y{y}, z{z}, w{w}
+    {}
+
+    constexpr float Length() const
+    {
+      return Math::Sqrt(x*x + y*y + z*z+ w*w);
+    }
+
+    constexpr Vec4& Add(const Vec4& other)
+    {
+      x += other.x;
+      y += other.y;
+      z += other.z;
+      w += other.w;
+      return *this;
+    }
+
+    constexpr Vec4& Subtract(const Vec4& other)
+    {
+      x -= other.x;
+      y -= other.y;
+      z -= other.z;
+      w -= other.w;
+      return *this;
+    }
+
+    constexpr Vec4& Multiply(const Vec4& other)
+    {
+      x *= other.x;
+      y *= other.y;
+      z *= other.z;
+      w *= other.w;
+      return *this;
+    }
+
+    constexpr Vec4& Divide(const Vec4& other)
+    {
+      x /= other.x;
+      y /= other.y;
+      z /= other.z;
+      w /= other.w;
+      return *this;
+    }
 
-    float Length();
+    constexpr Vec4& Add(const float c)
+    {
+      x += c;
+      y += c;
+      z += c;
+      w += c;
+      return *this;
+    }
 
-    Vec4& Add(const Vec4& other);
-    Vec4& Subtract(const Vec4& other);
-    Vec4& Multiply(const Vec4& other);
-    Vec4& Divide(const Vec4& other);
+    constexpr Vec4& Subtract(const float c)
+    {
+      x -= c;
+      y -= c;
+      z -= c;
+      w -= c;
+      return *this;
+    }
 
-    Vec4& Add(const float other);
-    Vec4& Subtract(const float other);
-    Vec4& Multiply(const float other);
-    Vec4& Divide(const float other);
+    constexpr Vec4& Multiply(const float c)
+    {
+      x *= c;
+      y *= c;
+      z *= c;
+      w *= c;
+      return *this;
+    }
 
-    bool Compare(const Vec4& other);
+    constexpr Vec4& Divide(const float c)
+    {
+      x /= c;
+      y /= c;
+      z /= c;
+      w /= c;
+      return *this;
+    }
 
-    friend Vec4 operator+(const Vec4& first, const Vec4 &second);
-    friend Vec4 operator-(const Vec4& first, const Vec4 &second);
-    friend Vec4 operator*(const Vec4& first, const Vec4 &second);
-    friend Vec4 operator/(const Vec4& first, const Vec4 &second);
+    constexpr bool Compare(const Vec4& other) const
+    {
+      return x == other.x && y == other.y && z == other.z && w == other.w;
+    }
 
-    friend Vec4 operator+(const Vec4& first, const float c);
-    friend Vec4 operator-(const Vec4& first, const float c);
-    friend Vec4 operator*(const Vec4& first, const float c);
-    friend Vec4 operator/(const Vec4& first, const float c);
+    friend constexpr Vec4 operator+(const Vec4& first, const Vec4 &second)
+    {
+      return Vec4(first).Add(second);
+    }
 
-    float operator[](uint i);
+    friend constexpr Vec4 operator-(const Vec4& first, const Vec4 &second)
+    {
+      return Vec4(first).Subtract(second);
+    }
 
-    Vec4& operator+=(const Vec4 &other);
-    Vec4& operator-=(const Vec4 &other);
-    Vec4& operator*=(const Vec4 &other);
-    Vec4& operator/=(const Vec4 &other);
+    friend constexpr Vec4 operator*(const Vec4& first, const Vec4 &second)
+    {
+      return Vec4(first).Multiply(second);
+    }
 
-    bool operator!=(const Vec4 &second);
-    bool operator==(const Vec4 &second);
+    friend constexpr Vec4 operator/(const Vec4& first, const Vec4 &second)
+    {
+      return Vec4(first).Divide(second);
+    }
 
-    friend std::ostream& operator<<(std::ostream& stream, const Vec4& vec);
+    friend constexpr Vec4 operator+(const Vec4& first, const float c)
+    {
+      return Vec4(first).Add(c);
+    }
 
+    friend constexpr Vec4 operator-(const Vec4& first, const float c)
+    {
+      return Vec4(first).Subtract(c);
+    }
+
+    friend constexpr Vec4 operator*(const Vec4& first, const float c)
+    {
+      return Vec4(first).Multiply(c);
+    }
+
+    friend constexpr Vec4 operator/(const Vec4& first, const float c)
+    {
+      return Vec4(first).Divide(c);
+    }
+
+    float operator[](uint i)
+    {
+      assert(i < 4);
+      return vals[i];
+    }
+
+    constexpr Vec4& operator+=(const Vec4 &other)
+    {
+      return Add(other);
+    }
+
+    constexpr Vec4& operator-=(const Vec4 &other)
+    {
+      return Subtract(other);
+    }
+
+    constexpr Vec4& operator*=(const Vec4 &other)
+    {
+      return Multiply(other);
+    }
+
+    constexpr Vec4& operator/=(const Vec4 &other)
+    {
+      return Divide(other);
+    }
+
+    constexpr bool operator!=(const Vec4 &second) const
+    {
+      return !Compare(second);
+    }
+
+    constexpr bool operator==(const Vec4 &second) const
+    {
+      return Compare(second);
+    }
+
+    friend std::ostream& operator<<(std::ostream& stream, const Vec4& vec)
+    {
+      return stream << "(" << vec.x << ", " << vec.y << ", " << vec.z << ", " << vec.w << ")";
+    }
   };
 }
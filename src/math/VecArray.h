@@ -0,0 +1,223 @@
+#pragma once
+
+#include <math/Simd.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstring>
+#include <new>
+#include <utility>
+
+namespace Greet {
+
+  // Structure of arrays storage for N component vectors. Every component is its own 64 byte
+  // aligned stream which is padded to a multiple of 4 elements, so the operations process 4
+  // vectors per instruction without a scalar tail. Padding elements are kept at zero.
+  template <int N>
+  class VecArray
+  {
+    private:
+      static const size_t ALIGNMENT = 64;
+
+      float* data = nullptr;
+      size_t size = 0;
+      size_t capacity = 0;
+
+    public:
+      VecArray() = default;
+
+      VecArray(size_t size)
+      {
+        Resize(size);
+      }
+
+      VecArray(const VecArray& other)
+      {
+        Allocate(other.capacity);
+        size = other.size;
+        if(data)
+          memcpy(data, other.data, N * capacity * sizeof(float));
+      }
+
+      VecArray(VecArray&& other)
+        : data{other.data}, size{other.size}, capacity{other.capacity}
+      {
+        other.data = nullptr;
+        other.size = 0;
+        other.capacity = 0;
+      }
+
+      ~VecArray()
+      {
+        Free();
+      }
+
+      VecArray& operator=(VecArray other)
+      {
+        std::swap(data, other.data);
+        std::swap(size, other.size);
+        std::swap(capacity, other.capacity);
+        return *this;
+      }
+
+      size_t Size() const { return size; }
+
+      // Keeps the first elements, new elements are zero
+      void Resize(size_t newSize)
+      {
+        size_t kept = std::min(size, newSize);
+        size_t newCapacity = (newSize + 3) & ~(size_t)3;
+        if(newCapacity != capacity)
+        {
+          float* old = data;
+          size_t oldCapacity = capacity;
+          data = nullptr;
+          Allocate(newCapacity);
+          if(old)
+          {
+            for(int c = 0; c < N && kept > 0; c++)
+              memcpy(Component(c), old + c * oldCapacity, kept * sizeof(float));
+            ::operator delete(old, std::align_val_t(ALIGNMENT));
+          }
+        }
+        for(int c = 0; c < N && data; c++)
+          memset(Component(c) + kept, 0, (capacity - kept) * sizeof(float));
+        size = newSize;
+      }
+
+      float* Component(int component) { return data + component * capacity; }
+      const float* Component(int component) const { return data + component * capacity; }
+
+      float* X() { return Component(0); }
+      float* Y() { static_assert(N >= 2, "No y component"); return Component(1); }
+      float* Z() { static_assert(N >= 3, "No z component"); return Component(2); }
+      float* W() { static_assert(N >= 4, "No w component"); return Component(3); }
+      const float* X() const { return Component(0); }
+      const float* Y() const { static_assert(N >= 2, "No y component"); return Component(1); }
+      const float* Z() const { static_assert(N >= 3, "No z component"); return Component(2); }
+      const float* W() const { static_assert(N >= 4, "No w component"); return Component(3); }
+
+      VecArray& Add(const VecArray& other) { return Apply(other, [](Simd::Float4 a, Simd::Float4 b) { return Simd::Add(a, b); }); }
+      VecArray& Subtract(const VecArray& other) { return Apply(other, [](Simd::Float4 a, Simd::Float4 b) { return Simd::Sub(a, b); }); }
+      VecArray& Multiply(const VecArray& other) { return Apply(other, [](Simd::Float4 a, Simd::Float4 b) { return Simd::Mul(a, b); }); }
+
+      VecArray& Multiply(float scalar)
+      {
+        Simd::Float4 s = Simd::Splat(scalar);
+        for(size_t i = 0; i < N * capacity; i += 4)
+          Simd::Store(data + i, Simd::Mul(Simd::Load(data + i), s));
+        return *this;
+      }
+
+      // Writes Size() dot products to out, which needs room for Size() rounded up to 4 floats
+      void Dot(const VecArray& other, float* out) const
+      {
+        assert(size == other.size);
+        for(size_t i = 0; i < capacity; i += 4)
+        {
+          Simd::Float4 sum = Simd::Mul(Simd::Load(Component(0) + i), Simd::Load(other.Component(0) + i));
+          for(int c = 1; c < N; c++)
+            sum = Simd::MulAdd(Simd::Load(Component(c) + i), Simd::Load(other.Component(c) + i), sum);
+          Simd::Store(out + i, sum);
+        }
+      }
+
+      // Same requirements on out as Dot
+      void Length(float* out) const
+      {
+        Dot(*this, out);
+        for(size_t i = 0; i < capacity; i += 4)
+          Simd::Store(out + i, Simd::Sqrt(Simd::Load(out + i)));
+      }
+
+      // Zero length vectors become NaN, the same as Vec3::Normalize
+      VecArray& Normalize()
+      {
+        for(size_t i = 0; i < capacity; i += 4)
+        {
+          Simd::Float4 lengthSq = Simd::Mul(Simd::Load(Component(0) + i), Simd::Load(Component(0) + i));
+          for(int c = 1; c < N; c++)
+            lengthSq = Simd::MulAdd(Simd::Load(Component(c) + i), Simd::Load(Component(c) + i), lengthSq);
+          Simd::Float4 length = Simd::Sqrt(lengthSq);
+          for(int c = 0; c < N; c++)
+            Simd::Store(Component(c) + i, Simd::Div(Simd::Load(Component(c) + i), length));
+        }
+        // Padding must stay zero so that later operations keep it finite
+        for(int c = 0; c < N && data; c++)
+          memset(Component(c) + size, 0, (capacity - size) * sizeof(float));
+        return *this;
+      }
+
+      // Reads count interleaved vectors, stride is in bytes and data points to the first x, for
+      // example FromInterleaved(&vertices[0].position.x, sizeof(Vertex), vertices.size())
+      void FromInterleaved(const float* data, size_t stride, size_t count)
+      {
+        Resize(count);
+        const char* src = reinterpret_cast<const char*>(data);
+        for(size_t i = 0; i < count; i++, src += stride)
+        {
+          const float* element = reinterpret_cast<const float*>(src);
+          for(int c = 0; c < N; c++)
+            Component(c)[i] = element[c];
+        }
+      }
+
+      // Writes Size() vectors into interleaved memory, leaving the other attributes untouched
+      void ToInterleaved(float* data, size_t stride) const
+      {
+        char* dst = reinterpret_cast<char*>(data);
+        for(size_t i = 0; i < size; i++, dst += stride)
+        {
+          float* element = reinterpret_cast<float*>(dst);
+          for(int c = 0; c < N; c++)
+            element[c] = Component(c)[i];
+        }
+      }
+
+    private:
+      void Allocate(size_t newCapacity)
+      {
+        capacity = newCapacity;
+        if(capacity > 0)
+          data = static_cast<float*>(::operator new(N * capacity * sizeof(float), std::align_val_t(ALIGNMENT)));
+      }
+
+      void Free()
+      {
+        if(data)
+          ::operator delete(data, std::align_val_t(ALIGNMENT));
+        data = nullptr;
+      }
+
+      template <typename Op>
+      VecArray& Apply(const VecArray& other, Op op)
+      {
+        assert(size == other.size);
+        // Both have the same capacity when the sizes match
+        for(size_t i = 0; i < N * capacity; i += 4)
+          Simd::Store(data + i, op(Simd::Load(data + i), Simd::Load(other.data + i)));
+        return *this;
+      }
+  };
+
+  typedef VecArray<2> Vec2Array;
+  typedef VecArray<3> Vec3Array;
+  typedef VecArray<4> Vec4Array;
+
+  // out may be a or b
+  inline void Cross(const Vec3Array& a, const Vec3Array& b, Vec3Array& out)
+  {
+    assert(a.Size() == b.Size());
+    if(out.Size() != a.Size())
+      out.Resize(a.Size());
+    for(size_t i = 0; i < a.Size(); i += 4)
+    {
+      Simd::Float4 ax = Simd::Load(a.X() + i), ay = Simd::Load(a.Y() + i), az = Simd::Load(a.Z() + i);
+      Simd::Float4 bx = Simd::Load(b.X() + i), by = Simd::Load(b.Y() + i), bz = Simd::Load(b.Z() + i);
+      Simd::Store(out.X() + i, Simd::Sub(Simd::Mul(ay, bz), Simd::Mul(az, by)));
+      Simd::Store(out.Y() + i, Simd::Sub(Simd::Mul(az, bx), Simd::Mul(ax, bz)));
+      Simd::Store(out.Z() + i, Simd::Sub(Simd::Mul(ax, by), Simd::Mul(ay, bx)));
+    }
+  }
+}
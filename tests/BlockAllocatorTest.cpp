@@ -0,0 +1,336 @@
+#include "Test.h"
+
+#include <BlockAllocator.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <stdexcept>
+
+namespace
+{
+  const VkDeviceSize MiB = 1024 * 1024;
+  const VkDeviceSize GRANULARITY = 1024;
+  const uint32_t DEVICE_LOCAL = 0;
+  const uint32_t HOST_VISIBLE = 1;
+
+  // A discrete GPU with a large device local heap and a small host visible one, where the
+  // allocator picks 64 MiB and 8 MiB blocks
+  VkPhysicalDeviceMemoryProperties FakeMemoryProperties()
+  {
+    VkPhysicalDeviceMemoryProperties properties = {};
+    properties.memoryHeapCount = 2;
+    properties.memoryHeaps[0].size = 4096 * MiB;
+    properties.memoryHeaps[0].flags = VK_MEMORY_HEAP_DEVICE_LOCAL_BIT;
+    properties.memoryHeaps[1].size = 64 * MiB;
+    properties.memoryTypeCount = 2;
+    properties.memoryTypes[DEVICE_LOCAL].propertyFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    properties.memoryTypes[DEVICE_LOCAL].heapIndex = 0;
+    properties.memoryTypes[HOST_VISIBLE].propertyFlags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+    properties.memoryTypes[HOST_VISIBLE].heapIndex = 1;
+    return properties;
+  }
+
+  // Hands out fake VkDeviceMemory handles and keeps track of which ones are still alive
+  struct FakeDevice
+  {
+    struct Memory
+    {
+      uint32_t memoryType;
+      VkDeviceSize size;
+      std::unique_ptr<char[]> mapped;
+    };
+
+    uintptr_t nextHandle = 1;
+    std::map<VkDeviceMemory, Memory> memories;
+    uint32_t allocateCount = 0;
+    uint32_t freeCount = 0;
+    bool failNext = false;
+
+    BlockAllocator CreateAllocator(uint32_t maxAllocationCount = 4096)
+    {
+      return BlockAllocator{FakeMemoryProperties(), GRANULARITY, maxAllocationCount,
+        [this](uint32_t memoryType, VkDeviceSize size, void** mapped)
+        {
+          if(failNext)
+          {
+            failNext = false;
+            throw std::runtime_error("Failed to allocate memory block");
+          }
+          VkDeviceMemory memory = (VkDeviceMemory)nextHandle++;
+          Memory& entry = memories[memory];
+          entry = {memoryType, size, nullptr};
+          if(mapped)
+          {
+            // Never touched beyond what the tests write, so the pages are never committed
+            entry.mapped.reset(new char[size]);
+            *mapped = entry.mapped.get();
+          }
+          allocateCount++;
+          return memory;
+        },
+        [this](VkDeviceMemory memory, bool mapped)
+        {
+          auto it = memories.find(memory);
+          if(it == memories.end())
+            throw std::runtime_error("Freeing unknown memory");
+          if(mapped != (it->second.mapped != nullptr))
+            throw std::runtime_error("Mapped state doesn't match");
+          memories.erase(it);
+          freeCount++;
+        }};
+    }
+  };
+
+  VkMemoryRequirements Requirements(VkDeviceSize size, VkDeviceSize alignment, uint32_t typeBits = 0x3)
+  {
+    return {size, alignment, typeBits};
+  }
+}
+
+TEST(BlockAllocatorFindMemoryType)
+{
+  VkPhysicalDeviceMemoryProperties properties = FakeMemoryProperties();
+  CHECK_EQ(BlockAllocator::FindMemoryType(properties, 0x3, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT), DEVICE_LOCAL);
+  CHECK_EQ(BlockAllocator::FindMemoryType(properties, 0x3, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT), HOST_VISIBLE);
+  CHECK_EQ(BlockAllocator::FindMemoryType(properties, 0x3, 0), DEVICE_LOCAL);
+  CHECK_EQ(BlockAllocator::FindMemoryType(properties, 0x2, 0), HOST_VISIBLE);
+  CHECK_THROWS(BlockAllocator::FindMemoryType(properties, 0x1, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT));
+  CHECK_THROWS(BlockAllocator::FindMemoryType(properties, 0x4, 0));
+}
+
+TEST(BlockAllocatorBlockSize)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+  CHECK_EQ(allocator.GetPreferredBlockSize(DEVICE_LOCAL), BlockAllocator::DEFAULT_BLOCK_SIZE);
+  CHECK_EQ(allocator.GetPreferredBlockSize(HOST_VISIBLE), 8 * MiB);
+}
+
+TEST(BlockAllocatorAlignment)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+
+  MemoryAllocation a = allocator.Allocate(Requirements(100, 1), 0, ResourceType::Linear);
+  MemoryAllocation b = allocator.Allocate(Requirements(100, 256), 0, ResourceType::Linear);
+  MemoryAllocation c = allocator.Allocate(Requirements(10, 64), 0, ResourceType::Linear);
+  CHECK_EQ(a.offset, 0u);
+  CHECK_EQ(a.padding, 0u);
+  CHECK_EQ(b.offset, 256u);
+  CHECK_EQ(b.padding, 156u);
+  CHECK_EQ(c.offset, 384u);
+  CHECK_EQ(c.padding, 28u);
+  CHECK_EQ(a.memory, b.memory);
+  CHECK_EQ(device.allocateCount, 1u);
+
+  // The range freed by b is reused, with the padding recomputed for the new alignment
+  allocator.Free(b);
+  MemoryAllocation d = allocator.Allocate(Requirements(128, 128), 0, ResourceType::Linear);
+  CHECK_EQ(d.offset, 128u);
+  CHECK_EQ(d.padding, 28u);
+  CHECK(b.block == nullptr);
+}
+
+TEST(BlockAllocatorGranularity)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+
+  MemoryAllocation buffer = allocator.Allocate(Requirements(100, 16), 0, ResourceType::Linear);
+  MemoryAllocation image = allocator.Allocate(Requirements(100, 16), 0, ResourceType::Optimal);
+  MemoryAllocation image2 = allocator.Allocate(Requirements(100, 16), 0, ResourceType::Optimal);
+  MemoryAllocation buffer2 = allocator.Allocate(Requirements(100, 16), 0, ResourceType::Linear);
+
+  // An optimal resource after a linear one starts on the next page, resources of the same
+  // kind are packed
+  CHECK_EQ(buffer.offset, 0u);
+  CHECK_EQ(image.offset, GRANULARITY);
+  CHECK_EQ(image.padding, GRANULARITY - 100);
+  CHECK_EQ(image2.offset, GRANULARITY + 112);
+  CHECK_EQ(buffer2.offset, 2 * GRANULARITY);
+
+  // The padding keeps the image on the next page, so a linear resource fits in the range freed
+  // in front of it
+  allocator.Free(buffer);
+  MemoryAllocation buffer3 = allocator.Allocate(Requirements(64, 16), 0, ResourceType::Linear);
+  CHECK_EQ(buffer3.offset, 0u);
+
+  // Without a conflicting neighbour nothing is padded
+  MemoryAllocation buffer4 = allocator.Allocate(Requirements(32, 16), 0, ResourceType::Linear);
+  CHECK_EQ(buffer4.offset, 64u);
+  CHECK_EQ(buffer4.padding, 0u);
+
+  // A linear resource which would end on the page of image2 doesn't fit in front of it
+  allocator.Free(image);
+  MemoryAllocation buffer5 = allocator.Allocate(Requirements(GRANULARITY, 16), 0, ResourceType::Linear);
+  CHECK_EQ(buffer5.offset, 2 * GRANULARITY + 112);
+  CHECK_EQ(allocator.GetStats().bytesWasted, image2.padding + buffer2.padding + buffer5.padding);
+}
+
+TEST(BlockAllocatorMergeOnFree)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+
+  MemoryAllocation a = allocator.Allocate(Requirements(1000, 16), 0, ResourceType::Linear);
+  MemoryAllocation b = allocator.Allocate(Requirements(1000, 16), 0, ResourceType::Linear);
+  MemoryAllocation c = allocator.Allocate(Requirements(1000, 16), 0, ResourceType::Linear);
+  REQUIRE(allocator.GetBlocks(DEVICE_LOCAL).size() == 1);
+  const MemoryBlock* block = allocator.GetBlocks(DEVICE_LOCAL)[0];
+  CHECK_EQ(block->suballocations.size(), 4u);
+
+  // Freeing c merges it with the free tail, a can't merge with anything yet
+  allocator.Free(c);
+  CHECK_EQ(block->suballocations.size(), 3u);
+  allocator.Free(a);
+  CHECK_EQ(block->suballocations.size(), 3u);
+
+  // b merges with both of its neighbours
+  allocator.Free(b);
+  REQUIRE(block->suballocations.size() == 1);
+  CHECK_EQ(block->suballocations.begin()->first, 0u);
+  CHECK_EQ(block->suballocations.begin()->second.size, block->size);
+  CHECK(block->suballocations.begin()->second.type == ResourceType::Free);
+  CHECK_EQ(block->freeBytes, block->size);
+
+  // The merged range fits an allocation larger than any of the freed ones
+  MemoryAllocation d = allocator.Allocate(Requirements(3000, 16), 0, ResourceType::Linear);
+  CHECK_EQ(d.offset, 0u);
+  CHECK_EQ(device.allocateCount, 1u);
+}
+
+TEST(BlockAllocatorDedicated)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+  VkDeviceSize half = BlockAllocator::DEFAULT_BLOCK_SIZE / 2;
+
+  // Up to half a block is sub-allocated
+  MemoryAllocation shared = allocator.Allocate(Requirements(half, 256), 0, ResourceType::Optimal);
+  CHECK(!shared.block->dedicated);
+  CHECK_EQ(shared.block->size, BlockAllocator::DEFAULT_BLOCK_SIZE);
+
+  MemoryAllocation dedicated = allocator.Allocate(Requirements(half + 1, 256), 0, ResourceType::Optimal);
+  REQUIRE(dedicated.block != nullptr);
+  CHECK(dedicated.block->dedicated);
+  CHECK_EQ(dedicated.block->size, half + 1);
+  CHECK_EQ(dedicated.offset, 0u);
+  CHECK_EQ(device.memories[dedicated.memory].size, half + 1);
+  CHECK_EQ(allocator.GetStats().blockCount, 2u);
+
+  // Small allocations never go into a dedicated block, even if it had room
+  MemoryAllocation small = allocator.Allocate(Requirements(16, 16), 0, ResourceType::Linear);
+  CHECK_EQ(small.memory, shared.memory);
+
+  // A dedicated block is released as soon as its resource is
+  VkDeviceMemory memory = dedicated.memory;
+  allocator.Free(dedicated);
+  CHECK_EQ(device.memories.count(memory), 0u);
+  CHECK_EQ(allocator.GetStats().blockCount, 1u);
+}
+
+TEST(BlockAllocatorKeepsOneEmptyBlock)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+  VkDeviceSize size = 20 * MiB;
+
+  // Alternating an allocation and a free doesn't allocate device memory every time
+  for(int i = 0; i < 4; i++)
+  {
+    MemoryAllocation allocation = allocator.Allocate(Requirements(size, 256), 0, ResourceType::Linear);
+    allocator.Free(allocation);
+  }
+  CHECK_EQ(device.allocateCount, 1u);
+  CHECK_EQ(device.freeCount, 0u);
+  CHECK_EQ(allocator.GetStats().blockCount, 1u);
+
+  // Three fit in a 64 MiB block, the fourth needs a second one
+  MemoryAllocation allocations[4];
+  for(auto&& allocation : allocations)
+    allocation = allocator.Allocate(Requirements(size, 256), 0, ResourceType::Linear);
+  CHECK_EQ(device.allocateCount, 2u);
+  CHECK(allocations[3].memory != allocations[0].memory);
+
+  // Once both are empty only one of them is kept
+  for(auto&& allocation : allocations)
+    allocator.Free(allocation);
+  CHECK_EQ(device.freeCount, 1u);
+  CHECK_EQ(allocator.GetStats().blockCount, 1u);
+  CHECK_EQ(allocator.GetStats().bytesReserved, BlockAllocator::DEFAULT_BLOCK_SIZE);
+  CHECK_EQ(device.memories.size(), 1u);
+}
+
+TEST(BlockAllocatorStats)
+{
+  FakeDevice device;
+  {
+    BlockAllocator allocator = device.CreateAllocator();
+    const MemoryStats& stats = allocator.GetStats();
+    CHECK_EQ(stats.blockCount, 0u);
+    CHECK_EQ(stats.bytesReserved, 0u);
+
+    MemoryAllocation a = allocator.Allocate(Requirements(100, 1), 0, ResourceType::Linear);
+    MemoryAllocation b = allocator.Allocate(Requirements(100, 256), 0, ResourceType::Linear);
+    MemoryAllocation c = allocator.Allocate(Requirements(1000, 4), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, ResourceType::Linear);
+    CHECK_EQ(stats.allocationCount, 3u);
+    CHECK_EQ(stats.bytesUsed, 1200u);
+    CHECK_EQ(stats.bytesWasted, 156u);
+    CHECK_EQ(stats.blockCount, 2u);
+    CHECK_EQ(stats.bytesReserved, BlockAllocator::DEFAULT_BLOCK_SIZE + 8 * MiB);
+
+    allocator.Free(b);
+    CHECK_EQ(stats.allocationCount, 2u);
+    CHECK_EQ(stats.bytesUsed, 1100u);
+    CHECK_EQ(stats.bytesWasted, 0u);
+
+    allocator.Free(a);
+    allocator.Free(c);
+    CHECK_EQ(stats.allocationCount, 0u);
+    CHECK_EQ(stats.bytesUsed, 0u);
+    // Both blocks are the only empty one of their memory type
+    CHECK_EQ(stats.blockCount, 2u);
+  }
+  // Destroying the allocator frees every block
+  CHECK_EQ(device.memories.size(), 0u);
+  CHECK_EQ(device.freeCount, 2u);
+}
+
+TEST(BlockAllocatorMapping)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator();
+
+  MemoryAllocation local = allocator.Allocate(Requirements(100, 16), 0, ResourceType::Linear);
+  CHECK(local.mapped == nullptr);
+  CHECK_EQ(local.memoryType, DEVICE_LOCAL);
+
+  MemoryAllocation a = allocator.Allocate(Requirements(100, 16), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, ResourceType::Linear);
+  MemoryAllocation b = allocator.Allocate(Requirements(100, 64), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, ResourceType::Linear);
+  CHECK_EQ(a.memoryType, HOST_VISIBLE);
+  REQUIRE(a.mapped != nullptr);
+  CHECK(a.mapped == device.memories[a.memory].mapped.get());
+  CHECK(static_cast<char*>(b.mapped) == static_cast<char*>(a.mapped) + b.offset);
+}
+
+TEST(BlockAllocatorFailedBlock)
+{
+  FakeDevice device;
+  BlockAllocator allocator = device.CreateAllocator(2);
+
+  device.failNext = true;
+  CHECK_THROWS(allocator.Allocate(Requirements(100, 16), 0, ResourceType::Linear));
+  CHECK_EQ(allocator.GetStats().blockCount, 0u);
+  CHECK_EQ(allocator.GetStats().bytesReserved, 0u);
+  CHECK_EQ(allocator.GetStats().allocationCount, 0u);
+  CHECK(allocator.GetBlocks(DEVICE_LOCAL).empty());
+
+  // The failed block doesn't count towards maxMemoryAllocationCount
+  MemoryAllocation a = allocator.Allocate(Requirements(100, 16), 0, ResourceType::Linear);
+  MemoryAllocation b = allocator.Allocate(Requirements(100, 16), VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT, ResourceType::Linear);
+  CHECK(a.block != nullptr);
+  CHECK(b.block != nullptr);
+  CHECK_THROWS(allocator.Allocate(Requirements(BlockAllocator::DEFAULT_BLOCK_SIZE, 16), 0, ResourceType::Linear));
+  CHECK_EQ(device.allocateCount, 2u);
+}
@@ -0,0 +1,47 @@
+#include "Test.h"
+
+#include <math/Maths.h>
+
+// Compile time evaluation of the math library, this fails to compile if any of it stops being
+// constexpr or the constexpr paths disagree with the expected values. Compilers without
+// __builtin_is_constant_evaluated only get the runtime paths, so there is nothing to check.
+#if defined(GREET_CONSTEXPR_MATH)
+
+using namespace Greet;
+
+namespace
+{
+  constexpr bool Near(float a, float b) { return a - b < 1e-5f && b - a < 1e-5f; }
+
+  constexpr Mat4 TRANSLATE = Mat4::Translate(1, 2, 3);
+  constexpr Vec4 TRANSLATED = TRANSLATE * Vec3(1, 1, 1);
+  static_assert(TRANSLATED.x == 2 && TRANSLATED.y == 3 && TRANSLATED.z == 4 && TRANSLATED.w == 1, "Mat4 * Vec3");
+
+  constexpr Mat4 SCALED = Mat4::Scale(2, 4, 8) * Mat4::Translate(1, 1, 1);
+  static_assert(SCALED.elements[12] == 2 && SCALED.elements[13] == 4 && SCALED.elements[14] == 8, "Mat4 * Mat4");
+
+  constexpr Mat4 INVERSE = Mat4::Inverse(SCALED) * SCALED;
+  static_assert(Near(INVERSE.elements[0], 1) && Near(INVERSE.elements[5], 1) && Near(INVERSE.elements[12], 0), "Mat4::Inverse");
+
+  constexpr Mat4 PROJECTION = Mat4::ProjectionMatrix(1.0f, 90.0f, 0.1f, 10.0f);
+  static_assert(Near(PROJECTION.elements[0], 1) && PROJECTION.elements[11] == -1, "Mat4::ProjectionMatrix");
+
+  constexpr Vec4 ROTATED = Mat4::RotateZ(90) * Vec3(1, 0, 0);
+  static_assert(Near(ROTATED.x, 0) && Near(ROTATED.y, 1), "Mat4::RotateZ");
+
+  static_assert(Near(Vec3(3, 4, 0).Length(), 5) && Vec3(1, 0, 0).Cross(Vec3(0, 1, 0)).z == 1, "Vec3");
+  static_assert(Near(Math::Sin(Math::ToRadians(30)), 0.5f) && Near(Math::Cos(Math::ToRadians(720)), 1), "Math::Sin, Math::Cos");
+  static_assert(Near(Math::Atan2(-1, -1), Math::ToRadians(-135)) && Near(Math::Asin(0.5f), Math::ToRadians(30)), "Math::Atan2, Math::Asin");
+
+  constexpr Quaternion QUARTER_TURN = Quaternion::Rotation(90, Vec3(0, 0, 1));
+  constexpr Vec3 QUARTER_TURNED = QUARTER_TURN.Rotate(Vec3(1, 0, 0));
+  static_assert(Near(QUARTER_TURNED.x, 0) && Near(QUARTER_TURNED.y, 1), "Quaternion::Rotate");
+  static_assert(Near(QUARTER_TURN.ToMat4().elements[4], Mat4::Rotate(90, Vec3(0, 0, 1)).elements[4]), "Quaternion::ToMat4");
+  static_assert(Near(Quaternion::Nlerp(Quaternion(), QUARTER_TURN, 0.5f).Length(), 1), "Quaternion::Nlerp");
+
+  constexpr Frustum VIEW_FRUSTUM = Frustum(Mat4::ProjectionMatrix(1.0f, 90.0f, 0.1f, 10.0f));
+  static_assert(VIEW_FRUSTUM.Contains(Vec3(0, 0, -1)) && !VIEW_FRUSTUM.Contains(Vec3(0, 0, 1)), "Frustum::Contains");
+  static_assert(VIEW_FRUSTUM.Intersects(Sphere(Vec3(0, 0, 0.5f), 1)) && !VIEW_FRUSTUM.Intersects(AABB(Vec3(2, 0, -1), Vec3(3, 1, -0.5f))), "Frustum::Intersects");
+}
+
+#endif
@@ -0,0 +1,226 @@
+#include "Test.h"
+
+#include <math/FastMath.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Greet;
+
+// Enforces the error bounds documented in FastMath.h against double precision libm. This file
+// is also built with GREET_NO_SIMD, where the float overloads are libm itself and only the
+// Float4 ones run the polynomials on the scalar backend.
+namespace
+{
+  // Error of value in units of the last place of a float at reference
+  double Ulp(double reference, float value)
+  {
+    int exponent;
+    std::frexp(std::fabs(reference), &exponent);
+    double ulp = std::max(std::ldexp(1.0, exponent - 24), 1.4e-45);
+    return std::fabs(value - reference) / ulp;
+  }
+
+  // Largest errors of the Float4 and float overloads of a function over the added inputs. The
+  // Float4 overload gets four different inputs at a time so that every lane is covered.
+  template <typename Vector, typename Scalar, typename Reference>
+  class Sweep
+  {
+    private:
+      Vector vector;
+      Scalar scalar;
+      Reference reference;
+      float x[4];
+      float y[4];
+      int count = 0;
+
+    public:
+      double vectorUlp = 0;
+      double scalarUlp = 0;
+      double vectorError = 0;
+      double scalarError = 0;
+
+      Sweep(Vector vector, Scalar scalar, Reference reference)
+        : vector{vector}, scalar{scalar}, reference{reference}
+      {}
+
+      void Add(float xValue, float yValue = 0.0f)
+      {
+        x[count] = xValue;
+        y[count] = yValue;
+        if(++count < 4)
+          return;
+        count = 0;
+
+        float out[4];
+        Simd::Store(out, vector(Simd::Load(x), Simd::Load(y)));
+        for(int i = 0; i < 4; i++)
+        {
+          double expected = reference(x[i], y[i]);
+          float value = scalar(x[i], y[i]);
+          vectorUlp = std::max(vectorUlp, Ulp(expected, out[i]));
+          scalarUlp = std::max(scalarUlp, Ulp(expected, value));
+          vectorError = std::max(vectorError, std::fabs(out[i] - expected));
+          scalarError = std::max(scalarError, std::fabs(value - expected));
+        }
+      }
+
+      // Evaluates the inputs that don't fill all four lanes yet
+      void Finish()
+      {
+        while(count > 0)
+          Add(x[0], y[0]);
+      }
+  };
+
+  template <typename Vector, typename Scalar, typename Reference>
+  Sweep<Vector, Scalar, Reference> MakeSweep(Vector vector, Scalar scalar, Reference reference)
+  {
+    return Sweep<Vector, Scalar, Reference>(vector, scalar, reference);
+  }
+
+  auto SinSweep()
+  {
+    return MakeSweep(
+        [](Simd::Float4 x, Simd::Float4) { return Math::Fast::Sin(x); },
+        [](float x, float) { return Math::Fast::Sin(x); },
+        [](float x, float) { return std::sin((double)x); });
+  }
+
+  auto CosSweep()
+  {
+    return MakeSweep(
+        [](Simd::Float4 x, Simd::Float4) { return Math::Fast::Cos(x); },
+        [](float x, float) { return Math::Fast::Cos(x); },
+        [](float x, float) { return std::cos((double)x); });
+  }
+
+  // SinCos has to give the same results as Sin and Cos
+  void CheckSinCos(float x)
+  {
+    float sin, cos;
+    Math::Fast::SinCos(x, sin, cos);
+    CHECK_EQ(sin, Math::Fast::Sin(x));
+    CHECK_EQ(cos, Math::Fast::Cos(x));
+  }
+}
+
+TEST(FastMathSinCos)
+{
+  auto sin = SinSweep();
+  auto cos = CosSweep();
+  auto sinWide = SinSweep();
+  auto cosWide = CosSweep();
+  for(float x = -8192; x < 8192; x += 0.000731f * (1 + std::fabs(x) * 0.01f))
+  {
+    auto& sinSweep = std::fabs(x) < 256 ? sin : sinWide;
+    auto& cosSweep = std::fabs(x) < 256 ? cos : cosWide;
+    sinSweep.Add(x);
+    cosSweep.Add(x);
+  }
+  for(float x = 1e-30f; x < 1; x *= 1.0001f)
+  {
+    sin.Add(x);
+    sin.Add(-x);
+  }
+  CheckSinCos(0.5f);
+  CheckSinCos(-1000.25f);
+  for(auto* sweep : {&sin, &sinWide})
+    sweep->Finish();
+  for(auto* sweep : {&cos, &cosWide})
+    sweep->Finish();
+  CHECK_LE(sin.vectorUlp, 1.6);
+  CHECK_LE(sin.scalarUlp, 1.6);
+  CHECK_LE(cos.vectorUlp, 1.6);
+  CHECK_LE(cos.scalarUlp, 1.6);
+  CHECK_LE(sinWide.vectorUlp, 2.4);
+  CHECK_LE(sinWide.scalarUlp, 2.4);
+  CHECK_LE(cosWide.vectorUlp, 2.4);
+  CHECK_LE(cosWide.scalarUlp, 2.4);
+
+  auto sinLarge = SinSweep();
+  auto cosLarge = CosSweep();
+  for(float x = 8192; x < 1e5f; x += 0.37f)
+  {
+    sinLarge.Add(x);
+    sinLarge.Add(-x);
+    cosLarge.Add(x);
+  }
+  sinLarge.Finish();
+  cosLarge.Finish();
+  CHECK_LE(sinLarge.vectorError, 1e-6);
+  CHECK_LE(sinLarge.scalarError, 1e-6);
+  CHECK_LE(cosLarge.vectorError, 1e-6);
+  CHECK_LE(cosLarge.scalarError, 1e-6);
+}
+
+TEST(FastMathTan)
+{
+  auto tan = MakeSweep(
+      [](Simd::Float4 x, Simd::Float4) { return Math::Fast::Tan(x); },
+      [](float x, float) { return Math::Fast::Tan(x); },
+      [](float x, float) { return std::tan((double)x); });
+  for(float x = -1.5f; x < 1.5f; x += 1e-5f)
+    tan.Add(x);
+  tan.Finish();
+  CHECK_LE(tan.vectorUlp, 3.1);
+  CHECK_LE(tan.scalarUlp, 3.1);
+}
+
+TEST(FastMathRsqrt)
+{
+  auto rsqrt = MakeSweep(
+      [](Simd::Float4 x, Simd::Float4) { return Math::Fast::Rsqrt(x); },
+      [](float x, float) { return Math::Fast::Rsqrt(x); },
+      [](float x, float) { return 1 / std::sqrt((double)x); });
+  for(float x = 1.2e-38f; x < 1e38f; x *= 1.00001f)
+    rsqrt.Add(x);
+  rsqrt.Finish();
+  CHECK_LE(rsqrt.vectorUlp, 2.4);
+  CHECK_LE(rsqrt.scalarUlp, 2.4);
+}
+
+TEST(FastMathAtan2)
+{
+  auto atan2 = MakeSweep(
+      [](Simd::Float4 y, Simd::Float4 x) { return Math::Fast::Atan2(y, x); },
+      [](float y, float x) { return Math::Fast::Atan2(y, x); },
+      [](float y, float x) { return std::atan2((double)y, (double)x); });
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> distribution(-1, 1);
+  for(int i = 0; i < 4000000; i++)
+  {
+    float y = distribution(rng) * std::pow(10.0f, distribution(rng) * 3);
+    float x = distribution(rng) * std::pow(10.0f, distribution(rng) * 3);
+    atan2.Add(y, x);
+  }
+  for(float y : {0.0f, 1.0f, -1.0f})
+  {
+    for(float x : {0.0f, 1.0f, -1.0f})
+    {
+      if(y != 0 || x != 0)
+        atan2.Add(y, x);
+    }
+  }
+  atan2.Finish();
+  CHECK_LE(atan2.vectorUlp, 3.2);
+  CHECK_LE(atan2.scalarUlp, 3.2);
+  CHECK_EQ(Math::Fast::Atan2(0.0f, 0.0f), 0.0f);
+  CHECK_EQ(Simd::GetX(Math::Fast::Atan2(Simd::Splat(0.0f), Simd::Splat(0.0f))), 0.0f);
+}
+
+TEST(FastMathAsin)
+{
+  auto asin = MakeSweep(
+      [](Simd::Float4 x, Simd::Float4) { return Math::Fast::Asin(x); },
+      [](float x, float) { return Math::Fast::Asin(x); },
+      [](float x, float) { return std::asin((double)x); });
+  for(float x = -1; x <= 1; x += 1e-6f)
+    asin.Add(x);
+  asin.Add(1.0f);
+  asin.Finish();
+  CHECK_LE(asin.vectorUlp, 3.7);
+  CHECK_LE(asin.scalarUlp, 3.7);
+}
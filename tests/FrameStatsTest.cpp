@@ -0,0 +1,52 @@
+#include "Test.h"
+
+#include <FrameStats.h>
+
+#include <cmath>
+
+TEST(RunningSummaryMatchesTwoPass)
+{
+  RunningSummary summary;
+  CHECK_EQ(summary.GetStddev(), 0.0);
+
+  // Frame times around 16.6 ms, where a naive sum of squares would lose most of its precision
+  std::vector<double> values;
+  for(int i = 0; i < 100000; i++)
+    values.push_back(16.6 + 0.5 * std::sin(i * 0.37) + (i % 1000 == 0 ? 30.0 : 0.0));
+  for(auto&& value : values)
+    summary.Add(value);
+
+  double min = values[0], max = values[0], avg = 0, variance = 0;
+  for(auto&& value : values)
+  {
+    min = std::min(min, value);
+    max = std::max(max, value);
+    avg += value;
+  }
+  avg /= values.size();
+  for(auto&& value : values)
+    variance += (value - avg) * (value - avg);
+
+  CHECK_EQ(summary.count, values.size());
+  CHECK_EQ(summary.min, min);
+  CHECK_EQ(summary.max, max);
+  CHECK_LE(std::fabs(summary.avg - avg), 1e-9);
+  CHECK_LE(std::fabs(summary.GetStddev() - std::sqrt(variance / values.size())), 1e-9);
+}
+
+TEST(FrameStatsReportClears)
+{
+  FrameStats stats(2);
+  auto now = std::chrono::high_resolution_clock::now();
+  for(uint32_t i = 0; i < 10; i++)
+  {
+    stats.FrameSubmitted(i % 2, now);
+    CHECK(stats.IsPending(i % 2));
+    stats.FrameCompleted(i % 2);
+    CHECK(!stats.IsPending(i % 2));
+  }
+  // The first submit only starts the clock
+  CHECK_EQ(stats.GetFrameCount(), 9u);
+  stats.PrintReport("test");
+  CHECK_EQ(stats.GetFrameCount(), 0u);
+}
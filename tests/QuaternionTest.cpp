@@ -0,0 +1,134 @@
+#include "Test.h"
+
+#include <ThreadPool.h>
+#include <math/BatchQuaternion.h>
+#include <math/Maths.h>
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+using namespace Greet;
+
+namespace
+{
+  // The bounds quoted when the quaternion code was fixed, with a little headroom
+  const float MATRIX_TOLERANCE = 1e-6f;
+  const float SLERP_TOLERANCE = 1e-6f;
+
+  float MaxDifference(const Vec3& first, const Vec3& second)
+  {
+    return std::max({std::fabs(first.x - second.x), std::fabs(first.y - second.y), std::fabs(first.z - second.z)});
+  }
+
+  Vec3 RandomAxis(std::mt19937& rng)
+  {
+    std::uniform_real_distribution<float> distribution(-1, 1);
+    Vec3 axis(distribution(rng), distribution(rng), distribution(rng));
+    axis.Normalize();
+    return axis;
+  }
+}
+
+TEST(QuaternionMatchesRotationMatrix)
+{
+  std::mt19937 rng(1);
+  std::uniform_real_distribution<float> distribution(-1, 1);
+  float matrixError = 0, mat3Error = 0, rotateError = 0;
+  for(int i = 0; i < 100000; i++)
+  {
+    Vec3 axis = RandomAxis(rng);
+    float angle = distribution(rng) * 2 * M_PI;
+    Mat4 matrix = Mat4::RotateR(angle, axis);
+    Quaternion rotation = Quaternion::RotationR(angle, axis);
+
+    Mat4 rotationMatrix = rotation.ToMat4();
+    for(int k = 0; k < 16; k++)
+      matrixError = std::max(matrixError, std::fabs(matrix.elements[k] - rotationMatrix.elements[k]));
+    Mat3 rotationMat3 = rotation.ToMat3();
+    for(int column = 0; column < 3; column++)
+    {
+      for(int row = 0; row < 3; row++)
+        mat3Error = std::max(mat3Error, std::fabs(rotationMat3.elements[column * 3 + row] - matrix.elements[column * 4 + row]));
+    }
+
+    Vec3 vector(distribution(rng), distribution(rng), distribution(rng));
+    Vec4 transformed = matrix * Vec4(vector.x, vector.y, vector.z, 1);
+    rotateError = std::max(rotateError, MaxDifference(rotation.Rotate(vector), Vec3(transformed.x, transformed.y, transformed.z)));
+  }
+  CHECK_LE(matrixError, MATRIX_TOLERANCE);
+  CHECK_LE(mat3Error, MATRIX_TOLERANCE);
+  CHECK_LE(rotateError, MATRIX_TOLERANCE);
+}
+
+TEST(SlerpFollowsExactAngle)
+{
+  std::mt19937 rng(2);
+  std::uniform_real_distribution<float> distribution(0, 1);
+  Quaternion from = Quaternion::RotationR(0.3f, Vec3(0, 1, 0));
+  float error = 0, flippedError = 0;
+  for(int i = 0; i < 10000; i++)
+  {
+    Vec3 axis = RandomAxis(rng);
+    float angle = distribution(rng) * 3.1f;
+    float t = distribution(rng);
+    Quaternion to = from * Quaternion::RotationR(angle, axis);
+
+    // The rotation t of the way from one to the other
+    Quaternion exact = from * Quaternion::RotationR(angle * t, axis);
+    Quaternion result = Quaternion::Slerp(from, to, t);
+    error = std::max(error, std::fabs(std::fabs(result.Dot(exact)) - 1));
+
+    // The negated quaternion is the same rotation, Slerp has to take the short way either way
+    Quaternion negated(-to.x, -to.y, -to.z, -to.w);
+    flippedError = std::max(flippedError, std::fabs(Quaternion::Slerp(from, negated, t).Dot(result) - 1));
+  }
+  CHECK_LE(error, SLERP_TOLERANCE);
+  CHECK_LE(flippedError, SLERP_TOLERANCE);
+}
+
+TEST(BatchQuaternionMatchesScalar)
+{
+  // Not a multiple of the SIMD width, so that the scalar tail is covered too
+  const size_t count = 4096 + 3;
+  std::mt19937 rng(3);
+  std::uniform_real_distribution<float> distribution(-1, 1);
+  std::vector<Quaternion> from(count), to(count), out(count);
+  std::vector<float> t(count);
+  std::vector<Vec3> vectors(count), rotated(count);
+  std::vector<Mat4> matrices(count);
+  for(size_t i = 0; i < count; i++)
+  {
+    from[i] = Quaternion::RotationR(distribution(rng) * 6, RandomAxis(rng));
+    to[i] = Quaternion::RotationR(distribution(rng) * 6, RandomAxis(rng));
+    t[i] = (distribution(rng) + 1) / 2;
+    vectors[i] = Vec3(distribution(rng), distribution(rng), distribution(rng));
+  }
+
+  ThreadPool pool;
+  for(ThreadPool* threads : {(ThreadPool*)nullptr, &pool})
+  {
+    float nlerpError = 0, slerpError = 0, rotateError = 0, matrixError = 0;
+    BatchQuaternion::Nlerp(from.data(), to.data(), t.data(), out.data(), count, threads);
+    for(size_t i = 0; i < count; i++)
+      nlerpError = std::max(nlerpError, std::fabs(Quaternion::Nlerp(from[i], to[i], t[i]).Dot(out[i]) - 1));
+    BatchQuaternion::Slerp(from.data(), to.data(), t.data(), out.data(), count, threads);
+    for(size_t i = 0; i < count; i++)
+      slerpError = std::max(slerpError, std::fabs(std::fabs(Quaternion::Slerp(from[i], to[i], t[i]).Dot(out[i])) - 1));
+    BatchQuaternion::Rotate(from.data(), vectors.data(), rotated.data(), count, threads);
+    for(size_t i = 0; i < count; i++)
+      rotateError = std::max(rotateError, MaxDifference(from[i].Rotate(vectors[i]), rotated[i]));
+    BatchQuaternion::ToMat4(from.data(), matrices.data(), count, threads);
+    for(size_t i = 0; i < count; i++)
+    {
+      Mat4 matrix = from[i].ToMat4();
+      for(int k = 0; k < 16; k++)
+        matrixError = std::max(matrixError, std::fabs(matrix.elements[k] - matrices[i].elements[k]));
+    }
+    CHECK_LE(nlerpError, MATRIX_TOLERANCE);
+    CHECK_LE(slerpError, SLERP_TOLERANCE);
+    CHECK_LE(rotateError, MATRIX_TOLERANCE);
+    CHECK_LE(matrixError, MATRIX_TOLERANCE);
+  }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Minimal test registry, every TEST(name) in the linked files is run by tests/main.cpp. A
+// failing CHECK reports itself and lets the test continue, REQUIRE stops the test.
+namespace Test
+{
+  struct TestCase
+  {
+    const char* name;
+    void (*function)();
+  };
+
+  struct Abort {};
+
+  inline std::vector<TestCase>& GetTests()
+  {
+    static std::vector<TestCase> tests;
+    return tests;
+  }
+
+  inline int& GetFailures()
+  {
+    static int failures = 0;
+    return failures;
+  }
+
+  struct Register
+  {
+    Register(const char* name, void (*function)())
+    {
+      GetTests().push_back({name, function});
+    }
+  };
+
+  inline void Fail(const char* file, int line, const std::string& message)
+  {
+    std::cerr << "ERROR: " << file << ":" << line << ": " << message << std::endl;
+    GetFailures()++;
+  }
+
+  template <typename A, typename B>
+  std::string Describe(const char* expression, const A& a, const B& b)
+  {
+    std::stringstream ss;
+    ss << expression << " (" << a << " vs " << b << ")";
+    return ss.str();
+  }
+}
+
+#define TEST(name) \
+  static void name(); \
+  static Test::Register name##Register{#name, name}; \
+  static void name()
+
+#define CHECK(condition) \
+  do { if(!(condition)) Test::Fail(__FILE__, __LINE__, #condition); } while(false)
+
+#define CHECK_EQ(a, b) \
+  do { if(!((a) == (b))) Test::Fail(__FILE__, __LINE__, Test::Describe(#a " == " #b, a, b)); } while(false)
+
+#define CHECK_LE(a, b) \
+  do { if(!((a) <= (b))) Test::Fail(__FILE__, __LINE__, Test::Describe(#a " <= " #b, a, b)); } while(false)
+
+#define CHECK_THROWS(expression) \
+  do { bool thrown = false; try { expression; } catch(...) { thrown = true; } \
+    if(!thrown) Test::Fail(__FILE__, __LINE__, #expression " didn't throw"); } while(false)
+
+#define REQUIRE(condition) \
+  do { if(!(condition)) { Test::Fail(__FILE__, __LINE__, #condition); throw Test::Abort{}; } } while(false)
@@ -0,0 +1,37 @@
+#include "Test.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+  // Optional arguments select the tests whose name contains one of them
+  int run = 0;
+  for(auto&& test : Test::GetTests())
+  {
+    bool selected = argc == 1;
+    for(int i = 1; i < argc; i++)
+      selected |= std::strstr(test.name, argv[i]) != nullptr;
+    if(!selected)
+      continue;
+
+    int failures = Test::GetFailures();
+    try
+    {
+      test.function();
+    }
+    catch(const Test::Abort&)
+    {}
+    catch(const std::exception& e)
+    {
+      Test::Fail(test.name, 0, std::string("unexpected exception: ") + e.what());
+    }
+    std::cout << (Test::GetFailures() == failures ? "INFO: passed " : "ERROR: failed ") << test.name << std::endl;
+    run++;
+  }
+
+  std::cout << "INFO: " << run << " tests, " << Test::GetFailures() << " failed checks" << std::endl;
+  return Test::GetFailures() == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}